@@ -31,10 +31,12 @@ int addition(Dlist **head1, Dlist **tail1, Dlist **head2, Dlist **tail2, Dlist *
 	// Check if either of the input lists is empty
 	if(*head1 == NULL || *head2 == NULL)
 	{
-		printf("ERROR : One or Both input Lists are Empty! \n");
+		apc_printf("ERROR : One or Both input Lists are Empty! \n");
 		return FAILURE;
 	}
 
+	PROFILE_KERNEL("add", "basecase", find_length(*head1));
+
 	// Start traversal from the last nodes (least significant digits)
 	Dlist *temp1 = *tail1;
 	Dlist *temp2 = *tail2;
@@ -59,7 +61,8 @@ int addition(Dlist **head1, Dlist **tail1, Dlist **head2, Dlist **tail2, Dlist *
 		// Insert result digit at beginning (MSD towards head)
 		if(insert_at_begin(headR, &tailR, sum) == FAILURE)
 		{
-			printf("ERROR : Failed to insert the node in the result list. \n");
+			apc_printf("ERROR : Failed to insert the node in the result list. \n");
+			delete_list(headR, &tailR);
 			return FAILURE;
 		}
 
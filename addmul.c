@@ -0,0 +1,182 @@
+/*******************************************************************************************************************************************************************
+ * Function: ADDMUL / SUBMUL
+ * ------------------------
+ *  Fused multiply-accumulate kernels on numbers represented as doubly linked lists.
+ *
+ *     addmul : R = R + (A × B)
+ *     submul : R = R - (A × B)
+ *
+ *  Instead of building every partial product as its own list and adding it into a
+ *  fresh result (one full addition per digit of B), the column sums of A × B are
+ *  accumulated in a plain array and then folded into the existing destination list
+ *  R in a single carry (or borrow) pass, extending R at the head when needed.
+ *  The digits of A and B are copied into arrays first, and the column sums come from
+ *  the blocked schoolbook rows of karatsuba.c (poly_addmul_basecase).
+ *
+ *  Example:
+ *     R: 1 <-> 0 <-> 0   (represents 100)
+ *     A: 1 <-> 2         (represents 12)
+ *     B: 3 <-> 4         (represents 34)
+ *     addmul → R: 5 <-> 0 <-> 8   (100 + 408 = 508)
+ *     submul → R: 3 <-> 0 <-> 8   (|100 - 408| = 308, borrow = 1)
+ *
+ *  Parameters:
+ *     headR, tailR → destination list (updated in place, an empty list is treated as 0)
+ *     head1, tail1 → first factor
+ *     head2, tail2 → second factor
+ *     borrow       → (submul only) set to 1 when A × B > R; R then holds A × B - R
+ *
+ *  Returns:
+ *     SUCCESS (0) if the accumulation succeeds
+ *     FAILURE (-1) if an input list is empty or memory allocation fails
+ *
+*******************************************************************************************************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "apc.h"
+
+/* Column sums of A × B (len1 + len2 columns), least significant column first. Returns NULL on failure. */
+static long long *product_columns(Dlist *tail1, int len1, Dlist *tail2, int len2)
+{
+	// columns, then the digits of A and B as coefficients
+	long long *columns = apc_calloc(2 * (len1 + len2), sizeof(long long));
+	if(columns == NULL)
+	{
+		return NULL;
+	}
+	PROFILE_ALLOC(2 * (len1 + len2) * sizeof(long long));
+
+	long long *a = columns + len1 + len2, *b = a + len1;
+	for(int i = 0; tail1 != NULL; tail1 = tail1->prev, i++)
+	{
+		a[i] = tail1->data;
+	}
+	for(int j = 0; tail2 != NULL; tail2 = tail2->prev, j++)
+	{
+		b[j] = tail2->data;
+	}
+	poly_addmul_basecase(a, len1, b, len2, columns);
+	return columns;
+}
+
+int addmul(Dlist **headR, Dlist **tailR, Dlist **head1, Dlist **tail1, Dlist **head2, Dlist **tail2)
+{
+	// Validate the factor lists (destination may be empty → treated as zero)
+	if(*head1 == NULL || *head2 == NULL)
+	{
+		apc_printf("ERROR : One or Both input Lists are Empty! \n");
+		return FAILURE;
+	}
+
+	int len1 = find_length(*head1), len2 = find_length(*head2);
+	int length = len1 + len2;
+	PROFILE_KERNEL("addmul", "columns", length);
+	long long *columns = product_columns(*tail1, len1, *tail2, len2);
+	if(columns == NULL)
+	{
+		apc_printf("ERROR : Failed to allocate the product columns. \n");
+		return FAILURE;
+	}
+
+	// Single carry pass: fold every column into R from the least significant digit
+	Dlist *r = *tailR;
+	long long carry = 0;
+
+	for(int k = 0; k < length || carry != 0; k++)
+	{
+		if(r == NULL)
+		{
+			// Destination is shorter than the product → grow it at the head
+			if(insert_at_begin(headR, tailR, 0) == FAILURE)
+			{
+				apc_printf("ERROR : Failed to insert the node in the result list. \n");
+				apc_free(columns);
+				return FAILURE;
+			}
+			r = *headR;
+		}
+
+		long long sum = r->data + carry + ((k < length) ? columns[k] : 0);
+		r->data = sum % 10;
+		carry = sum / 10;
+
+		r = r->prev;
+	}
+
+	apc_free(columns);
+	return SUCCESS;
+}
+
+int submul(Dlist **headR, Dlist **tailR, Dlist **head1, Dlist **tail1, Dlist **head2, Dlist **tail2, int *borrow)
+{
+	if(*head1 == NULL || *head2 == NULL)
+	{
+		apc_printf("ERROR : One or Both input Lists are Empty! \n");
+		return FAILURE;
+	}
+
+	int len1 = find_length(*head1), len2 = find_length(*head2);
+	int length = len1 + len2;
+	PROFILE_KERNEL("submul", "columns", length);
+	long long *columns = product_columns(*tail1, len1, *tail2, len2);
+	if(columns == NULL)
+	{
+		apc_printf("ERROR : Failed to allocate the product columns. \n");
+		return FAILURE;
+	}
+
+	// Single borrow pass over every column and every remaining digit of R
+	Dlist *r = *tailR;
+	long long pending = 0;
+
+	for(int k = 0; k < length || r != NULL; k++)
+	{
+		if(r == NULL)
+		{
+			if(insert_at_begin(headR, tailR, 0) == FAILURE)
+			{
+				apc_printf("ERROR : Failed to insert the node in the result list. \n");
+				apc_free(columns);
+				return FAILURE;
+			}
+			r = *headR;
+		}
+
+		long long diff = r->data - pending - ((k < length) ? columns[k] : 0);
+		pending = 0;
+		if(diff < 0)
+		{
+			pending = (-diff + 9) / 10;     // smallest borrow that makes the digit non-negative
+			diff += pending * 10;
+		}
+		r->data = diff;
+
+		r = r->prev;
+	}
+	apc_free(columns);
+
+	/*
+	 * R was at least as long as the product, so a leftover borrow can only be 1 and
+	 * means R now holds 10^L + R - A×B. Negate it in place to obtain A×B - R.
+	 */
+	*borrow = (pending != 0);
+	if(*borrow)
+	{
+		int carry = 0;
+		for(r = *tailR; r != NULL; r = r->prev)
+		{
+			int digit = -r->data - carry;
+			carry = 0;
+			if(digit < 0)
+			{
+				digit += 10;
+				carry = 1;
+			}
+			r->data = digit;
+		}
+	}
+
+	remove_leading_zeros(headR);
+	return SUCCESS;
+}
@@ -0,0 +1,412 @@
+/*******************************************************************************************************************************************************************
+ * Aggregates over a stream of numbers
+ * -----------------------------------
+ *  ./a.out --aggregate <sum|product|min|max|sort> [file] reads signed integers separated by whitespace or commas
+ *  (from stdin without a file), parses each once into limbs and prints one aggregate, instead of one
+ *  ./a.out a + b per value re-parsing and re-printing a growing total:
+ *
+ *     sum      : each thread adds its share of the values into a positive and a negative accumulator in place,
+ *                the partial sums are then combined pairwise (tree reduction) and the result is P - N
+ *     product  : each thread runs the balanced product tree (limbs_product) over its share, and the partial
+ *                products go through the product tree once more; the sign is the parity of the negatives
+ *     min, max : one scan with compare_values
+ *     sort     : ascending, one Result line per value
+ *
+ *  compare_values orders the way compare_numbers() does for digit lists: sign first, then the length of the
+ *  magnitude (its limb count, which is the digit count up to LIMB_DIGITS), then the leading limbs from the top,
+ *  so two values of different lengths are ordered without reading a single digit.
+ *
+ *  The shares of sum and product run on the chunk runner of the decimal conversions (convert_run), so the limbs
+ *  allocated by helper threads count against the operation's memory cap and, under --profile, in its allocation
+ *  counters.
+ *
+ *  Returns:
+ *     SUCCESS (0) on success, FAILURE (-1) on an invalid number, an empty stream or a memory allocation failure
+*******************************************************************************************************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "apc.h"
+
+/* Fewest values handed to one thread of sum / product */
+#ifndef AGGREGATE_GRAIN
+#define AGGREGATE_GRAIN 4096
+#endif
+
+/* The parsed stream: magnitudes and signs side by side, so product can pass `mag` to limbs_product */
+typedef struct
+{
+	Limbs *mag;
+	char *sign;         // '+' or '-'; zero is always '+'
+	int count;
+}Values;
+
+/* Partial results of one thread's share of the values */
+typedef struct
+{
+	Limbs positive, negative;   // sum: partial sums of the positive and negative magnitudes
+	Limbs product;              // product: partial product of the magnitudes
+	int status;
+}Share;
+
+/* The values and one Share per chunk of convert_run */
+typedef struct
+{
+	const Values *values;
+	Share share[CONVERT_MAX_THREADS];
+}Shares;
+
+static void values_free(Values *v)
+{
+	for(int i = 0; i < v->count; i++)
+	{
+		limbs_free(&v->mag[i]);
+	}
+	apc_free(v->mag);
+	apc_free(v->sign);
+}
+
+/* Append one token; FAILURE with a message if it is not a signed integer */
+static int values_push(Values *v, int *capacity, const char *token)
+{
+	const char *digits;
+	char sign = remove_sign(token, &digits);
+	if(check_sign(token) == FAILURE || strpbrk(digits, "./") != NULL)
+	{
+		apc_printf("ERROR : %s is not an integer\n", token);
+		return FAILURE;
+	}
+	if(v->count == *capacity)
+	{
+		int size = *capacity ? 2 * *capacity : 1024;
+		Limbs *mag = apc_realloc(v->mag, size * sizeof(Limbs));
+		if(mag == NULL)
+		{
+			return FAILURE;
+		}
+		v->mag = mag;
+		char *signs = apc_realloc(v->sign, size);
+		if(signs == NULL)
+		{
+			return FAILURE;
+		}
+		v->sign = signs;
+		*capacity = size;
+	}
+
+	Limbs *x = &v->mag[v->count];
+	x->d = NULL;
+	x->n = 0;
+	if(limbs_from_string(digits, x) == FAILURE)
+	{
+		return FAILURE;
+	}
+	v->sign[v->count++] = (x->n == 0) ? '+' : sign;
+	return SUCCESS;
+}
+
+/* Read and parse the whole stream */
+static int values_read(FILE *in, Values *v)
+{
+	char *line = NULL;
+	size_t size = 0;
+	int capacity = 0, status = SUCCESS;
+	while(status == SUCCESS && getline(&line, &size, in) != -1)
+	{
+		char *save = NULL;
+		for(char *token = strtok_r(line, " \t\r\n,", &save); token != NULL && status == SUCCESS; token = strtok_r(NULL, " \t\r\n,", &save))
+		{
+			status = values_push(v, &capacity, token);
+		}
+	}
+	free(line);
+	return status;
+}
+
+/* Signed order: sign, then magnitude length, then leading limbs (limbs_cmp on trimmed limbs) */
+static int compare_values(char s1, const Limbs *a, char s2, const Limbs *b)
+{
+	if(s1 != s2)
+	{
+		return (s1 == '+') ? GREATER : LESS;
+	}
+	int order = limbs_cmp(a, b);
+	return (s1 == '+') ? order : -order;
+}
+
+/* acc += x in place; acc keeps room for one more limb than it uses, so the carry always lands */
+static int accumulate(Limbs *acc, int *capacity, const Limbs *x)
+{
+	int n = (acc->n > x->n) ? acc->n : x->n;
+	if(n + 1 > *capacity)
+	{
+		int size = 2 * (n + 1);
+		uint32_t *d = apc_realloc(acc->d, size * sizeof(uint32_t));
+		if(d == NULL)
+		{
+			return FAILURE;
+		}
+		memset(d + *capacity, 0, (size - *capacity) * sizeof(uint32_t));
+		acc->d = d;
+		*capacity = size;
+	}
+
+	uint32_t carry = 0;
+	int i = 0;
+	for(; i < x->n; i++)
+	{
+		uint32_t sum = acc->d[i] + x->d[i] + carry;
+		carry = (sum >= LIMB_BASE);
+		acc->d[i] = carry ? sum - LIMB_BASE : sum;
+	}
+	for(; carry; i++)
+	{
+		uint32_t sum = acc->d[i] + 1;
+		carry = (sum == LIMB_BASE);
+		acc->d[i] = carry ? 0 : sum;
+	}
+	if(i > acc->n)
+	{
+		acc->n = i;
+	}
+	return SUCCESS;
+}
+
+static void sum_share(void *arg, int chunk, long begin, long end)
+{
+	Shares *job = arg;
+	Share *s = &job->share[chunk];
+	int positive_capacity = 0, negative_capacity = 0;
+	s->status = SUCCESS;
+	for(long i = begin; i < end && s->status == SUCCESS; i++)
+	{
+		if(job->values->sign[i] == '+')
+			s->status = accumulate(&s->positive, &positive_capacity, &job->values->mag[i]);
+		else
+			s->status = accumulate(&s->negative, &negative_capacity, &job->values->mag[i]);
+	}
+}
+
+static void product_share(void *arg, int chunk, long begin, long end)
+{
+	Shares *job = arg;
+	job->share[chunk].status = limbs_product(job->values->mag + begin, (int)(end - begin), &job->share[chunk].product);
+}
+
+/* Split the values into shares of at least AGGREGATE_GRAIN and run `work` on each, one thread per share */
+static Shares *run_shares(const Values *v, convert_work work, int *count)
+{
+	Shares *job = apc_calloc(1, sizeof(Shares));
+	if(job == NULL)
+	{
+		return NULL;
+	}
+	job->values = v;
+	*count = convert_threads(v->count, AGGREGATE_GRAIN, 1);
+	convert_run(v->count, AGGREGATE_GRAIN, *count, work, job);
+	return job;
+}
+
+static void free_shares(Shares *shares, int count)
+{
+	for(int t = 0; t < count; t++)
+	{
+		limbs_free(&shares->share[t].positive);
+		limbs_free(&shares->share[t].negative);
+		limbs_free(&shares->share[t].product);
+	}
+	apc_free(shares);
+}
+
+static int aggregate_sum(const Values *v)
+{
+	int count, status = SUCCESS;
+	Shares *shares = run_shares(v, sum_share, &count);
+	if(shares == NULL)
+	{
+		return FAILURE;
+	}
+	for(int t = 0; t < count; t++)
+	{
+		status = (shares->share[t].status == SUCCESS) ? status : FAILURE;
+	}
+
+	// Tree reduction of the partial sums: share t absorbs share t + step
+	for(int step = 1; step < count && status == SUCCESS; step *= 2)
+	{
+		for(int t = 0; t + step < count && status == SUCCESS; t += 2 * step)
+		{
+			if(limbs_add(&shares->share[t].positive, &shares->share[t + step].positive, &shares->share[t].positive) == FAILURE ||
+			   limbs_add(&shares->share[t].negative, &shares->share[t + step].negative, &shares->share[t].negative) == FAILURE)
+			{
+				status = FAILURE;
+			}
+		}
+	}
+
+	if(status == SUCCESS)
+	{
+		Limbs *p = &shares->share[0].positive, *n = &shares->share[0].negative;
+		limbs_trim(p);
+		limbs_trim(n);
+		char sign = (limbs_cmp(p, n) == LESS) ? '-' : '+';
+		status = (sign == '+') ? limbs_sub(p, n, p) : limbs_sub(n, p, p);
+		if(status == SUCCESS)
+			limbs_print_result(sign, p);
+	}
+	free_shares(shares, count);
+	return status;
+}
+
+static int aggregate_product(const Values *v)
+{
+	int negatives = 0;
+	for(int i = 0; i < v->count; i++)
+	{
+		if(v->mag[i].n == 0)
+		{
+			apc_printf("Result          : 0\n");
+			PROFILE_RESULT_DIGITS(1);
+			return SUCCESS;
+		}
+		negatives += (v->sign[i] == '-');
+	}
+
+	int count, status = SUCCESS;
+	Shares *shares = run_shares(v, product_share, &count);
+	if(shares == NULL)
+	{
+		return FAILURE;
+	}
+	Limbs *partials = apc_calloc(count, sizeof(Limbs));
+	Limbs r = { NULL, 0 };
+	for(int t = 0; t < count; t++)
+	{
+		status = (shares->share[t].status == SUCCESS) ? status : FAILURE;
+	}
+	if(partials == NULL || status == FAILURE)
+	{
+		status = FAILURE;
+	}
+	else
+	{
+		for(int t = 0; t < count; t++)
+		{
+			partials[t] = shares->share[t].product;
+		}
+		status = limbs_product(partials, count, &r);
+	}
+	if(status == SUCCESS)
+	{
+		limbs_print_result((negatives % 2) ? '-' : '+', &r);
+	}
+	limbs_free(&r);
+	apc_free(partials);
+	free_shares(shares, count);
+	return status;
+}
+
+/* qsort over indexes into the values being sorted */
+static const Values *sort_values;
+
+static int compare_indexes(const void *x, const void *y)
+{
+	int i = *(const int *)x, j = *(const int *)y;
+	return compare_values(sort_values->sign[i], &sort_values->mag[i], sort_values->sign[j], &sort_values->mag[j]);
+}
+
+static int aggregate_sort(const Values *v)
+{
+	int *order = apc_malloc(v->count * sizeof(int));
+	if(order == NULL)
+	{
+		return FAILURE;
+	}
+	for(int i = 0; i < v->count; i++)
+	{
+		order[i] = i;
+	}
+	sort_values = v;
+	qsort(order, v->count, sizeof(int), compare_indexes);
+	for(int i = 0; i < v->count; i++)
+	{
+		limbs_print_result(v->sign[order[i]], &v->mag[order[i]]);
+	}
+	apc_free(order);
+	return SUCCESS;
+}
+
+/* GREATER for the maximum, LESS for the minimum */
+static int aggregate_extreme(const Values *v, int wanted)
+{
+	int best = 0;
+	for(int i = 1; i < v->count; i++)
+	{
+		if(compare_values(v->sign[i], &v->mag[i], v->sign[best], &v->mag[best]) == wanted)
+		{
+			best = i;
+		}
+	}
+	limbs_print_result(v->sign[best], &v->mag[best]);
+	return SUCCESS;
+}
+
+/*****************************************************************************************
+ * Function: aggregate_run
+ * -----------------------
+ * ./a.out --aggregate <sum|product|min|max|sort> [file]; stdin without a file.
+ *****************************************************************************************/
+
+int aggregate_run(const char *op, const char *path)
+{
+	if(strcmp(op, "sum") != 0 && strcmp(op, "product") != 0 && strcmp(op, "min") != 0 &&
+	   strcmp(op, "max") != 0 && strcmp(op, "sort") != 0)
+	{
+		printf("ERROR : --aggregate supports sum product min max sort only\n");
+		return FAILURE;
+	}
+	FILE *in = path ? fopen(path, "r") : stdin;
+	if(in == NULL)
+	{
+		printf("ERROR : Cannot open %s\n", path);
+		return FAILURE;
+	}
+
+	Values v = { NULL, NULL, 0 };
+	int status = values_read(in, &v);
+	if(path)
+		fclose(in);
+	if(status == SUCCESS && v.count == 0)
+	{
+		// The empty sum and product are still defined; an empty minimum or ordering is not
+		if(strcmp(op, "sum") == 0)
+		{
+			apc_printf("Result          : 0\n");
+			PROFILE_RESULT_DIGITS(1);
+		}
+		else if(strcmp(op, "product") == 0)
+		{
+			apc_printf("Result          : +1\n");
+			PROFILE_RESULT_DIGITS(1);
+		}
+		else
+		{
+			apc_printf("ERROR : No numbers to %s\n", op);
+			status = FAILURE;
+		}
+	}
+	else if(status == SUCCESS)
+	{
+		if(strcmp(op, "sum") == 0)
+			status = aggregate_sum(&v);
+		else if(strcmp(op, "product") == 0)
+			status = aggregate_product(&v);
+		else if(strcmp(op, "sort") == 0)
+			status = aggregate_sort(&v);
+		else
+			status = aggregate_extreme(&v, (strcmp(op, "max") == 0) ? GREATER : LESS);
+	}
+	values_free(&v);
+	return status;
+}
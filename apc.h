@@ -1,6 +1,10 @@
 #ifndef APC_H
 #define APC_H
 
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+
 /* Return codes */
 #define SUCCESS 0
 #define FAILURE -1
@@ -11,8 +15,41 @@
 #define EQUAL     0
 #define LESS     -1
 
+/* Operator arity of list operators (prod): every operand after the operator */
+#define ARITY_LIST 0
+
+/* Default working-set budget of out-of-core multiplication, in MB (--memory) */
+#define OOC_MEMORY_DEFAULT 512
+
+/* Largest n accepted by factorial and binomial */
+#define FACTORIAL_MAX 100000000
+
 typedef int data_t;
 
+/* Profiling phases (see profile.c) */
+enum
+{
+	PHASE_PARSE,
+	PHASE_CONVERT,
+	PHASE_COMPUTE,
+	PHASE_NORMALIZE,
+	PHASE_PRINT,
+	PHASE_COUNT
+};
+
+/* Profiling hooks: a single flag test when profiling is off */
+extern int apc_profile_enabled;
+
+/* Extra Miller-Rabin rounds of isprime (--rounds N) */
+extern int apc_prime_rounds;
+#define PROFILE_BEGIN(phase)              do { if(apc_profile_enabled) profile_begin(phase); } while(0)
+#define PROFILE_END(phase)                do { if(apc_profile_enabled) profile_end(phase); } while(0)
+#define PROFILE_ALLOC(bytes)              do { if(apc_profile_enabled) profile_alloc(bytes); } while(0)
+#define PROFILE_FREE(count)               do { if(apc_profile_enabled) profile_free(count); } while(0)
+#define PROFILE_KERNEL(family, name, size) do { if(apc_profile_enabled) profile_kernel(family, name, size); } while(0)
+#define PROFILE_RESULT_DIGITS(digits)     do { if(apc_profile_enabled) profile_result_digits(digits); } while(0)
+#define PROFILE_THREADS(threads)          do { if(apc_profile_enabled) profile_threads(threads); } while(0)
+
 /* Doubly linked list node: `prev` and `next` pointers and a single digit `data`. */
 typedef struct node
 {
@@ -21,16 +58,99 @@ typedef struct node
 	struct node *next;
 }Dlist;
 
+/* Arena for the list nodes of one --serve connection (see memory.c) */
+typedef struct node_arena NodeArena;
+
+/* Decimal (fixed-point) number: value = sign × coefficient × 10^-scale (see decimal.c) */
+typedef struct
+{
+	char sign;              // '+' or '-'
+	Dlist *head;            // coefficient digits
+	Dlist *tail;
+	int scale;              // number of fractional digits
+}Decimal;
+
+/* Rational number: value = sign × num / den, den > 0 (see rational.c) */
+typedef struct
+{
+	char sign;              // '+' or '-'
+	Dlist *num, *num_tail;  // numerator digits
+	Dlist *den, *den_tail;  // denominator digits
+	int pending;            // operations since the last gcd reduction
+}Rational;
+
+/* Fractional digits of a decimal quotient when --precision is not given */
+#define DECIMAL_DEFAULT_PRECISION 30
+
+/* Rounding modes for decimal results (names: half-even, half-up, ... as in decimal.c) */
+enum
+{
+	ROUND_HALF_EVEN,
+	ROUND_HALF_UP,
+	ROUND_HALF_DOWN,
+	ROUND_DOWN,
+	ROUND_UP,
+	ROUND_CEILING,
+	ROUND_FLOOR
+};
+
+/* Limb number for the number-theoretic kernels: little-endian base-10^9 limbs, n == 0 is zero (see limbs.c) */
+#define LIMB_BASE   1000000000u
+#define LIMB_DIGITS 9
+typedef struct
+{
+	uint32_t *d;
+	int n;
+}Limbs;
+
+/* Batch of `count` numbers in structure-of-arrays lanes: limb k (base 10^4) of number i at d[k * count + i] (see batch.c) */
+typedef struct
+{
+	uint32_t *d;
+	char *sign;
+	int count;
+	int limbs;
+}Batch;
+
+/* Divisor prepared for repeated division: m, its Barrett reciprocal mu = floor(B^(2k) / m), k = limbs of m (see modctx.c) */
+typedef struct
+{
+	Limbs m;
+	Limbs mu;
+	int k;
+}ModContext;
+
+/* Kernel registry entry: one algorithm for an operation, used from `threshold` digits upwards.
+   Binary kernels fill `binary`, unary ones (square) fill `unary`. */
+typedef struct
+{
+	const char *name;
+	int (*binary)(Dlist **head1, Dlist **tail1, Dlist **head2, Dlist **tail2, Dlist **headR);
+	int (*unary)(Dlist **head1, Dlist **tail1, Dlist **headR);
+	int threshold;
+}kernel_t;
+
+/* Kernel family: all kernels of one operation ("mul", "sqr", "div", "mod") ordered by threshold. */
+typedef struct
+{
+	const char *name;
+	kernel_t *kernels;
+	int count;
+}kernel_family;
+
 
 
 // ------------------> Helper functions <-------------------
 
 // Check and return sign of string: + / - or default.
-static int check_sign(const char *s);
+int check_sign(const char *s);
 
 // Validate Command Line arguments (argc, argv) for your program;
 int validate_arguments(int argc , char* argv[]);
 
+// Return the number of operands an operator takes (1, 2, 3 or ARITY_LIST), or FAILURE if the operator is unknown.
+int operator_arity(const char *op);
+
 // Convert numeric string to doubly linked list (one digit per node).
 int string_to_list(Dlist **head, Dlist **tail, char *str);
 
@@ -46,15 +166,38 @@ int find_length(Dlist *head);
 // Compare two numbers represented by lists: return GREATER, EQUAL or LESS.
 int compare_numbers(Dlist *h1, Dlist *h2);
 
+// First significant node of a number (leading zeros are skipped, not freed).
+Dlist *skip_leading_zeros(Dlist *head);
+
+// printf to the calculator output: stdout, or the response buffer of the calling --serve worker (apc_output).
+extern __thread FILE *apc_output;
+int apc_printf(const char *format, ...) __attribute__((format(printf, 1, 2)));
+
 // Print the number stored in the list.
 void print_list(Dlist *head);
 
 // Remove sign char from input string and also set digits pointer.
 char remove_sign(const char *s, const char **digits);
 
+// Fast path for operands of up to 38 digits in native 128-bit arithmetic (small.c): prints the result
+// (with the operand echo if `echo`) and returns SUCCESS, or FAILURE without output when the lists are needed
+// or the path is off (apc_small_enabled: --no-small, APC_NO_SMALL=1).
+extern int apc_small_enabled;
+void small_init(void);
+int small_operation(const char *op, char sign1, const char *digits1, char sign2, const char *digits2, int echo);
+
 // Operation handler - Performs the requested operation and prints results as needed.
 int perform_operation(const char *op, char sign1, char sign2, Dlist **head1, Dlist **tail1, Dlist **head2, Dlist **tail2, Dlist **headR, Dlist **tailR, const char *digits1, const char *digits2);
 
+// Unary operation handler (isqrt, isprime, nextprime, factor, !) - Performs the operation and prints the result.
+int perform_unary_operation(const char *op, char sign1, Dlist **head1, Dlist **tail1, Dlist **headR, Dlist **tailR);
+
+// List operation handler (prod) - Combines all operands and prints the result.
+int perform_list_operation(const char *op, int count, const char *signs, Dlist **heads, Dlist **headR);
+
+// Fused operation handler - Performs R = R ± (A × B) (addmul / submul) with signs and prints the result.
+int perform_fused_operation(const char *op, char signR, char sign1, char sign2, Dlist **headR, Dlist **tailR, Dlist **head1, Dlist **tail1, Dlist **head2, Dlist **tail2);
+
 // Remove Leading Zero's
 void remove_leading_zeros(Dlist **head);
 
@@ -64,6 +207,350 @@ int result_is_zero(Dlist *head);
 // delete_list: frees all nodes in the list and resets head/tail to NULL
 int delete_list(Dlist **head, Dlist **tail);
 
+// Release `count` lists given by their heads (see list_release) and reset the heads to NULL.
+void free_lists(Dlist **heads, int count);
+
+// Copy list digits into a new array, least significant digit first (caller frees).
+int list_to_array(Dlist *head, data_t **digits, int *length);
+
+// Build a list from a digit array stored least significant digit first (leading zeros dropped).
+int array_to_list(const data_t *digits, int length, Dlist **head, Dlist **tail);
+
+// Resolve column sums (least significant first) into a normalized digit list with one carry pass.
+int columns_to_list(const long long *columns, int length, Dlist **head, Dlist **tail);
+
+// Convert a non-negative machine integer to a list, and back (FAILURE if over 18 digits).
+int long_to_list(long long value, Dlist **head, Dlist **tail);
+int list_to_long(Dlist *head, long long *value);
+
+// Divide a list in place by a small positive integer; returns the remainder.
+long long divide_by_small(Dlist **head, long long divisor);
+
+// Last node of a list.
+Dlist *list_tail(Dlist *head);
+
+// Append a copy of a list to headR/tailR.
+int copy_list(Dlist *head, Dlist **headR, Dlist **tailR);
+
+
+// ------------------> Shared lists <-------------------
+
+// Another reference to a read-only list (NULL if the table is full) / is it shared / drop a reference (the last deletes).
+Dlist *list_share(Dlist *head);
+int list_shared(Dlist *head);
+void list_release(Dlist **head, Dlist **tail);
+
+// Copy-on-write: replace a shared list by a private copy before it is updated in place.
+int list_writable(Dlist **head, Dlist **tail);
+
+// heads[i] from digits[i] (leading zeros removed), sharing an earlier operand with the same digits.
+int operand_list(Dlist **heads, Dlist **tails, const char **digits, int i);
+
+
+// ------------------> Parallel decimal conversion <-------------------
+
+// Most threads of one conversion, and fewest items (digits or limbs) handed to one of them (convert.c).
+#define CONVERT_MAX_THREADS 64
+#ifndef CONVERT_GRAIN
+#define CONVERT_GRAIN       (1L << 13)
+#endif
+
+// Work on the items [begin, end) of one chunk of a conversion.
+typedef void (*convert_work)(void *arg, int chunk, long begin, long end);
+
+// Threads for `size` items, one per started `grain` (1: this thread only; always 1 for allocating work under an arena).
+int convert_threads(long size, long grain, int allocates);
+
+// Run work over [0, size) in `threads` chunks (multiples of `grain`), each on its own thread; helper threads' allocations are charged here.
+void convert_run(long size, long grain, int threads, convert_work work, void *arg);
+
+// Digit string → list (appended, chunks built in parallel); the whole list is deleted on failure.
+int digits_to_list(const char *digits, long length, Dlist **head, Dlist **tail);
+
+
+// ------------------> Kernel registry and tuning <-------------------
+
+// Kernel of a family to use for operands of `size` digits.
+const kernel_t *select_kernel(const char *family, int size);
+
+// Look up a family / a kernel by name; NULL if unknown.
+kernel_family *find_family(const char *family);
+kernel_t *find_kernel(const char *family, const char *name);
+
+// Threshold (digits) from which a kernel is used.
+int kernel_threshold(const char *family, const char *name);
+
+// Thresholds file: $APC_THRESHOLDS or ./apc_thresholds.conf
+const char *thresholds_path(void);
+
+// Load thresholds file once (NULL → thresholds_path()); keeps defaults if missing.
+int load_thresholds(const char *path);
+
+// Write current thresholds to a file.
+int save_thresholds(const char *path);
+
+// Measure kernel crossovers on this host and write the thresholds file (./a.out --tune).
+int tune_thresholds(const char *path);
+
+
+// ------------------> Out-of-core arithmetic <-------------------
+
+// <file1> op <file2> for op in + - * cmp on file-backed limb buffers; the result goes to path_r (outofcore.c).
+int out_of_core_operation(const char *op, const char *path1, const char *path2, const char *path_r, long long memory_mb);
+
+
+// ------------------> Calculator server <-------------------
+
+// Answer length-prefixed requests on a Unix socket with a pool of `threads` workers (0: one per CPU); server.c.
+int serve(const char *path, int threads);
+
+// Client stub: send one request (or one per stdin line for "-"), print the responses.
+int serve_client(const char *path, int argc, char *argv[]);
+
+
+// ------------------> Limb arithmetic <-------------------
+
+// Conversions between digit lists and limbs (base 10^9).
+int limbs_from_list(Dlist *head, Limbs *x);
+int limbs_to_list(const Limbs *x, Dlist **head, Dlist **tail);
+
+// Unsigned digit string to limbs; print "Result          : ±value" (0 unsigned) from limbs.
+int limbs_from_string(const char *digits, Limbs *x);
+void limbs_print_result(char sign, const Limbs *x);
+
+// Free the limbs / drop leading zero limbs / set a single-limb value / copy.
+void limbs_free(Limbs *x);
+void limbs_trim(Limbs *x);
+int limbs_set_small(Limbs *x, uint32_t value);
+int limbs_copy(const Limbs *src, Limbs *dst);
+
+// Values below 10^18 as a machine word, and back.
+int limbs_set_u64(Limbs *x, uint64_t value);
+uint64_t limbs_to_u64(const Limbs *x);
+
+// Compare two limb numbers: GREATER, EQUAL or LESS.
+int limbs_cmp(const Limbs *a, const Limbs *b);
+
+// r = a + b, r = a - b (a >= b), r = a × b, r = a·p + b·q (r may alias an operand).
+int limbs_add(const Limbs *a, const Limbs *b, Limbs *r);
+int limbs_sub(const Limbs *a, const Limbs *b, Limbs *r);
+int limbs_mul(const Limbs *a, const Limbs *b, Limbs *r);
+int limbs_lincomb(const Limbs *a, uint32_t p, const Limbs *b, uint32_t q, Limbs *r);
+
+// q = a / b and r = a % b (either may be NULL).
+int limbs_divmod(const Limbs *a, const Limbs *b, Limbs *q, Limbs *r);
+
+// q = a / d (q may be NULL); returns a % d.
+uint32_t limbs_divmod_small(const Limbs *a, uint32_t d, Limbs *q);
+
+// r = product of all items by a balanced product tree (r must not alias an item).
+int limbs_product(const Limbs *items, int count, Limbs *r);
+
+// g = gcd(a, b) on limbs (Lehmer / half-gcd as registered for "gcd").
+int limbs_gcd(const Limbs *a, const Limbs *b, Limbs *g);
+
+
+// r = base^e mod n by square-and-multiply on limbs (primes.c).
+int limbs_powmod(const Limbs *base, const Limbs *e, const Limbs *n, Limbs *r);
+
+
+// ------------------> Fixed-width arithmetic <-------------------
+
+// Width (256 .. 4096 bits) of the fixed-width kernels (fixed.h) for an odd modulus n, or 0 if none fits.
+int fixed_bits(const Limbs *n);
+
+// r = base^e mod n with Montgomery multiplication in that width (fixed_bits(n) must be non-zero).
+int fixed_powmod(const Limbs *base, const Limbs *e, const Limbs *n, Limbs *r);
+
+// headB = base^e mod m in [0, m) on digit lists, replacing the base list (e >= 0, m > 0).
+int powmod(Dlist **headB, Dlist **tailB, char signB, Dlist *headE, Dlist *headM);
+
+
+// ------------------> Batched arithmetic <-------------------
+
+// Allocate `count` lanes of `limbs` limbs each (zero, '+') / free a batch; limbs needed for `digits` digits.
+int batch_init(Batch *b, int count, int limbs);
+void batch_free(Batch *b);
+int batch_limbs(int digits);
+
+// Lane i from a checked integer string / printed as a result line.
+void batch_set(Batch *b, int i, const char *s);
+int batch_print(const Batch *b, int i);
+
+// Lane-parallel r = a + b, a - b, a × b (r is reinitialized), order = cmp(a, b) per lane (SIMD, batch.c).
+int batch_add(const Batch *a, const Batch *b, Batch *r);
+int batch_sub(const Batch *a, const Batch *b, Batch *r);
+int batch_mul(const Batch *a, const Batch *b, Batch *r);
+int batch_cmp(const Batch *a, const Batch *b, int *order);
+
+// ./a.out --batch <+|-|*|cmp> [file]: one "a b" row per line in, one result line per row out.
+int batch_run(const char *op, const char *path);
+
+
+// ------------------> Aggregates <-------------------
+
+// ./a.out --aggregate <sum|product|min|max|sort> [file]: one aggregate over a stream of integers (threads, aggregate.c).
+int aggregate_run(const char *op, const char *path);
+
+
+// ------------------> Modulus context <-------------------
+
+// Prepare / release the context of divisor m (FAILURE for m == 0).
+int modctx_init(ModContext *ctx, const Limbs *m);
+void modctx_free(ModContext *ctx);
+
+// q = a / m and r = a % m with the precomputed reciprocal (either may be NULL or alias a).
+int modctx_divmod(const ModContext *ctx, const Limbs *a, Limbs *q, Limbs *r);
+
+// headR = head / m (quotient != 0) or head % m on digit lists.
+int modctx_divmod_list(const ModContext *ctx, Dlist *head, int quotient, Dlist **headR, Dlist **tailR);
+
+// Per-thread contexts of recent divisors: enabled by the --serve workers, NULL from lookup otherwise.
+void modctx_cache_enable(void);
+const ModContext *modctx_lookup(Dlist *head);
+
+// ./a.out --modulus <divisor> <%|/> <dividend...|->: one result line per dividend.
+int modctx_batch(const char *divisor, const char *op, int count, char *dividends[]);
+
+
+// ------------------> Decimal numbers <-------------------
+
+// Rounding mode (ROUND_*) for a name such as "half-even", or FAILURE.
+int rounding_mode(const char *name);
+
+// True if the operand string contains a decimal point.
+int is_decimal(const char *s);
+
+// Parse [+|-]digits[.digits] into a Decimal.
+int string_to_decimal(const char *str, Decimal *d);
+
+// Free the coefficient list of a Decimal.
+void decimal_free(Decimal *d);
+
+// Print a Decimal with exactly `scale` fractional digits.
+void print_decimal(const Decimal *d);
+
+// Rescale to exactly `scale` fractional digits, rounding with `mode` when digits are dropped.
+int decimal_round(Decimal *d, int scale, int mode);
+
+// r = a ± b and r = a × b, exact (operands are consumed).
+int decimal_add(Decimal *a, Decimal *b, Decimal *r, int subtract);
+int decimal_mul(Decimal *a, Decimal *b, Decimal *r);
+
+// r = a / b with `precision` fractional digits, rounded with `mode` (operands are consumed).
+int decimal_div(Decimal *a, Decimal *b, Decimal *r, int precision, int mode);
+
+// Decimal operation handler for + - * / ^; prints the result.
+int perform_decimal_operation(const char *op, Decimal *a, Decimal *b, int precision, int fixed, int mode);
+
+
+// ------------------> Rational numbers <-------------------
+
+// True if the operand string contains a fraction bar.
+int is_rational(const char *s);
+
+// Parse [+|-]digits[/digits] (or a decimal) into a Rational.
+int string_to_rational(const char *str, Rational *r);
+
+// Free both lists of a Rational.
+void rational_free(Rational *r);
+
+// Print sign, numerator and "/denominator" (omitted when it is 1).
+void print_rational(const Rational *r);
+
+// Divide numerator and denominator by their gcd (no-op if nothing is pending).
+int rational_reduce(Rational *r);
+
+// r = a ± b, r = a × b, r = a / b (operands are consumed; reduction is batched).
+int rational_add(Rational *a, Rational *b, Rational *r, int subtract);
+int rational_mul(Rational *a, Rational *b, Rational *r);
+int rational_div(Rational *a, Rational *b, Rational *r);
+
+// Compare a and b: *result = GREATER, EQUAL or LESS.
+int rational_compare(const Rational *a, const Rational *b, int *result);
+
+// Rational operation handler for + - * / ^ cmp; prints the reduced result.
+int perform_rational_operation(const char *op, Rational *a, Rational *b);
+
+
+// ------------------> Memory accounting <-------------------
+
+// Allocation wrappers: count bytes in use and the peaks, refuse requests over a cap (memory.c).
+void *apc_malloc(size_t size);
+void *apc_calloc(size_t count, size_t size);
+void *apc_realloc(void *ptr, size_t size);
+void apc_free(void *ptr);
+
+// Read the caps from APC_MEMORY_LIMIT / APC_OP_MEMORY_LIMIT, or set them (MB, 0 = unlimited, negative = keep).
+void memory_init(void);
+void memory_set_limits(long long process_mb, long long operation_mb);
+
+// Start counting a new operation (its cap and peak are relative to the bytes in use now).
+void memory_begin_operation(void);
+
+// FAILURE (and the limit error) if `bytes` more would cross a cap.
+int memory_admit(size_t bytes);
+
+// Per-connection node arenas: list nodes of the calling thread come from `arena` after arena_use (NULL: apc_malloc).
+NodeArena *arena_create(void);
+void arena_destroy(NodeArena *arena);
+void arena_use(NodeArena *arena);
+
+// 1 if the calling thread allocates its nodes from an arena.
+int arena_active(void);
+
+// Allocate / free one list node (from the thread's arena if one is in use).
+Dlist *node_alloc(void);
+void node_free(Dlist *node);
+
+// Bytes still allowed under the caps, in use now, peak of the process / of the operation; 1 if a request was refused.
+size_t memory_available(void);
+size_t memory_in_use(void);
+size_t memory_peak(void);
+size_t memory_operation_peak(void);
+int memory_exceeded(void);
+
+// Bytes of this thread's operation in use; charge bytes allocated on its behalf by helper threads.
+long long memory_operation_used(void);
+void memory_charge(long long bytes);
+
+
+// ------------------> Profiling <-------------------
+
+// Enable profiling when APC_PROFILE is set (also enabled by the --profile flag).
+void profile_init(void);
+
+// Enter / leave a phase (PHASE_*); nested phases pause the enclosing one.
+void profile_begin(int phase);
+void profile_end(int phase);
+
+// Count an allocation of `bytes`, or `count` node frees (counters of the calling thread).
+void profile_alloc(long bytes);
+void profile_free(long count);
+
+// Allocation counters of one thread; a conversion's helper threads hand theirs to the caller (convert.c).
+typedef struct
+{
+	long allocs;
+	long alloc_bytes;
+	long frees;
+}ProfileCounts;
+ProfileCounts profile_thread_counts(void);
+void profile_charge(const ProfileCounts *counts);
+
+// Record the number of threads a conversion ran on (the largest is reported).
+void profile_threads(int threads);
+
+// Record operand / result sizes and a kernel call; the *_digits forms for numbers that never became a list.
+void profile_operand(Dlist *head);
+void profile_result(Dlist *head);
+void profile_result_digits(long digits);
+void profile_operand_digits(long digits);
+void profile_kernel(const char *family, const char *name, long size);
+
+// Print all counters as one JSON object on stderr.
+void profile_report(const char *op);
+
 
 // ------------------> Arithmetic operations <-------------------
 
@@ -73,16 +560,92 @@ int addition(Dlist **head1, Dlist **tail1, Dlist **head2, Dlist **tail2, Dlist *
 // Subtraction
 int subtraction(Dlist **head1, Dlist **tail1, Dlist **head2, Dlist **tail2, Dlist **headR);
 
+// A = A - B in place (A >= B); leading zeros of A are left in place.
+void subtract_in_place(Dlist *tail1, Dlist *tail2);
+
 // Multiplication
 int multiplication(Dlist **head1, Dlist **tail1, Dlist **head2, Dlist **tail2, Dlist **headR);
 
+// Multiply-accumulate: R = R + (A × B), in place with a single carry pass
+int addmul(Dlist **headR, Dlist **tailR, Dlist **head1, Dlist **tail1, Dlist **head2, Dlist **tail2);
+
+// Multiply-subtract: R = |R - (A × B)| in place; borrow is set to 1 when A × B > R
+int submul(Dlist **headR, Dlist **tailR, Dlist **head1, Dlist **tail1, Dlist **head2, Dlist **tail2, int *borrow);
+
+// Multiplication kernels: column multiplication and Karatsuba
+int mul_basecase(Dlist **head1, Dlist **tail1, Dlist **head2, Dlist **tail2, Dlist **headR);
+int mul_karatsuba(Dlist **head1, Dlist **tail1, Dlist **head2, Dlist **tail2, Dlist **headR);
+
 // Square
 int square(Dlist **head1, Dlist **tail1, Dlist **headR);
 
+// Square kernels: symmetric column squaring and Karatsuba
+int sqr_basecase(Dlist **head1, Dlist **tail1, Dlist **headR);
+int sqr_karatsuba(Dlist **head1, Dlist **tail1, Dlist **headR);
+
+// Polynomial product of coefficient arrays, least significant first: out[0 .. la+lb-2] = a × b (Karatsuba, karatsuba.c).
+int poly_mul(const long long *a, int la, const long long *b, int lb, long long *out, int cutoff);
+
+// Schoolbook rows on coefficient arrays, four rows per pass: out[0 .. la+lb-2] += a × b, and out[0 .. 2n-2] = a².
+void poly_addmul_basecase(const long long *a, int la, const long long *b, int lb, long long *out);
+void poly_sqr_basecase(const long long *a, int n, long long *out);
+
+// Short products (short.c): mul_low / sqr_low give the last k digits of the product (|A × B| mod 10^k),
+// mul_high / sqr_high the leading k digits, with *length set to the digit count of the whole product.
+int mul_low(Dlist **head1, Dlist **tail1, Dlist **head2, Dlist **tail2, int k, Dlist **headR);
+int sqr_low(Dlist **head1, Dlist **tail1, int k, Dlist **headR);
+int mul_high(Dlist **head1, Dlist **tail1, Dlist **head2, Dlist **tail2, int k, Dlist **headR, long *length);
+int sqr_high(Dlist **head1, Dlist **tail1, int k, Dlist **headR, long *length);
+
+// ./a.out --lastdigits|--firstdigits K <num1> <*|^> [<num2>]: the low or leading K digits of a product or square.
+int short_product_run(const char *option, const char *count, int argc, char *argv[]);
+
 // Division
 int division(Dlist **head1, Dlist **tail1, Dlist **head2, Dlist **tail2, Dlist **headR);
 
+// Division kernels: repeated subtraction and estimated quotient digits
+int div_subtract(Dlist **head1, Dlist **tail1, Dlist **head2, Dlist **tail2, Dlist **headR);
+int div_schoolbook(Dlist **head1, Dlist **tail1, Dlist **head2, Dlist **tail2, Dlist **headR);
+
+// Schoolbook long division on digit arrays (least significant first): quot gets n digits, rem m + 1 digits.
+int divmod_digits(const data_t *num, int n, const data_t *den, int m, data_t *quot, data_t *rem);
+
+// Quotient and/or remainder by repeated in-place subtraction (either result pointer may be NULL).
+int divmod_subtract(Dlist *head1, Dlist *head2, Dlist *tail2, Dlist **headQ, Dlist **headRem);
+
+// Quotient and/or remainder of two lists via divmod_digits() (either result pointer may be NULL).
+int divmod_schoolbook(Dlist *head1, Dlist *head2, Dlist **headQ, Dlist **headRem);
+
+// Integer square root and k-th root (largest r with r^k <= N), Newton iteration with precision doubling
+int isqrt(Dlist **head1, Dlist **tail1, Dlist **headR);
+int iroot(Dlist **head1, Dlist **tail1, int k, Dlist **headR);
+
+// Greatest common divisor (registry family "gcd": Lehmer, then half-gcd for large operands)
+int gcd(Dlist **head1, Dlist **tail1, Dlist **head2, Dlist **tail2, Dlist **headR);
+int gcd_lehmer(Dlist **head1, Dlist **tail1, Dlist **head2, Dlist **tail2, Dlist **headR);
+int gcd_hgcd(Dlist **head1, Dlist **tail1, Dlist **head2, Dlist **tail2, Dlist **headR);
+
+// Extended gcd: g = a·s + b·t, with the signs of s and t returned separately
+int xgcd(Dlist *head1, Dlist *head2, Dlist **headG, Dlist **headS, char *sign_s, Dlist **headT, char *sign_t);
+
+// Modular inverse of a modulo m in [0, m); headR stays NULL if gcd(a, m) != 1
+int invmod(Dlist **head1, Dlist **tail1, Dlist **head2, Dlist **tail2, Dlist **headR);
+
+// Primality (2 prime, 1 probable prime, 0 composite), next prime above n, and printed factorization (primes.c)
+int isprime(Dlist **head1, Dlist **tail1);
+int nextprime(Dlist **head1, Dlist **tail1, Dlist **headR);
+int factor(Dlist **head1, Dlist **tail1);
+
+// n!, C(n, k) and the product of a list (balanced product trees, prime-swing factorial; factorial.c)
+int factorial(long long n, Dlist **headR);
+int binomial(long long n, long long k, Dlist **headR);
+int product_list(Dlist **heads, int count, Dlist **headR);
+
 // Modulus
 int modulus(Dlist **head1, Dlist **tail1, Dlist **head2, Dlist **tail2, Dlist **headR);
 
+// Modulus kernels: repeated subtraction and estimated quotient digits
+int mod_subtract(Dlist **head1, Dlist **tail1, Dlist **head2, Dlist **tail2, Dlist **headR);
+int mod_schoolbook(Dlist **head1, Dlist **tail1, Dlist **head2, Dlist **tail2, Dlist **headR);
+
 #endif
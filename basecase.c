@@ -0,0 +1,150 @@
+/*******************************************************************************************************************************************************************
+ * Word basecase kernels
+ * ---------------------
+ *  Every product on binary words (fixed.h: full products, Montgomery multiplication, and so powmod and the
+ *  Miller-Rabin rounds) is a sequence of rows r += a × b for one word b:
+ *
+ *     word_addmul_1      : r[0 .. n) += a[0 .. n) × b, returns the word carried out
+ *     word_mul_basecase  : r[0 .. na + nb) = a × b, one word_addmul_1 row per word of b
+ *
+ *  word_addmul_1 has two implementations, chosen by CPUID on the first call (the choice is kept in a pointer):
+ *
+ *     adx     : BMI2 / ADX CPUs. Blocks of 4 words, each a mulx (flag-free 64 × 64 → 128 multiply) feeding two
+ *               independent carry chains: adcx adds the high word of the previous product (CF), adox adds the
+ *               word of r (OF), so the two additions per word do not wait for each other.
+ *     generic : 128-bit products in C, unrolled by 4; every other target, and CPUs without ADX.
+ *
+ *  Both give the same results; the carry out of a row always fits in one word since r + a·b < 2^(64(n+1)).
+ *  word_addmul_1_impl hands out either one by name, so scripts/check-addmul.c can compare them on any CPU
+ *  that runs both.
+*******************************************************************************************************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "fixed.h"
+
+/* One word of a row: r = r + a·b + carry, carry = the high word */
+#define ADDMUL_STEP(r, a, b, carry)                                  \
+	do                                                               \
+	{                                                                \
+		fixed_dword t = (fixed_dword)(a) * (b) + (r) + (carry);      \
+		(r) = (uint64_t)t;                                           \
+		(carry) = (uint64_t)(t >> 64);                               \
+	}while(0)
+
+static uint64_t addmul_1_generic(uint64_t *r, const uint64_t *a, int n, uint64_t b)
+{
+	uint64_t carry = 0;
+	int i = 0;
+	for(; i + 4 <= n; i += 4)
+	{
+		ADDMUL_STEP(r[i], a[i], b, carry);
+		ADDMUL_STEP(r[i + 1], a[i + 1], b, carry);
+		ADDMUL_STEP(r[i + 2], a[i + 2], b, carry);
+		ADDMUL_STEP(r[i + 3], a[i + 3], b, carry);
+	}
+	for(; i < n; i++)
+	{
+		ADDMUL_STEP(r[i], a[i], b, carry);
+	}
+	return carry;
+}
+
+#if defined(__x86_64__) && defined(__GNUC__)
+
+__attribute__((target("bmi2,adx")))
+static uint64_t addmul_1_adx(uint64_t *r, const uint64_t *a, int n, uint64_t b)
+{
+	uint64_t carry = 0, lo, hi;
+	int i = 0;
+	for(; i + 4 <= n; i += 4)
+	{
+		// xor clears CF and OF; mov leaves the flags alone, so both chains run to the end of the block
+		__asm__(
+			"xor   %k[lo], %k[lo]\n\t"
+			"mulx  (%[a]), %[lo], %[hi]\n\t"
+			"adcx  %[c], %[lo]\n\t"
+			"adox  (%[r]), %[lo]\n\t"
+			"mov   %[lo], (%[r])\n\t"
+			"mulx  8(%[a]), %[lo], %[c]\n\t"
+			"adcx  %[hi], %[lo]\n\t"
+			"adox  8(%[r]), %[lo]\n\t"
+			"mov   %[lo], 8(%[r])\n\t"
+			"mulx  16(%[a]), %[lo], %[hi]\n\t"
+			"adcx  %[c], %[lo]\n\t"
+			"adox  16(%[r]), %[lo]\n\t"
+			"mov   %[lo], 16(%[r])\n\t"
+			"mulx  24(%[a]), %[lo], %[c]\n\t"
+			"adcx  %[hi], %[lo]\n\t"
+			"adox  24(%[r]), %[lo]\n\t"
+			"mov   %[lo], 24(%[r])\n\t"
+			"mov   $0, %k[lo]\n\t"
+			"adcx  %[lo], %[c]\n\t"
+			"adox  %[lo], %[c]\n\t"
+			: [lo] "=&r"(lo), [hi] "=&r"(hi), [c] "+&r"(carry)
+			: [a] "r"(a + i), [r] "r"(r + i), "d"(b)
+			: "cc", "memory");
+	}
+	for(; i < n; i++)
+	{
+		ADDMUL_STEP(r[i], a[i], b, carry);
+	}
+	return carry;
+}
+
+static int adx_supported(void)
+{
+	__builtin_cpu_init();
+	return __builtin_cpu_supports("bmi2") && __builtin_cpu_supports("adx");
+}
+
+/* First call: pick the implementation for this CPU (threads racing here all store the same pointer) */
+static uint64_t addmul_1_resolve(uint64_t *r, const uint64_t *a, int n, uint64_t b);
+static word_addmul_1_fn addmul_1 = addmul_1_resolve;
+
+static uint64_t addmul_1_resolve(uint64_t *r, const uint64_t *a, int n, uint64_t b)
+{
+	word_addmul_1_fn chosen = adx_supported() ? addmul_1_adx : addmul_1_generic;
+	__atomic_store_n(&addmul_1, chosen, __ATOMIC_RELAXED);
+	return chosen(r, a, n, b);
+}
+
+uint64_t word_addmul_1(uint64_t *r, const uint64_t *a, int n, uint64_t b)
+{
+	return __atomic_load_n(&addmul_1, __ATOMIC_RELAXED)(r, a, n, b);
+}
+
+#else
+
+static int adx_supported(void)
+{
+	return 0;
+}
+
+#define addmul_1_adx NULL
+
+uint64_t word_addmul_1(uint64_t *r, const uint64_t *a, int n, uint64_t b)
+{
+	return addmul_1_generic(r, a, n, b);
+}
+
+#endif
+
+word_addmul_1_fn word_addmul_1_impl(const char *name)
+{
+	if(strcmp(name, "adx") == 0)
+	{
+		return adx_supported() ? addmul_1_adx : NULL;
+	}
+	return (strcmp(name, "generic") == 0) ? addmul_1_generic : NULL;
+}
+
+void word_mul_basecase(uint64_t *r, const uint64_t *a, int na, const uint64_t *b, int nb)
+{
+	memset(r, 0, (size_t)(na + nb) * sizeof(uint64_t));
+	for(int i = 0; i < nb; i++)
+	{
+		r[i + na] = word_addmul_1(r + i, a, na, b[i]);
+	}
+}
@@ -0,0 +1,492 @@
+/*******************************************************************************************************************************************************************
+ * Batched arithmetic
+ * ------------------
+ *  A column of numbers is processed lane-parallel instead of one addition() / multiplication() per row. A Batch
+ *  holds `count` numbers of `limbs` limbs each in structure-of-arrays form:
+ *
+ *     d[k * count + i] = limb k of number i      (little-endian, base 10^4 = BATCH_BASE)
+ *     sign[i]          = '+' or '-'
+ *
+ *  so every step of a kernel runs the same instruction over consecutive lanes. Base 10^4 keeps everything in
+ *  32-bit lanes: a limb product is below 10^8 and BATCH_ROWS of them still fit in a column before the carries
+ *  are resolved, and the carry division by 10^4 is a multiply-high the vectorizer handles (a 64-bit division
+ *  by 10^9 is not vectorized).
+ *
+ *     batch_add / batch_sub : signed r = a ± b, magnitudes added or subtracted per lane with blends
+ *     batch_mul             : signed r = a × b, column sums of BATCH_ROWS rows, then one carry pass
+ *     batch_cmp             : -1, 0 or 1 per lane
+ *
+ *  The kernels are compiled for AVX-512, AVX2 and the baseline (target_clones) and the loader picks the best
+ *  one the CPU supports, so 16, 8 or 4 lanes run per instruction with a scalar fallback on other targets.
+ *
+ *  ./a.out --batch <+|-|*|cmp> [file] reads one pair of operands per line (from stdin without a file), runs
+ *  them BATCH_CHUNK rows at a time and prints one result line per row. Within a chunk the rows are grouped by
+ *  the limb count of their widest operand, rounded down to a power of two, and each group runs as its own batch
+ *  padded to its own widest row, so one long row does not widen every lane of the chunk.
+*******************************************************************************************************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "apc.h"
+
+#define BATCH_BASE   10000u
+#define BATCH_DIGITS 4
+
+/* Product rows summed into a column before its carries are resolved: 40 · (10^4 - 1)^2 + 10^4 < 2^32 */
+#define BATCH_ROWS 40
+
+/* Rows per chunk of ./a.out --batch */
+#define BATCH_CHUNK 1024
+
+/* Width classes of a chunk: class c holds the rows whose widest operand has 2^c to 2^(c+1) - 1 limbs */
+#define BATCH_CLASSES 32
+
+/* Runtime dispatch between the vector widths (GCC function multiversioning on x86-64) */
+#if defined(__x86_64__) && defined(__GNUC__) && !defined(__clang__)
+#define BATCH_CLONES __attribute__((target_clones("avx512f", "avx2", "default")))
+#else
+#define BATCH_CLONES
+#endif
+
+int batch_init(Batch *b, int count, int limbs)
+{
+	b->count = count;
+	b->limbs = limbs;
+	b->d = apc_calloc((size_t)count * limbs + 1, sizeof(uint32_t));
+	b->sign = apc_malloc(count + 1);
+	if(b->d == NULL || b->sign == NULL)
+	{
+		batch_free(b);
+		return FAILURE;
+	}
+	memset(b->sign, '+', count);
+	return SUCCESS;
+}
+
+void batch_free(Batch *b)
+{
+	apc_free(b->d);
+	apc_free(b->sign);
+	b->d = NULL;
+	b->sign = NULL;
+	b->count = b->limbs = 0;
+}
+
+/* Limbs needed for a number of `digits` digits */
+int batch_limbs(int digits)
+{
+	return (digits + BATCH_DIGITS - 1) / BATCH_DIGITS;
+}
+
+/* Lane i = [+|-]digits (the caller checked the string and sized the batch) */
+void batch_set(Batch *b, int i, const char *s)
+{
+	const char *digits;
+	b->sign[i] = remove_sign(s, &digits);
+	int length = strlen(digits);
+	for(int k = 0; k < b->limbs; k++)
+	{
+		int end = length - k * BATCH_DIGITS, start = end - BATCH_DIGITS;
+		uint32_t limb = 0;
+		for(int j = (start > 0) ? start : 0; j < end; j++)
+		{
+			limb = limb * 10 + (digits[j] - '0');
+		}
+		b->d[(size_t)k * b->count + i] = limb;
+	}
+}
+
+/* Print lane i as "Result          : ±value" (0 unsigned), formatted in one buffer */
+int batch_print(const Batch *b, int i)
+{
+	int top = b->limbs - 1;
+	while(top >= 0 && b->d[(size_t)top * b->count + i] == 0)
+	{
+		top--;
+	}
+	if(top < 0)
+	{
+		apc_printf("Result          : 0\n");
+		return SUCCESS;
+	}
+
+	char small[256], *text = small;
+	size_t size = (size_t)(top + 1) * BATCH_DIGITS + 2;
+	if(size > sizeof(small) && (text = apc_malloc(size)) == NULL)
+	{
+		return FAILURE;
+	}
+	int length = sprintf(text, "%c%u", b->sign[i], b->d[(size_t)top * b->count + i]);
+	for(int k = top - 1; k >= 0; k--)
+	{
+		// Four digits of the limb, leading zeros kept
+		uint32_t limb = b->d[(size_t)k * b->count + i];
+		for(int j = BATCH_DIGITS - 1; j >= 0; j--, limb /= 10)
+		{
+			text[length + j] = '0' + limb % 10;
+		}
+		length += BATCH_DIGITS;
+	}
+	text[length] = '\0';
+	apc_printf("Result          : %s\n", text);
+	if(text != small)
+	{
+		apc_free(text);
+	}
+	return SUCCESS;
+}
+
+
+/* ------------------> Lane kernels <------------------- */
+
+/* order[i] = sign of |a_i| - |b_i|, from the top limb down */
+BATCH_CLONES
+static void compare_magnitudes(const uint32_t *a, const uint32_t *b, int count, int limbs, int *order)
+{
+	memset(order, 0, count * sizeof(int));
+	for(int k = limbs - 1; k >= 0; k--)
+	{
+		const uint32_t *x = a + (size_t)k * count, *y = b + (size_t)k * count;
+		for(int i = 0; i < count; i++)
+		{
+			int diff = (x[i] > y[i]) - (x[i] < y[i]);
+			order[i] = order[i] ? order[i] : diff;
+		}
+	}
+}
+
+/* r = |a| + |b| where subtract[i] is 0, ||a| - |b|| where it is 1 (swap[i]: |b| is the larger) */
+BATCH_CLONES
+static void add_sub_lanes(const uint32_t *a, const uint32_t *b, uint32_t *r, int count, int limbs,
+                          const int *subtract, const int *swap, int *carry)
+{
+	memset(carry, 0, count * sizeof(int));
+	for(int k = 0; k < limbs; k++)
+	{
+		const uint32_t *x = a + (size_t)k * count, *y = b + (size_t)k * count;
+		uint32_t *z = r + (size_t)k * count;
+		for(int i = 0; i < count; i++)
+		{
+			int big = swap[i] ? (int)y[i] : (int)x[i], small = swap[i] ? (int)x[i] : (int)y[i];
+			int v = subtract[i] ? big - small - carry[i] : big + small + carry[i];
+			int under = (v < 0), over = (v >= (int)BATCH_BASE);
+			carry[i] = under | over;
+			z[i] = (uint32_t)(under ? v + (int)BATCH_BASE : over ? v - (int)BATCH_BASE : v);
+		}
+	}
+	// The top limb of r takes the final carry of an addition
+	uint32_t *z = r + (size_t)limbs * count;
+	for(int i = 0; i < count; i++)
+	{
+		z[i] = subtract[i] ? 0 : (uint32_t)carry[i];
+	}
+}
+
+/* r (2·limbs limbs, zeroed) = a × b per lane */
+BATCH_CLONES
+static void mul_lanes(const uint32_t *a, const uint32_t *b, uint32_t *r, int count, int limbs)
+{
+	int columns = 2 * limbs;
+	for(int row = 0; row < limbs; row += BATCH_ROWS)
+	{
+		int last = (row + BATCH_ROWS < limbs) ? row + BATCH_ROWS : limbs;
+		for(int j = row; j < last; j++)
+		{
+			const uint32_t *y = b + (size_t)j * count;
+			for(int k = 0; k < limbs; k++)
+			{
+				const uint32_t *x = a + (size_t)k * count;
+				uint32_t *z = r + (size_t)(j + k) * count;
+				for(int i = 0; i < count; i++)
+				{
+					z[i] += x[i] * y[i];
+				}
+			}
+		}
+
+		// Resolve the carries so every column is below BATCH_BASE again
+		for(int c = 0; c + 1 < columns; c++)
+		{
+			uint32_t *z = r + (size_t)c * count, *next = z + count;
+			for(int i = 0; i < count; i++)
+			{
+				next[i] += z[i] / BATCH_BASE;
+				z[i] %= BATCH_BASE;
+			}
+		}
+	}
+}
+
+
+/* nonzero[i] = 1 if lane i is not zero */
+BATCH_CLONES
+static void nonzero_lanes(const uint32_t *a, int count, int limbs, int *nonzero)
+{
+	memset(nonzero, 0, count * sizeof(int));
+	for(int k = 0; k < limbs; k++)
+	{
+		const uint32_t *x = a + (size_t)k * count;
+		for(int i = 0; i < count; i++)
+		{
+			nonzero[i] |= (x[i] != 0);
+		}
+	}
+}
+
+
+/* ------------------> Signed batch operations <------------------- */
+
+/*****************************************************************************************
+ * Function: batch_add / batch_sub
+ * -------------------------------
+ * r = a ± b lane by lane; a and b hold the same count and limbs, r is (re)initialized
+ * with one more limb. Returns FAILURE if memory allocation fails.
+ *****************************************************************************************/
+
+static int batch_add_sub(const Batch *a, const Batch *b, Batch *r, int negate_b)
+{
+	int count = a->count, limbs = a->limbs;
+	int *order = apc_malloc(4 * (size_t)count * sizeof(int) + 1);
+	if(order == NULL)
+	{
+		return FAILURE;
+	}
+	int *subtract = order + count, *swap = order + 2 * count, *carry = order + 3 * count;
+	batch_free(r);
+	if(batch_init(r, count, limbs + 1) == FAILURE)
+	{
+		apc_free(order);
+		return FAILURE;
+	}
+
+	compare_magnitudes(a->d, b->d, count, limbs, order);
+	for(int i = 0; i < count; i++)
+	{
+		char sign_b = negate_b ? ((b->sign[i] == '+') ? '-' : '+') : b->sign[i];
+		subtract[i] = (a->sign[i] != sign_b);
+		swap[i] = (order[i] < 0);
+		// A difference takes the sign of the larger magnitude
+		r->sign[i] = (subtract[i] && swap[i]) ? sign_b : a->sign[i];
+	}
+	add_sub_lanes(a->d, b->d, r->d, count, limbs, subtract, swap, carry);
+	apc_free(order);
+	return SUCCESS;
+}
+
+int batch_add(const Batch *a, const Batch *b, Batch *r)
+{
+	return batch_add_sub(a, b, r, 0);
+}
+
+int batch_sub(const Batch *a, const Batch *b, Batch *r)
+{
+	return batch_add_sub(a, b, r, 1);
+}
+
+/* r = a × b lane by lane (r gets 2·limbs limbs) */
+int batch_mul(const Batch *a, const Batch *b, Batch *r)
+{
+	batch_free(r);
+	if(batch_init(r, a->count, 2 * a->limbs) == FAILURE)
+	{
+		return FAILURE;
+	}
+	mul_lanes(a->d, b->d, r->d, a->count, a->limbs);
+	for(int i = 0; i < a->count; i++)
+	{
+		r->sign[i] = (a->sign[i] == b->sign[i]) ? '+' : '-';
+	}
+	return SUCCESS;
+}
+
+/* order[i] = -1, 0 or 1 as a_i <, =, > b_i (zero has no sign) */
+int batch_cmp(const Batch *a, const Batch *b, int *order)
+{
+	int *nonzero = apc_malloc(2 * (size_t)a->count * sizeof(int) + 1);
+	if(nonzero == NULL)
+	{
+		return FAILURE;
+	}
+	compare_magnitudes(a->d, b->d, a->count, a->limbs, order);
+	nonzero_lanes(a->d, a->count, a->limbs, nonzero);
+	nonzero_lanes(b->d, b->count, b->limbs, nonzero + a->count);
+	for(int i = 0; i < a->count; i++)
+	{
+		char s1 = nonzero[i] ? a->sign[i] : '+', s2 = nonzero[a->count + i] ? b->sign[i] : '+';
+		if(s1 != s2)
+			order[i] = (s1 == '+') ? GREATER : LESS;
+		else if(s1 == '-')
+			order[i] = -order[i];
+	}
+	apc_free(nonzero);
+	return SUCCESS;
+}
+
+
+/* ------------------> ./a.out --batch <op> [file] <------------------- */
+
+/* Split "a b" into two operand strings (in place); FAILURE unless both are plain integers */
+static int split_pair(char *line, char **a, char **b)
+{
+	char *save = NULL;
+	*a = strtok_r(line, " \t\r\n,", &save);
+	*b = strtok_r(NULL, " \t\r\n,", &save);
+	if(*a == NULL || *b == NULL || strtok_r(NULL, " \t\r\n,", &save) != NULL)
+		return FAILURE;
+	if(check_sign(*a) == FAILURE || check_sign(*b) == FAILURE || strpbrk(*a, "./") || strpbrk(*b, "./"))
+		return FAILURE;
+	return SUCCESS;
+}
+
+/* Run one chunk of rows and print their results */
+static int run_chunk(const char *op, char **lines, int rows)
+{
+	char **first = apc_malloc(2 * (size_t)rows * sizeof(char *) + 1), **second = first + rows;
+	int *order = apc_malloc(5 * (size_t)rows * sizeof(int) + 1);
+	int *valid = order + rows, *width = order + 2 * rows, *lane = order + 3 * rows, *lane_order = order + 4 * rows;
+	Batch a[BATCH_CLASSES], b[BATCH_CLASSES], r[BATCH_CLASSES];
+	int count[BATCH_CLASSES] = { 0 }, widest[BATCH_CLASSES] = { 0 };
+	int status = FAILURE;
+	memset(a, 0, sizeof(a));
+	memset(b, 0, sizeof(b));
+	memset(r, 0, sizeof(r));
+	if(first == NULL || order == NULL)
+		goto done;
+
+	// Width class of every row; malformed rows run as 0 op 0 and print an error instead
+	for(int i = 0; i < rows; i++)
+	{
+		valid[i] = (split_pair(lines[i], &first[i], &second[i]) == SUCCESS);
+		if(!valid[i])
+		{
+			first[i] = second[i] = "0";
+		}
+		int digits = 1;
+		for(int k = 0; k < 2; k++)
+		{
+			const char *digits_k;
+			remove_sign(k ? second[i] : first[i], &digits_k);
+			int length = strlen(digits_k);
+			digits = (length > digits) ? length : digits;
+		}
+		int limbs = batch_limbs(digits), c = 31 - __builtin_clz(limbs);
+		width[i] = c;
+		lane[i] = count[c]++;
+		widest[c] = (limbs > widest[c]) ? limbs : widest[c];
+	}
+
+	// One batch per class, padded to the widest row of that class only
+	status = SUCCESS;
+	for(int c = 0; c < BATCH_CLASSES && status == SUCCESS; c++)
+	{
+		if(count[c] == 0)
+			continue;
+		if(batch_init(&a[c], count[c], widest[c]) == FAILURE || batch_init(&b[c], count[c], widest[c]) == FAILURE)
+		{
+			status = FAILURE;
+			break;
+		}
+		for(int i = 0; i < rows; i++)
+		{
+			if(width[i] == c)
+			{
+				batch_set(&a[c], lane[i], first[i]);
+				batch_set(&b[c], lane[i], second[i]);
+			}
+		}
+
+		if(strcmp(op, "+") == 0)
+			status = batch_add(&a[c], &b[c], &r[c]);
+		else if(strcmp(op, "-") == 0)
+			status = batch_sub(&a[c], &b[c], &r[c]);
+		else if(strcmp(op, "*") == 0)
+			status = batch_mul(&a[c], &b[c], &r[c]);
+		else if((status = batch_cmp(&a[c], &b[c], lane_order)) == SUCCESS)
+		{
+			for(int i = 0; i < rows; i++)
+			{
+				if(width[i] == c)
+					order[i] = lane_order[lane[i]];
+			}
+		}
+		batch_free(&a[c]);
+		batch_free(&b[c]);
+	}
+	if(status == FAILURE)
+		goto done;
+
+	for(int i = 0; i < rows; i++)
+	{
+		if(!valid[i])
+			apc_printf("ERROR : Invalid row (two integers expected)\n");
+		else if(strcmp(op, "cmp") == 0)
+			apc_printf("Result          : %d\n", order[i]);
+		else if(batch_print(&r[width[i]], lane[i]) == FAILURE)
+		{
+			status = FAILURE;
+			goto done;
+		}
+	}
+
+done:
+	for(int c = 0; c < BATCH_CLASSES; c++)
+	{
+		batch_free(&a[c]);
+		batch_free(&b[c]);
+		batch_free(&r[c]);
+	}
+	apc_free(first);
+	apc_free(order);
+	return status;
+}
+
+/*****************************************************************************************
+ * Function: batch_run
+ * -------------------
+ * ./a.out --batch <+|-|*|cmp> [file]: one result line per input row "a b", computed
+ * BATCH_CHUNK rows at a time.
+ *****************************************************************************************/
+
+int batch_run(const char *op, const char *path)
+{
+	if(strcmp(op, "+") != 0 && strcmp(op, "-") != 0 && strcmp(op, "*") != 0 && strcmp(op, "cmp") != 0)
+	{
+		printf("ERROR : --batch supports + - * cmp only\n");
+		return FAILURE;
+	}
+	FILE *in = path ? fopen(path, "r") : stdin;
+	if(in == NULL)
+	{
+		printf("ERROR : Cannot open %s\n", path);
+		return FAILURE;
+	}
+
+	char *lines[BATCH_CHUNK] = { NULL };
+	size_t sizes[BATCH_CHUNK] = { 0 };
+	int status = SUCCESS, rows = 0, done = 0;
+	while(status == SUCCESS && !done)
+	{
+		// Fill a chunk with the next non-empty lines
+		rows = 0;
+		while(rows < BATCH_CHUNK)
+		{
+			ssize_t length = getline(&lines[rows], &sizes[rows], in);
+			if(length == -1)
+			{
+				done = 1;
+				break;
+			}
+			if(strspn(lines[rows], " \t\r\n") < (size_t)length)
+				rows++;
+		}
+		if(rows > 0)
+			status = run_chunk(op, lines, rows);
+	}
+
+	for(int i = 0; i < BATCH_CHUNK; i++)
+		free(lines[i]);
+	if(path)
+		fclose(in);
+	return status;
+}
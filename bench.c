@@ -0,0 +1,414 @@
+/**************************************************************************************************************************************************************
+* Title          : APC Benchmark Suite
+* Description    :
+*                  Times every operator (+ - * / % ^) over operand sizes from 10 digits up to --max-digits (default 10^7),
+*                  growing by a factor of 10 per step.
+*
+*                  Two kinds of cases are measured:
+*                      micro : the magnitude kernel alone (addition(), division(), ...) on balanced (n × n) and
+*                              unbalanced (n × n/10) operands
+*                      macro : the complete perform_operation() path, including sign handling and printing of the
+*                              result (stdout is discarded), for every sign combination of both shapes
+*
+*                  A case is repeated until --min-time seconds have been spent on it. Once a single repetition of an
+*                  operator takes longer than --budget seconds, larger sizes of that operator are skipped, so the
+*                  quadratic kernels stop early while the linear ones run up to the full size range.
+*
+*                  For each case the suite reports ns per operation, ns per digit, throughput (digits per second) and
+*                  the peak memory of the case (the largest memory_operation_peak() of a repetition, operands not
+*                  included), as CSV and/or JSON. A case whose operation fails stops the run of its operator.
+*
+*                  Two result files (e.g. from two builds) can be compared; every case that became slower by more
+*                  than --threshold percent, or that is missing from the new file (it failed or its operator stopped
+*                  earlier), is flagged and the exit status is 1.
+*
+* Usage          :
+*                  ./apc_bench.out [--max-digits N] [--min-time S] [--budget S] [--seed N] [--csv FILE] [--json FILE]
+*                  ./apc_bench.out --compare <base.csv> <new.csv> [--threshold PERCENT]
+**************************************************************************************************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "apc.h"
+
+#define MAX_RESULTS      512
+#define MAX_LINE         256
+
+/* Benchmarked operator: either a binary or a unary (square) kernel */
+typedef struct
+{
+    const char *symbol;
+    int (*binary)(Dlist **head1, Dlist **tail1, Dlist **head2, Dlist **tail2, Dlist **headR);
+    int (*unary)(Dlist **head1, Dlist **tail1, Dlist **headR);
+}bench_op;
+
+/* One measured case */
+typedef struct
+{
+    char kind[8];           // "micro" or "macro"
+    char op[8];
+    char signs[4];          // sign of operand 1 and 2, e.g. "+-"
+    long size1;
+    long size2;
+    long reps;
+    double ns_per_op;
+    double ns_per_digit;
+    double digits_per_sec;
+    long peak_kb;           // peak bytes allocated by one repetition, in KB
+}bench_result;
+
+static const bench_op operators[] =
+{
+    { "+", addition,       NULL   },
+    { "-", subtraction,    NULL   },
+    { "*", multiplication, NULL   },
+    { "/", division,       NULL   },
+    { "%", modulus,        NULL   },
+    { "^", NULL,           square },
+};
+
+static const char *sign_pairs[] = { "++", "+-", "-+", "--" };
+
+static bench_result results[MAX_RESULTS];
+static int result_count = 0;
+
+static double now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+/* Random digit string of the given length without leading zero */
+static char *random_digits(long length)
+{
+    char *s = malloc(length + 1);
+    if(s == NULL)
+    {
+        return NULL;
+    }
+    for(long i = 0; i < length; i++)
+    {
+        s[i] = '0' + rand() % 10;
+    }
+    if(s[0] == '0')
+    {
+        s[0] = '1' + rand() % 9;
+    }
+    s[length] = '\0';
+    return s;
+}
+
+/*
+ * Time a single case. Operand lists are rebuilt before every repetition (subtraction() may
+ * swap its operand pointers), only the operation itself is inside the timed region.
+ * Each repetition is counted as one operation by memory.c, so its peak excludes the operands.
+ * Returns the time of the slowest repetition, or a negative value on failure (no row is kept).
+ */
+static double run_case(const bench_op *op, const char *kind, const char *signs, const char *digits1, long size1,
+                       const char *digits2, long size2, double min_time)
+{
+    double total = 0, slowest = 0;
+    long reps = 0;
+    size_t peak = 0;
+
+    while(total < min_time * 1e9 || reps == 0)
+    {
+        Dlist *head1 = NULL, *tail1 = NULL, *head2 = NULL, *tail2 = NULL, *headR = NULL, *tailR = NULL;
+
+        if(string_to_list(&head1, &tail1, (char *)digits1) == FAILURE ||
+           string_to_list(&head2, &tail2, (char *)digits2) == FAILURE)
+        {
+            delete_list(&head1, &tail1);
+            delete_list(&head2, &tail2);
+            return -1;
+        }
+
+        int status;
+        memory_begin_operation();
+        double start = now_ns();
+        if(strcmp(kind, "macro") == 0)
+        {
+            status = perform_operation(op->symbol, signs[0], signs[1], &head1, &tail1, &head2, &tail2, &headR, &tailR, digits1, digits2);
+        }
+        else if(op->unary)
+        {
+            status = op->unary(&head1, &tail1, &headR);
+        }
+        else
+        {
+            status = op->binary(&head1, &tail1, &head2, &tail2, &headR);
+        }
+        double elapsed = now_ns() - start;
+        if(memory_operation_peak() > peak)
+        {
+            peak = memory_operation_peak();
+        }
+
+        delete_list(&head1, &tail1);
+        delete_list(&head2, &tail2);
+        delete_list(&headR, &tailR);
+        if(status == FAILURE)
+        {
+            fprintf(stderr, "%-5s %-2s %s %9ld x %-9ld failed\n", kind, op->symbol, signs, size1, size2);
+            return -1;
+        }
+
+        total += elapsed;
+        if(elapsed > slowest)
+        {
+            slowest = elapsed;
+        }
+        reps++;
+    }
+
+    if(result_count < MAX_RESULTS)
+    {
+        bench_result *r = &results[result_count++];
+        long digits = (size1 > size2) ? size1 : size2;
+
+        snprintf(r->kind, sizeof(r->kind), "%s", kind);
+        snprintf(r->op, sizeof(r->op), "%s", op->symbol);
+        snprintf(r->signs, sizeof(r->signs), "%s", signs);
+        r->size1 = size1;
+        r->size2 = size2;
+        r->reps = reps;
+        r->ns_per_op = total / reps;
+        r->ns_per_digit = r->ns_per_op / digits;
+        r->digits_per_sec = digits / (r->ns_per_op / 1e9);
+        r->peak_kb = (long)(peak / 1024);
+
+        fprintf(stderr, "%-5s %-2s %s %9ld x %-9ld %8ld reps %14.0f ns/op %10.2f ns/digit %8ld KB\n",
+                r->kind, r->op, r->signs, r->size1, r->size2, r->reps, r->ns_per_op, r->ns_per_digit, r->peak_kb);
+    }
+    return slowest;
+}
+
+static void write_csv(const char *path)
+{
+    FILE *fp = fopen(path, "w");
+    if(fp == NULL)
+    {
+        fprintf(stderr, "ERROR : Cannot open %s\n", path);
+        return;
+    }
+    fprintf(fp, "kind,op,signs,size1,size2,reps,ns_per_op,ns_per_digit,digits_per_sec,peak_kb\n");
+    for(int i = 0; i < result_count; i++)
+    {
+        bench_result *r = &results[i];
+        fprintf(fp, "%s,%s,%s,%ld,%ld,%ld,%.1f,%.4f,%.1f,%ld\n", r->kind, r->op, r->signs, r->size1, r->size2,
+                r->reps, r->ns_per_op, r->ns_per_digit, r->digits_per_sec, r->peak_kb);
+    }
+    fclose(fp);
+}
+
+static void write_json(const char *path)
+{
+    FILE *fp = fopen(path, "w");
+    if(fp == NULL)
+    {
+        fprintf(stderr, "ERROR : Cannot open %s\n", path);
+        return;
+    }
+    fprintf(fp, "[\n");
+    for(int i = 0; i < result_count; i++)
+    {
+        bench_result *r = &results[i];
+        fprintf(fp, "  {\"kind\": \"%s\", \"op\": \"%s\", \"signs\": \"%s\", \"size1\": %ld, \"size2\": %ld, \"reps\": %ld, "
+                    "\"ns_per_op\": %.1f, \"ns_per_digit\": %.4f, \"digits_per_sec\": %.1f, \"peak_kb\": %ld}%s\n",
+                r->kind, r->op, r->signs, r->size1, r->size2, r->reps, r->ns_per_op, r->ns_per_digit,
+                r->digits_per_sec, r->peak_kb, (i + 1 < result_count) ? "," : "");
+    }
+    fprintf(fp, "]\n");
+    fclose(fp);
+}
+
+/* Load a CSV written by write_csv() into `out`; returns number of rows or FAILURE */
+static int read_csv(const char *path, bench_result *out, int max)
+{
+    FILE *fp = fopen(path, "r");
+    if(fp == NULL)
+    {
+        fprintf(stderr, "ERROR : Cannot open %s\n", path);
+        return FAILURE;
+    }
+
+    char line[MAX_LINE];
+    int count = 0;
+    while(fgets(line, sizeof(line), fp) && count < max)
+    {
+        bench_result *r = &out[count];
+        if(sscanf(line, "%7[^,],%7[^,],%3[^,],%ld,%ld,%ld,%lf,%lf,%lf,%ld", r->kind, r->op, r->signs, &r->size1,
+                  &r->size2, &r->reps, &r->ns_per_op, &r->ns_per_digit, &r->digits_per_sec, &r->peak_kb) == 10)
+        {
+            count++;    // header line does not parse and is skipped
+        }
+    }
+    fclose(fp);
+    return count;
+}
+
+/* Compare two result files; returns the number of regressions above threshold percent, base cases missing from the
+ * new file included */
+static int compare_results(const char *base_path, const char *new_path, double threshold)
+{
+    static bench_result base[MAX_RESULTS], current[MAX_RESULTS];
+    int nbase = read_csv(base_path, base, MAX_RESULTS);
+    int ncurrent = read_csv(new_path, current, MAX_RESULTS);
+    if(nbase == FAILURE || ncurrent == FAILURE)
+    {
+        return FAILURE;
+    }
+
+    int regressions = 0;
+    printf("%-5s %-2s %-5s %9s x %-9s %14s %14s %9s\n", "kind", "op", "signs", "size1", "size2", "base ns/op", "new ns/op", "change");
+    for(int j = 0; j < nbase; j++)
+    {
+        bench_result *b = &base[j], *c = NULL;
+        for(int i = 0; i < ncurrent && c == NULL; i++)
+        {
+            if(!strcmp(b->kind, current[i].kind) && !strcmp(b->op, current[i].op) && !strcmp(b->signs, current[i].signs) &&
+               b->size1 == current[i].size1 && b->size2 == current[i].size2)
+            {
+                c = &current[i];
+            }
+        }
+
+        // A case the new run no longer reaches is a regression too
+        if(c == NULL)
+        {
+            regressions++;
+            printf("%-5s %-2s %-5s %9ld x %-9ld %14.0f %14s %9s  MISSING\n", b->kind, b->op, b->signs, b->size1,
+                   b->size2, b->ns_per_op, "-", "-");
+            continue;
+        }
+
+        double change = (c->ns_per_op - b->ns_per_op) * 100.0 / b->ns_per_op;
+        int regressed = change > threshold;
+        regressions += regressed;
+        printf("%-5s %-2s %-5s %9ld x %-9ld %14.0f %14.0f %+8.1f%%%s\n", c->kind, c->op, c->signs, c->size1,
+               c->size2, b->ns_per_op, c->ns_per_op, change, regressed ? "  REGRESSION" : "");
+    }
+    printf("%d regression(s) above %.1f%% or missing\n", regressions, threshold);
+    return regressions;
+}
+
+int main(int argc, char *argv[])
+{
+    long max_digits = 10000000;
+    double min_time = 0.2, budget = 2.0, threshold = 5.0;
+    unsigned seed = 12345;
+    const char *csv_path = NULL, *json_path = NULL, *base_path = NULL, *new_path = NULL;
+
+    for(int i = 1; i < argc; i++)
+    {
+        if(strcmp(argv[i], "--max-digits") == 0 && i + 1 < argc)
+            max_digits = atol(argv[++i]);
+        else if(strcmp(argv[i], "--min-time") == 0 && i + 1 < argc)
+            min_time = atof(argv[++i]);
+        else if(strcmp(argv[i], "--budget") == 0 && i + 1 < argc)
+            budget = atof(argv[++i]);
+        else if(strcmp(argv[i], "--seed") == 0 && i + 1 < argc)
+            seed = atoi(argv[++i]);
+        else if(strcmp(argv[i], "--csv") == 0 && i + 1 < argc)
+            csv_path = argv[++i];
+        else if(strcmp(argv[i], "--json") == 0 && i + 1 < argc)
+            json_path = argv[++i];
+        else if(strcmp(argv[i], "--threshold") == 0 && i + 1 < argc)
+            threshold = atof(argv[++i]);
+        else if(strcmp(argv[i], "--compare") == 0 && i + 2 < argc)
+        {
+            base_path = argv[++i];
+            new_path = argv[++i];
+        }
+        else
+        {
+            fprintf(stderr, "USAGE : %s [--max-digits N] [--min-time S] [--budget S] [--seed N] [--csv FILE] [--json FILE]\n", argv[0]);
+            fprintf(stderr, "        %s --compare <base.csv> <new.csv> [--threshold PERCENT]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    if(base_path)
+    {
+        int regressions = compare_results(base_path, new_path, threshold);
+        return (regressions == 0) ? 0 : 1;
+    }
+
+    // Results printed by perform_operation() are not part of the report
+    if(freopen("/dev/null", "w", stdout) == NULL)
+    {
+        fprintf(stderr, "ERROR : Cannot discard stdout\n");
+        return 1;
+    }
+    srand(seed);
+
+    for(size_t k = 0; k < sizeof(operators) / sizeof(operators[0]); k++)
+    {
+        const bench_op *op = &operators[k];
+
+        for(long n = 10; n <= max_digits; n *= 10)
+        {
+            long shapes[2] = { n, (n / 10 > 0) ? n / 10 : 1 };
+            int nshapes = op->unary ? 1 : 2;
+            double slowest = 0;
+            int failed = 0;
+
+            for(int s = 0; s < nshapes; s++)
+            {
+                char *digits1 = random_digits(n);
+                char *digits2 = random_digits(shapes[s]);
+                if(digits1 == NULL || digits2 == NULL)
+                {
+                    fprintf(stderr, "ERROR : Out of memory generating %ld digits\n", n);
+                    free(digits1);
+                    free(digits2);
+                    failed = 1;
+                    break;
+                }
+
+                double t = run_case(op, "micro", "++", digits1, n, digits2, shapes[s], min_time);
+                if(t < 0)
+                    failed = 1;
+                else if(t > slowest)
+                    slowest = t;
+
+                // Full operation path for every sign combination (the magnitude kernel above ignores signs)
+                for(size_t p = 0; !failed && p < sizeof(sign_pairs) / sizeof(sign_pairs[0]); p++)
+                {
+                    t = run_case(op, "macro", sign_pairs[p], digits1, n, digits2, shapes[s], min_time);
+                    if(t < 0)
+                        failed = 1;
+                    else if(t > slowest)
+                        slowest = t;
+                }
+
+                free(digits1);
+                free(digits2);
+                if(failed)
+                    break;
+            }
+
+            if(failed)
+            {
+                fprintf(stderr, "%-5s %-2s stopping at %ld digits (operation failed)\n", "", op->symbol, n);
+                break;
+            }
+            if(slowest > budget * 1e9)
+            {
+                fprintf(stderr, "%-5s %-2s stopping at %ld digits (over %.1f s budget)\n", "", op->symbol, n, budget);
+                break;
+            }
+        }
+    }
+
+    if(csv_path)
+        write_csv(csv_path);
+    if(json_path)
+        write_json(json_path);
+    if(!csv_path && !json_path)
+        write_csv("/dev/stderr");
+    return 0;
+}
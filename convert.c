@@ -0,0 +1,215 @@
+/*******************************************************************************************************************************************************************
+ * Parallel decimal conversion
+ * ---------------------------
+ *  For numbers of millions of digits, reading the operands and writing the result are the longest phases of a
+ *  run: one node (and one malloc) per digit in, one character per digit out. Both are split into chunks
+ *  converted by one thread each, every chunk writing only its own region of the output:
+ *
+ *     digits_to_list     : each thread checks and links the nodes of one chunk of the string; the chunk lists
+ *                          are then joined end to end (string_to_list)
+ *     limbs_from_string  : each thread packs the digits of one range of limbs
+ *     limbs_print_result : each thread writes the characters of one range of limbs into one buffer, which goes
+ *                          out with a single fwrite
+ *     limbs_to_list      : the characters as above, then digits_to_list (limbs.c)
+ *     print_list         : a digit list can only be walked from one end, so one walk records the node each
+ *                          grain starts at; the threads then write their chunks into one buffer, which goes
+ *                          out with a single fwrite (helper.c)
+ *
+ *  Decimal digits and base 10^9 limbs are both powers of ten, so no chunk depends on another: there is no
+ *  divide-and-conquer radix tree to walk, and joining the chunks costs one step per thread.
+ *
+ *  Threads: one per CPU, at most one per started grain of items (CONVERT_GRAIN for conversions), so a single
+ *  chunk (this thread) up to one grain. Work that allocates stays on one thread when the thread uses a node
+ *  arena (--serve). Memory allocated by helper threads is charged to the caller's operation (memory_charge),
+ *  so --op-memory-limit and the peaks still see it, and so are their --profile allocation counters
+ *  (profile_charge): profiled runs convert on as many threads as unprofiled ones.
+ *  --aggregate sum and product run their shares of the values through the same runner (aggregate.c).
+ *
+ *  Returns:
+ *     SUCCESS (0), or FAILURE (-1) on an invalid character or a memory allocation failure
+*******************************************************************************************************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <unistd.h>
+#include <pthread.h>
+#include "apc.h"
+
+/* CPUs the conversions split over; make check builds with a fixed count to exercise the chunking on any host */
+#ifndef CONVERT_CPUS
+#define CONVERT_CPUS sysconf(_SC_NPROCESSORS_ONLN)
+#endif
+
+/* One chunk [begin, end) of a conversion and the thread running it */
+typedef struct
+{
+	convert_work work;
+	void *arg;
+	int chunk;
+	long begin, end;
+	long long used;         // bytes the helper thread left allocated, charged to the caller
+	ProfileCounts counts;   // its --profile allocation counters, charged likewise
+	pthread_t thread;
+	int started;            // 1 while `thread` has to be joined
+}Chunk;
+
+/* Work of a parse: each chunk builds its own list */
+typedef struct
+{
+	const char *digits;
+	Dlist *head[CONVERT_MAX_THREADS], *tail[CONVERT_MAX_THREADS];
+	long bad[CONVERT_MAX_THREADS];      // first character that is not a digit, -1 if none
+	int status[CONVERT_MAX_THREADS];
+}ParseJob;
+
+static void *chunk_thread(void *arg)
+{
+	Chunk *c = arg;
+	c->work(c->arg, c->chunk, c->begin, c->end);
+	c->used = memory_operation_used();
+	c->counts = profile_thread_counts();
+	return NULL;
+}
+
+int convert_threads(long size, long grain, int allocates)
+{
+	if(allocates && arena_active())
+	{
+		return 1;
+	}
+	long cpus = CONVERT_CPUS;
+	long threads = (size + grain - 1) / grain;
+	if(threads > cpus)
+		threads = cpus;
+	if(threads > CONVERT_MAX_THREADS)
+		threads = CONVERT_MAX_THREADS;
+	return (threads > 1) ? (int)threads : 1;
+}
+
+void convert_run(long size, long grain, int threads, convert_work work, void *arg)
+{
+	Chunk chunks[CONVERT_MAX_THREADS];
+	long grains = (size + grain - 1) / grain;
+
+	PROFILE_THREADS(threads);
+	for(int t = 0; t < threads; t++)
+	{
+		long end = grains * (t + 1) / threads * grain;
+		chunks[t].work = work;
+		chunks[t].arg = arg;
+		chunks[t].chunk = t;
+		chunks[t].begin = grains * t / threads * grain;
+		chunks[t].end = (end < size) ? end : size;
+		chunks[t].used = 0;
+		chunks[t].started = 0;
+	}
+	// The first chunk runs on this thread; a chunk whose thread cannot start runs here too
+	for(int t = 1; t < threads; t++)
+	{
+		chunks[t].started = (pthread_create(&chunks[t].thread, NULL, chunk_thread, &chunks[t]) == 0);
+		if(!chunks[t].started)
+			work(arg, t, chunks[t].begin, chunks[t].end);
+	}
+	work(arg, 0, chunks[0].begin, chunks[0].end);
+	for(int t = 1; t < threads; t++)
+	{
+		if(chunks[t].started)
+		{
+			pthread_join(chunks[t].thread, NULL);
+			memory_charge(chunks[t].used);
+			if(apc_profile_enabled)
+				profile_charge(&chunks[t].counts);
+		}
+	}
+}
+
+static void parse_chunk(void *arg, int chunk, long begin, long end)
+{
+	ParseJob *job = arg;
+	job->head[chunk] = job->tail[chunk] = NULL;
+	job->bad[chunk] = -1;
+	job->status[chunk] = SUCCESS;
+	for(long i = begin; i < end; i++)
+	{
+		if(!isdigit((unsigned char)job->digits[i]))
+		{
+			job->bad[chunk] = i;
+			return;
+		}
+		if(insert_at_end(&job->head[chunk], &job->tail[chunk], job->digits[i] - '0') == FAILURE)
+		{
+			job->status[chunk] = FAILURE;
+			return;
+		}
+	}
+}
+
+/*****************************************************************************************
+ * Function: digits_to_list
+ * ------------------------
+ * Appends the digits[0 .. length) to the list, one node per digit, in chunks built in
+ * parallel. On an invalid character or a failed allocation the whole list is deleted.
+ *****************************************************************************************/
+
+int digits_to_list(const char *digits, long length, Dlist **head, Dlist **tail)
+{
+	int threads = convert_threads(length, CONVERT_GRAIN, 1);
+	if(threads > 1 && memory_admit(length * sizeof(Dlist)) == FAILURE)
+	{
+		delete_list(head, tail);
+		return FAILURE;
+	}
+
+	ParseJob *job = apc_malloc(sizeof(ParseJob));
+	if(job == NULL)
+	{
+		apc_printf("ERROR : Node creation failed.\n");
+		delete_list(head, tail);
+		return FAILURE;
+	}
+	job->digits = digits;
+	convert_run(length, CONVERT_GRAIN, threads, parse_chunk, job);
+
+	// The first failure in digit order is the one reported
+	int status = SUCCESS;
+	for(int t = 0; t < threads && status == SUCCESS; t++)
+	{
+		if(job->bad[t] >= 0)
+		{
+			apc_printf("ERROR : Invalid character '%c'\n", digits[job->bad[t]]);
+			status = FAILURE;
+		}
+		else if(job->status[t] == FAILURE)
+		{
+			apc_printf("ERROR : Node creation failed.\n");
+			status = FAILURE;
+		}
+	}
+
+	for(int t = 0; t < threads; t++)
+	{
+		if(status == FAILURE || job->head[t] == NULL)
+		{
+			delete_list(&job->head[t], &job->tail[t]);
+			continue;
+		}
+		if(*head == NULL)
+		{
+			*head = job->head[t];
+		}
+		else
+		{
+			(*tail)->next = job->head[t];
+			job->head[t]->prev = *tail;
+		}
+		*tail = job->tail[t];
+	}
+	if(status == FAILURE)
+	{
+		delete_list(head, tail);
+	}
+	apc_free(job);
+	return status;
+}
@@ -0,0 +1,439 @@
+/*******************************************************************************************************************************************************************
+ * Decimal (fixed-point) numbers
+ * -----------------------------
+ *  A Decimal is a signed scaled integer: value = coefficient × 10^-scale, where the coefficient is an ordinary
+ *  digit list and `scale` is the number of fractional digits. All arithmetic runs on the integer kernels:
+ *
+ *     +  -  : operands are aligned to the larger scale (zeros appended), then added / subtracted exactly
+ *     *  ^  : coefficients are multiplied, scales add up (exact)
+ *     /     : the dividend is scaled so that the integer quotient has exactly `precision` fractional digits,
+ *             and the remainder decides the last digit according to the rounding mode
+ *
+ *  Rounding modes: half-even (default), half-up, half-down, down (toward zero), up (away from zero),
+ *  ceiling (toward +inf), floor (toward -inf).
+ *
+ *  CLI:  ./a.out [--precision N] [--rounding MODE] <num1> <operator> <num2>
+ *        Decimal mode is used when an operand contains '.' or --precision is given. Division keeps N
+ *        fractional digits (default DECIMAL_DEFAULT_PRECISION); with --precision every result is rounded
+ *        to exactly N fractional digits.
+*******************************************************************************************************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include "apc.h"
+
+static const char *rounding_names[] = { "half-even", "half-up", "half-down", "down", "up", "ceiling", "floor" };
+
+/* Rounding mode for a name, or FAILURE if unknown */
+int rounding_mode(const char *name)
+{
+	for(int i = 0; i < (int)(sizeof(rounding_names) / sizeof(rounding_names[0])); i++)
+	{
+		if(strcmp(name, rounding_names[i]) == 0)
+		{
+			return i;
+		}
+	}
+	return FAILURE;
+}
+
+/* Does the string contain a decimal point? */
+int is_decimal(const char *s)
+{
+	return strchr(s, '.') != NULL;
+}
+
+/* coefficient × 10^count */
+static int append_zeros(Dlist **head, Dlist **tail, int count)
+{
+	for(int i = 0; i < count; i++)
+	{
+		if(insert_at_end(head, tail, 0) == FAILURE)
+		{
+			return FAILURE;
+		}
+	}
+	return SUCCESS;
+}
+
+/* Store a kernel result list as the coefficient of r */
+static void set_coefficient(Decimal *r, Dlist *head, char sign, int scale)
+{
+	remove_leading_zeros(&head);
+	r->head = head;
+	r->tail = list_tail(head);
+	r->scale = scale;
+	r->sign = (result_is_zero(head) == SUCCESS) ? '+' : sign;
+}
+
+/* =========================================================================================
+ * Function: string_to_decimal
+ * -----------------------------------------------------------------------------------------
+ *  Parses [+|-]digits[.digits] into a Decimal ("5." and ".5" are accepted).
+ *  Returns SUCCESS, or FAILURE on an invalid string or allocation failure.
+ * ========================================================================================= */
+
+int string_to_decimal(const char *str, Decimal *d)
+{
+	const char *digits;
+	d->sign = remove_sign(str, &digits);
+	d->head = d->tail = NULL;
+	d->scale = 0;
+
+	int seen_point = 0, seen_digit = 0;
+	for(const char *p = digits; *p; p++)
+	{
+		if(*p == '.' && !seen_point)
+		{
+			seen_point = 1;
+			continue;
+		}
+		if(!isdigit((unsigned char)*p))
+		{
+			apc_printf("ERROR : Invalid character '%c'\n", *p);
+			decimal_free(d);
+			return FAILURE;
+		}
+		if(insert_at_end(&d->head, &d->tail, *p - '0') == FAILURE)
+		{
+			apc_printf("ERROR : Node creation failed.\n");
+			decimal_free(d);
+			return FAILURE;
+		}
+		seen_digit = 1;
+		d->scale += seen_point;
+	}
+
+	if(!seen_digit)
+	{
+		apc_printf("ERROR : Empty string input.\n");
+		return FAILURE;
+	}
+	set_coefficient(d, d->head, d->sign, d->scale);
+	return SUCCESS;
+}
+
+void decimal_free(Decimal *d)
+{
+	delete_list(&d->head, &d->tail);
+}
+
+/* Print sign, integer part, '.', and exactly `scale` fractional digits */
+void print_decimal(const Decimal *d)
+{
+	int length = find_length(d->head);
+	Dlist *p = d->head;
+
+	// Zero carries no sign, like integer results
+	if(result_is_zero(d->head) == SUCCESS)
+	{
+		apc_printf("0%s", (d->scale > 0) ? "." : "");
+		for(int i = 0; i < d->scale; i++)
+		{
+			apc_printf("0");
+		}
+		apc_printf("\n");
+		return;
+	}
+
+	// Integer part
+	apc_printf("%c", d->sign);
+	if(length <= d->scale)
+	{
+		apc_printf("0");
+	}
+	for(int i = length; i > d->scale; i--, p = p->next)
+	{
+		apc_printf("%d", p->data);
+	}
+
+	// Fractional part, padded with zeros up to the first coefficient digit
+	if(d->scale > 0)
+	{
+		apc_printf(".");
+		for(int i = d->scale; i > length; i--)
+		{
+			apc_printf("0");
+		}
+		for(; p; p = p->next)
+		{
+			apc_printf("%d", p->data);
+		}
+	}
+	apc_printf("\n");
+}
+
+/*
+ * Whether the magnitude q (with remainder rem of divisor den) must be incremented by one
+ * unit in the last place under `mode`. negative is the sign of the exact result.
+ */
+static int rounding_increment(Dlist *q, Dlist *rem, Dlist *den, int negative, int mode)
+{
+	if(result_is_zero(rem) == SUCCESS)
+	{
+		return 0;       // exact
+	}
+
+	switch(mode)
+	{
+		case ROUND_DOWN:
+			return 0;
+		case ROUND_UP:
+			return 1;
+		case ROUND_CEILING:
+			return !negative;
+		case ROUND_FLOOR:
+			return negative;
+	}
+
+	// Half modes: compare 2·rem with den
+	Dlist *twice = NULL, *rem_tail = list_tail(rem);
+	Dlist *rem2 = rem, *rem2_tail = rem_tail;
+	if(addition(&rem, &rem_tail, &rem2, &rem2_tail, &twice) == FAILURE)
+	{
+		return 0;
+	}
+	remove_leading_zeros(&twice);
+	int compare = compare_numbers(twice, den);
+	Dlist *twice_tail = list_tail(twice);
+	delete_list(&twice, &twice_tail);
+
+	if(compare != EQUAL)
+	{
+		return compare == GREATER;
+	}
+	if(mode == ROUND_HALF_UP)
+	{
+		return 1;
+	}
+	if(mode == ROUND_HALF_DOWN)
+	{
+		return 0;
+	}
+	return list_tail(q)->data % 2;      // half-even: round to the even neighbour
+}
+
+/* q = q + 1 in place */
+static int increment(Dlist **head, Dlist **tail)
+{
+	Dlist *p = *tail;
+	while(p && p->data == 9)
+	{
+		p->data = 0;
+		p = p->prev;
+	}
+	if(p)
+	{
+		p->data++;
+		return SUCCESS;
+	}
+	return insert_at_begin(head, tail, 1);
+}
+
+/*
+ * |num| / |den| rounded to an integer with `mode` and stored in r with the given sign and scale.
+ * num and den are not modified.
+ */
+static int divide_rounded(Dlist *num, Dlist *den, char sign, int scale, int mode, Decimal *r)
+{
+	Dlist *q = NULL, *rem = NULL;
+	if(divmod_schoolbook(num, den, &q, &rem) == FAILURE)
+	{
+		return FAILURE;
+	}
+
+	Dlist *q_tail = list_tail(q), *rem_tail = list_tail(rem);
+	int status = SUCCESS;
+	if(rounding_increment(q, rem, den, sign == '-', mode))
+	{
+		status = increment(&q, &q_tail);
+	}
+	delete_list(&rem, &rem_tail);
+
+	set_coefficient(r, q, sign, scale);
+	return status;
+}
+
+/* =========================================================================================
+ * Function: decimal_round
+ * -----------------------------------------------------------------------------------------
+ *  Rescales d in place to exactly `scale` fractional digits: zeros are appended when the
+ *  scale grows, otherwise the dropped digits are rounded away with `mode`.
+ * ========================================================================================= */
+
+int decimal_round(Decimal *d, int scale, int mode)
+{
+	if(d->scale <= scale)
+	{
+		// A zero coefficient stays a single 0 node so comparisons by length remain valid
+		int zero = (result_is_zero(d->head) == SUCCESS);
+		int status = zero ? SUCCESS : append_zeros(&d->head, &d->tail, scale - d->scale);
+		d->scale = scale;
+		return status;
+	}
+
+	// den = 10^(dropped digits)
+	Dlist *den = NULL, *den_tail = NULL;
+	if(insert_at_end(&den, &den_tail, 1) == FAILURE || append_zeros(&den, &den_tail, d->scale - scale) == FAILURE)
+	{
+		delete_list(&den, &den_tail);
+		return FAILURE;
+	}
+
+	Decimal r;
+	int status = divide_rounded(d->head, den, d->sign, scale, mode, &r);
+	delete_list(&den, &den_tail);
+	if(status == SUCCESS)
+	{
+		decimal_free(d);
+		*d = r;
+	}
+	return status;
+}
+
+/* Bring both operands to the larger scale */
+static int decimal_align(Decimal *a, Decimal *b)
+{
+	if(a->scale < b->scale)
+	{
+		return decimal_round(a, b->scale, ROUND_DOWN);
+	}
+	return decimal_round(b, a->scale, ROUND_DOWN);
+}
+
+/* =========================================================================================
+ * Function: decimal_add
+ * -----------------------------------------------------------------------------------------
+ *  r = a + b (or a - b when subtract is set), exact. a and b are consumed (their lists are
+ *  reused or modified by the kernels) and must not be used afterwards except to free them.
+ * ========================================================================================= */
+
+int decimal_add(Decimal *a, Decimal *b, Decimal *r, int subtract)
+{
+	if(decimal_align(a, b) == FAILURE)
+	{
+		return FAILURE;
+	}
+
+	char sign_b = b->sign;
+	if(subtract)
+	{
+		sign_b = (sign_b == '+') ? '-' : '+';
+	}
+
+	Dlist *headR = NULL;
+	char sign = a->sign;
+	int status;
+
+	if(a->sign == sign_b)
+	{
+		status = addition(&a->head, &a->tail, &b->head, &b->tail, &headR);
+	}
+	else
+	{
+		int compare = compare_numbers(a->head, b->head);
+		if(compare == EQUAL)
+		{
+			Dlist *zero_tail = NULL;
+			status = insert_at_end(&headR, &zero_tail, 0);
+		}
+		else
+		{
+			sign = (compare == GREATER) ? a->sign : sign_b;
+			status = subtraction(&a->head, &a->tail, &b->head, &b->tail, &headR);
+		}
+	}
+
+	set_coefficient(r, headR, sign, a->scale);
+	return status;
+}
+
+/* r = a × b, exact (scales add up) */
+int decimal_mul(Decimal *a, Decimal *b, Decimal *r)
+{
+	Dlist *headR = NULL;
+	int status = multiplication(&a->head, &a->tail, &b->head, &b->tail, &headR);
+	set_coefficient(r, headR, (a->sign == b->sign) ? '+' : '-', a->scale + b->scale);
+	return status;
+}
+
+/* =========================================================================================
+ * Function: decimal_div
+ * -----------------------------------------------------------------------------------------
+ *  r = a / b with exactly `precision` fractional digits, the last one rounded with `mode`.
+ *
+ *  a / b · 10^precision = ca · 10^(sb - sa + precision) / cb, so the dividend (or, when the
+ *  exponent is negative, the divisor) is extended with zeros before one integer division.
+ *  Returns FAILURE on division by zero.
+ * ========================================================================================= */
+
+int decimal_div(Decimal *a, Decimal *b, Decimal *r, int precision, int mode)
+{
+	if(result_is_zero(b->head) == SUCCESS)
+	{
+		apc_printf("ERROR : Division by zero! \n");
+		return FAILURE;
+	}
+
+	int exponent = b->scale - a->scale + precision;
+	int status = (exponent >= 0) ? append_zeros(&a->head, &a->tail, exponent)
+	                             : append_zeros(&b->head, &b->tail, -exponent);
+	if(status == FAILURE)
+	{
+		return FAILURE;
+	}
+	return divide_rounded(a->head, b->head, (a->sign == b->sign) ? '+' : '-', precision, mode, r);
+}
+
+/********************************************************************************************************************************************************************
+ * Function: perform_decimal_operation
+ * -----------------------------------
+ *  Decimal counterpart of perform_operation(): + - * / ^ on two Decimals, prints the result.
+ *  precision : fractional digits of a quotient
+ *  fixed     : if set, every result is rounded to exactly `precision` fractional digits
+ *  mode      : rounding mode (ROUND_*)
+*******************************************************************************************************************************************************************/
+
+int perform_decimal_operation(const char *op, Decimal *a, Decimal *b, int precision, int fixed, int mode)
+{
+	Decimal r = { '+', NULL, NULL, 0 };
+	int status;
+
+	if(strcmp(op, "+") == 0 || strcmp(op, "-") == 0)
+	{
+		status = decimal_add(a, b, &r, strcmp(op, "-") == 0);
+	}
+	else if(strcmp(op, "*") == 0)
+	{
+		status = decimal_mul(a, b, &r);
+	}
+	else if(strcmp(op, "^") == 0)
+	{
+		Dlist *headR = NULL;
+		status = square(&a->head, &a->tail, &headR);
+		set_coefficient(&r, headR, '+', 2 * a->scale);
+	}
+	else if(strcmp(op, "/") == 0)
+	{
+		status = decimal_div(a, b, &r, precision, mode);
+	}
+	else
+	{
+		apc_printf("ERROR : Operator %s is not supported for decimal operands [+,-,*,/,^] \n", op);
+		return FAILURE;
+	}
+
+	if(status == SUCCESS && fixed)
+	{
+		status = decimal_round(&r, precision, mode);
+	}
+	if(status == SUCCESS)
+	{
+		apc_printf("Result          : ");
+		print_decimal(&r);
+	}
+	decimal_free(&r);
+	return status;
+}
@@ -5,6 +5,11 @@
 *
 * Prototype        : int division(Dlist **head1, Dlist **tail1, Dlist **head2, Dlist **tail2, Dlist **headR);
 *
+*                    division() picks a kernel from the registry by divisor length:
+*                        div_subtract  : long division, each quotient digit found by repeated list subtraction
+*                        div_schoolbook: long division on digit arrays, each quotient digit estimated from the
+*                                        leading digits and corrected by at most a few add-backs
+*
 * Input Parameters : 
 *     head1  : Pointer to the first node of the dividend (numerator)
 *     tail1  : Pointer to the last node of the dividend
@@ -21,6 +26,7 @@
 *******************************************************************************************************************************************************************/
 #include <stdio.h>      
 #include <stdlib.h>
+#include <string.h>
 #include "apc.h"
 
 int division(Dlist **head1, Dlist **tail1, Dlist **head2, Dlist **tail2, Dlist **headR)
@@ -28,79 +34,247 @@ int division(Dlist **head1, Dlist **tail1, Dlist **head2, Dlist **tail2, Dlist *
 	// Validate input lists
 	if(*head1 == NULL || *head2 == NULL)
 	{
-		printf("ERROR : One or Both input Lists are Empty! \n");
+		apc_printf("ERROR : One or Both input Lists are Empty! \n");
 		return FAILURE;
 	}
 
-	// Remove meaningless leading zeros like 000123 → 123
-	remove_leading_zeros(head1);
-	remove_leading_zeros(head2);
+	const kernel_t *kernel = select_kernel("div", find_length(*head2));
+	return kernel->binary(head1, tail1, head2, tail2, headR);
+}
 
-	// Compare magnitudes of dividend and divisor
-	int compare = compare_numbers(*head1, *head2);
+/*****************************************************************************************
+ * Function: divmod_subtract
+ * -------------------------
+ * Quotient and/or remainder by long division with repeated subtraction (either result
+ * pointer may be NULL). The running remainder is a window of len(divisor) + 1 nodes that
+ * is never re-allocated: bringing a digit down recycles the top node (always zero, since
+ * the remainder is below the divisor) as the new units digit, and the divisor is
+ * subtracted in place, so no node is freed or allocated and no tail is searched inside
+ * the loop. The leading zeros this leaves in the window are skipped by compare_numbers()
+ * and removed once at the end. The quotient is built without leading zeros.
+ *****************************************************************************************/
 
-	if(compare == LESS)
+int divmod_subtract(Dlist *head1, Dlist *head2, Dlist *tail2, Dlist **headQ, Dlist **headRem)
+{
+	Dlist *divisor = skip_leading_zeros(head2);
+	if(divisor->data == 0)
 	{
-		// If dividend < divisor → quotient is 0
-		insert_at_end(headR, tail1, 0);
-		return SUCCESS;
+		apc_printf("ERROR : Division by zero! \n");
+		return FAILURE;
 	}
-	else if (compare == EQUAL)
-    {
-        // If numbers are equal → quotient is 1
-        insert_at_end(headR, tail1, 1);
-        return SUCCESS;
-    }
 
-	// Temporary remainder list (what we keep subtracting divisor from)
-	Dlist *rem_head = NULL;
-	Dlist *rem_tail = NULL;
-	// Quotient list (final answer)
-	Dlist *quot_head = NULL;
-	Dlist *quot_tail = NULL;
-	// Iterate digit by digit from the dividend (left to right)
-	Dlist *digit = *head1;
+	// Remainder window, all zeros
+	Dlist *rem_head = NULL, *rem_tail = NULL;
+	Dlist *quot_head = NULL, *quot_tail = NULL;
+	int window = find_length(divisor) + 1;
+	for(int i = 0; i < window; i++)
+	{
+		if(insert_at_end(&rem_head, &rem_tail, 0) == FAILURE)
+		{
+			delete_list(&rem_head, &rem_tail);
+			return FAILURE;
+		}
+	}
 
-	while(digit)
+	// Iterate digit by digit from the dividend (left to right)
+	for(Dlist *digit = skip_leading_zeros(head1); digit; digit = digit->next)
 	{
-		// Bring current digit into the remainder buffer
-		insert_at_end(&rem_head, &rem_tail, digit->data);
-		// Remove leading zeros after adding new digit
-		remove_leading_zeros(&rem_head);
+		// Bring the current digit down into the recycled top node
+		Dlist *node = rem_head;
+		rem_head = node->next;
+		rem_head->prev = NULL;
+		node->prev = rem_tail;
+		node->next = NULL;
+		rem_tail->next = node;
+		rem_tail = node;
+		node->data = digit->data;
 
-		// This will store how many times divisor fits in remainder
+		// While remainder >= divisor, remainder -= divisor
 		int count = 0;
+		while(compare_numbers(rem_head, divisor) != LESS)
+		{
+			subtract_in_place(rem_tail, tail2);
+			count++;
+		}
 
-		// While remainder >= divisor
-		while (compare_numbers(rem_head, *head2) != LESS)
+		// Append this quotient digit, starting from the first non-zero one
+		if(headQ && (quot_head || count) && insert_at_end(&quot_head, &quot_tail, count) == FAILURE)
 		{
-			Dlist *new_rem = NULL;
-			// Perform remainder = remainder - divisor
-			subtraction(&rem_head, &rem_tail, head2, tail2, &new_rem);
-			// Free old remainder and update to the new one
+			delete_list(&quot_head, &quot_tail);
 			delete_list(&rem_head, &rem_tail);
-			rem_head = new_rem;
-			rem_tail = rem_head;	// Move rem_tail to the last node of updated remainder
+			return FAILURE;
+		}
+	}
+
+	if(headQ)
+	{
+		if(quot_head == NULL && insert_at_end(&quot_head, &quot_tail, 0) == FAILURE)
+		{
+			delete_list(&rem_head, &rem_tail);
+			return FAILURE;
+		}
+		*headQ = quot_head;
+	}
+	if(headRem)
+	{
+		remove_leading_zeros(&rem_head);
+		*headRem = rem_head;
+	}
+	else
+	{
+		delete_list(&rem_head, &rem_tail);
+	}
+	return SUCCESS;
+}
+
+int div_subtract(Dlist **head1, Dlist **tail1, Dlist **head2, Dlist **tail2, Dlist **headR)
+{
+	// Validate input lists
+	if(*head1 == NULL || *head2 == NULL)
+	{
+		apc_printf("ERROR : One or Both input Lists are Empty! \n");
+		return FAILURE;
+	}
+	return divmod_subtract(*head1, *head2, *tail2, headR, NULL);
+}
+
 
-			while(rem_tail && rem_tail->next)
+/*******************************************************************************************************************************************************************
+* Title            : divmod_digits
+* Description      : Schoolbook long division on digit arrays (least significant digit first).
+*                    For every dividend digit the running remainder is shifted in, the quotient digit is
+*                    estimated from the top three remainder digits over the top two divisor digits, q·divisor
+*                    is subtracted in one borrow pass and the divisor is added back while the result is negative.
+*
+* Input Parameters :
+*     num, n   : dividend digits and count
+*     den, m   : divisor digits and count (den[m-1] must be non-zero)
+*     quot     : receives n quotient digits (may be NULL)
+*     rem      : receives m + 1 remainder digits (may be NULL)
+*
+* Output           : Status (SUCCESS / FAILURE on allocation failure)
+*******************************************************************************************************************************************************************/
+
+int divmod_digits(const data_t *num, int n, const data_t *den, int m, data_t *quot, data_t *rem)
+{
+	data_t *r = apc_calloc(m + 1, sizeof(data_t));
+	if(r == NULL)
+	{
+		return FAILURE;
+	}
+
+	int dtop = den[m - 1] * 10 + ((m >= 2) ? den[m - 2] : 0);
+
+	for(int i = n - 1; i >= 0; i--)
+	{
+		// remainder = remainder * 10 + next dividend digit
+		memmove(r + 1, r, m * sizeof(data_t));
+		r[0] = num[i];
+
+		// Estimate never falls below the true quotient digit
+		int top = r[m] * 100 + r[m - 1] * 10 + ((m >= 2) ? r[m - 2] : 0);
+		int q = (top + 1) / dtop;
+		if(q > 9)
+		{
+			q = 9;
+		}
+
+		// remainder -= q * divisor
+		int borrow = 0;
+		for(int j = 0; q && j <= m; j++)
+		{
+			int v = r[j] - q * ((j < m) ? den[j] : 0) - borrow;
+			borrow = 0;
+			if(v < 0)
 			{
-				rem_tail = rem_tail->next;
+				borrow = (-v + 9) / 10;
+				v += borrow * 10;
 			}
-			count++;	// Increase quotient digit count
+			r[j] = v;
 		}
 
-		// Append this quotient digit to quotient list
-		insert_at_end(&quot_head, &quot_tail, count);
-		// Move to next dividend digit (long division style)
-		digit = digit->next;
+		// Over-estimated: add the divisor back until the remainder is non-negative
+		while(borrow)
+		{
+			int carry = 0;
+			q--;
+			for(int j = 0; j <= m; j++)
+			{
+				int v = r[j] + ((j < m) ? den[j] : 0) + carry;
+				carry = v / 10;
+				r[j] = v % 10;
+			}
+			borrow -= carry;
+		}
+
+		if(quot)
+		{
+			quot[i] = q;
+		}
 	}
-	// Remove extra zeros at the front of the quotient
-	remove_leading_zeros(&quot_head);
-	// Store final quotient in result pointer
-	*headR = quot_head;
+
+	if(rem)
+	{
+		memcpy(rem, r, (m + 1) * sizeof(data_t));
+	}
+	apc_free(r);
 	return SUCCESS;
 }
 
+/* Divide two lists with divmod_digits(); stores the quotient or the remainder in headR */
+int divmod_schoolbook(Dlist *head1, Dlist *head2, Dlist **headQ, Dlist **headRem)
+{
+	data_t *num = NULL, *den = NULL, *quot = NULL, *rem = NULL;
+	int n, m, status = FAILURE;
+	Dlist *tail = NULL;
 
+	if(list_to_array(head1, &num, &n) == FAILURE || list_to_array(head2, &den, &m) == FAILURE)
+	{
+		goto done;
+	}
+	while(m > 1 && den[m - 1] == 0)     // ignore leading zeros of the divisor
+	{
+		m--;
+	}
+	if(den[m - 1] == 0)
+	{
+		apc_printf("ERROR : Division by zero! \n");
+		goto done;
+	}
 
+	quot = apc_malloc(n * sizeof(data_t));
+	rem = apc_malloc((m + 1) * sizeof(data_t));
+	PROFILE_ALLOC((n + m + 1) * sizeof(data_t));
+	if(quot == NULL || rem == NULL || divmod_digits(num, n, den, m, quot, rem) == FAILURE)
+	{
+		goto done;
+	}
 
+	status = SUCCESS;
+	if(headQ)
+	{
+		status = array_to_list(quot, n, headQ, &tail);
+	}
+	tail = NULL;
+	if(headRem && status == SUCCESS)
+	{
+		status = array_to_list(rem, m + 1, headRem, &tail);
+	}
+
+done:
+	apc_free(num);
+	apc_free(den);
+	apc_free(quot);
+	apc_free(rem);
+	return status;
+}
+
+int div_schoolbook(Dlist **head1, Dlist **tail1, Dlist **head2, Dlist **tail2, Dlist **headR)
+{
+	if(*head1 == NULL || *head2 == NULL)
+	{
+		apc_printf("ERROR : One or Both input Lists are Empty! \n");
+		return FAILURE;
+	}
+	return divmod_schoolbook(*head1, *head2, headR, NULL);
+}
@@ -0,0 +1,341 @@
+/*******************************************************************************************************************************************************************
+ * Function: FACTORIAL / BINOMIAL / PRODUCT
+ * ----------------------------------------
+ *  n!, the binomial coefficient C(n, k) and the product of a list of numbers.
+ *
+ *  Example:
+ *     20!              = 2432902008176640000
+ *     binomial(50, 25) = 126410606437752
+ *     prod(12, -5, 7)  = -420
+ *
+ *  Multiplying factors one after another makes every step a big × small product and the total cost quadratic
+ *  in the result length. All three operators instead multiply through a balanced product tree: neighbouring
+ *  factors are multiplied pairwise, then the pairs, and so on, so every level multiplies operands of about
+ *  the same size and the large products reach the Karatsuba kernel of limbs.c. Small factors are first packed
+ *  into single base-10^9 limbs.
+ *
+ *  Factorial uses Luschny's prime-swing recursion
+ *     n! = ((n/2)!)^2 · swing(n),   swing(n) = n! / ((n/2)!)^2 = product of p^e over primes p <= n
+ *  where e counts the odd quotients n / p^i; every p > n/2 appears once, p in (n/3, n/2] not at all, and
+ *  p > sqrt(n) at most once. The binomial coefficient is the product of p^e with e the number of borrows
+ *  when k is subtracted from n in base p (Kummer). Both exponent sets never exceed p^e <= n, so every
+ *  factor fits one limb.
+ *
+ *  Returns:
+ *     SUCCESS (0) if the result is computed
+ *     FAILURE (-1) if an input list is empty or memory allocation fails
+*******************************************************************************************************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "apc.h"
+
+/* Below this n the factorial is a plain product of 2..n */
+#define FACTORIAL_SMALL 32
+
+/*****************************************************************************************
+ * Function: limbs_product
+ * -----------------------
+ * r = items[0] × items[1] × ... × items[count - 1] by a balanced product tree
+ * (1 for count == 0). The items are not modified; r must not alias an item.
+ *****************************************************************************************/
+
+int limbs_product(const Limbs *items, int count, Limbs *r)
+{
+	if(count == 0)
+	{
+		return limbs_set_small(r, 1);
+	}
+	if(count == 1)
+	{
+		return limbs_copy(&items[0], r);
+	}
+	if(count == 2)
+	{
+		return limbs_mul(&items[0], &items[1], r);
+	}
+
+	Limbs left = { NULL, 0 }, right = { NULL, 0 };
+	int half = count / 2, status = FAILURE;
+	if(limbs_product(items, half, &left) == SUCCESS && limbs_product(items + half, count - half, &right) == SUCCESS)
+	{
+		status = limbs_mul(&left, &right, r);
+	}
+	limbs_free(&left);
+	limbs_free(&right);
+	return status;
+}
+
+/* r = product of small values (each below LIMB_BASE): pack them into limbs, then the product tree */
+static int product_small(const uint32_t *values, int count, Limbs *r)
+{
+	Limbs *items = apc_calloc(count + 1, sizeof(Limbs));
+	if(items == NULL)
+	{
+		return FAILURE;
+	}
+
+	int n = 0, status = SUCCESS;
+	uint64_t acc = 1;
+	for(int i = 0; i <= count && status == SUCCESS; i++)
+	{
+		if(i < count && acc * values[i] < LIMB_BASE)
+		{
+			acc *= values[i];
+			continue;
+		}
+		status = limbs_set_small(&items[n++], acc);
+		acc = (i < count) ? values[i] : 1;
+	}
+
+	if(status == SUCCESS)
+	{
+		status = limbs_product(items, n, r);
+	}
+	for(int i = 0; i < n; i++)
+	{
+		limbs_free(&items[i]);
+	}
+	apc_free(items);
+	return status;
+}
+
+/* composite[i] = 1 for non-primes i <= n (caller frees) */
+static unsigned char *sieve(uint32_t n)
+{
+	unsigned char *composite = apc_calloc(n + 1, 1);
+	if(composite == NULL)
+	{
+		return NULL;
+	}
+	composite[0] = 1;
+	if(n >= 1)
+	{
+		composite[1] = 1;
+	}
+	for(uint64_t i = 2; i * i <= n; i++)
+	{
+		if(!composite[i])
+		{
+			for(uint64_t j = i * i; j <= n; j += i)
+			{
+				composite[j] = 1;
+			}
+		}
+	}
+	return composite;
+}
+
+/* r = swing(n) = n! / ((n/2)!)^2 */
+static int swing(uint32_t n, const unsigned char *composite, Limbs *r)
+{
+	uint32_t *values = apc_malloc((n / 2 + 2) * sizeof(uint32_t));
+	if(values == NULL)
+	{
+		return FAILURE;
+	}
+
+	int count = 0;
+	for(uint32_t p = 2; p <= n; p++)
+	{
+		if(composite[p])
+		{
+			continue;
+		}
+		if(p > n / 2)
+		{
+			values[count++] = p;                        // exponent 1
+		}
+		else if(p > n / 3)
+		{
+			continue;                                   // exponent 0
+		}
+		else if((uint64_t)p * p > n)
+		{
+			if((n / p) & 1)
+				values[count++] = p;
+		}
+		else
+		{
+			// Product of p over the odd quotients n / p^i
+			uint32_t power = 1;
+			for(uint64_t q = p; q <= n; q *= p)
+			{
+				if((n / q) & 1)
+					power *= p;
+			}
+			if(power > 1)
+				values[count++] = power;
+		}
+	}
+
+	int status = product_small(values, count, r);
+	apc_free(values);
+	return status;
+}
+
+/* r = n! (prime-swing recursion) */
+static int factorial_limbs(uint32_t n, const unsigned char *composite, Limbs *r)
+{
+	if(n < FACTORIAL_SMALL)
+	{
+		uint32_t values[FACTORIAL_SMALL];
+		int count = 0;
+		for(uint32_t i = 2; i <= n; i++)
+		{
+			values[count++] = i;
+		}
+		return product_small(values, count, r);
+	}
+
+	Limbs half = { NULL, 0 }, s = { NULL, 0 };
+	int status = FAILURE;
+	if(factorial_limbs(n / 2, composite, &half) == SUCCESS && limbs_mul(&half, &half, &half) == SUCCESS &&
+	   swing(n, composite, &s) == SUCCESS)
+	{
+		status = limbs_mul(&half, &s, r);
+	}
+	limbs_free(&half);
+	limbs_free(&s);
+	return status;
+}
+
+/*****************************************************************************************
+ * Function: factorial
+ * -------------------
+ * headR = n! for 0 <= n <= FACTORIAL_MAX.
+ *****************************************************************************************/
+
+int factorial(long long n, Dlist **headR)
+{
+	if(n < 0 || n > FACTORIAL_MAX)
+	{
+		return FAILURE;
+	}
+
+	unsigned char *composite = sieve(n);
+	Limbs r = { NULL, 0 };
+	Dlist *tailR = NULL;
+	int status = FAILURE;
+
+	if(composite != NULL && factorial_limbs(n, composite, &r) == SUCCESS)
+	{
+		status = limbs_to_list(&r, headR, &tailR);
+	}
+	apc_free(composite);
+	limbs_free(&r);
+	return status;
+}
+
+/*****************************************************************************************
+ * Function: binomial
+ * ------------------
+ * headR = C(n, k) for 0 <= n <= FACTORIAL_MAX (0 when k < 0 or k > n).
+ *****************************************************************************************/
+
+int binomial(long long n, long long k, Dlist **headR)
+{
+	if(n < 0 || n > FACTORIAL_MAX)
+	{
+		return FAILURE;
+	}
+
+	Dlist *tailR = NULL;
+	if(k < 0 || k > n)
+	{
+		return insert_at_end(headR, &tailR, 0);
+	}
+	if(k > n - k)
+	{
+		k = n - k;
+	}
+
+	unsigned char *composite = sieve(n);
+	uint32_t *values = apc_malloc((n / 2 + 2) * sizeof(uint32_t));
+	Limbs r = { NULL, 0 };
+	int status = FAILURE, count = 0;
+
+	if(composite != NULL && values != NULL)
+	{
+		for(uint32_t p = 2; p <= n; p++)
+		{
+			if(composite[p])
+			{
+				continue;
+			}
+			if(p > n - k)
+			{
+				values[count++] = p;                        // p divides the numerator once, the denominator never
+			}
+			else if(p > n / 2)
+			{
+				continue;
+			}
+			else
+			{
+				// One factor p per borrow of k + (n - k) in base p
+				uint32_t power = 1;
+				for(uint64_t q = p; q <= (uint64_t)n; q *= p)
+				{
+					if(n / q - k / q - (n - k) / q)
+						power *= p;
+				}
+				if(power > 1)
+					values[count++] = power;
+			}
+		}
+		if(product_small(values, count, &r) == SUCCESS)
+		{
+			status = limbs_to_list(&r, headR, &tailR);
+		}
+	}
+	apc_free(composite);
+	apc_free(values);
+	limbs_free(&r);
+	return status;
+}
+
+/*****************************************************************************************
+ * Function: product_list
+ * ----------------------
+ * headR = |operand 0| × |operand 1| × ... by the balanced product tree; the caller
+ * handles the signs.
+ *****************************************************************************************/
+
+int product_list(Dlist **heads, int count, Dlist **headR)
+{
+	Limbs *items = apc_calloc(count, sizeof(Limbs));
+	Limbs r = { NULL, 0 };
+	Dlist *tailR = NULL;
+	int status = FAILURE, converted = 0;
+
+	if(items == NULL)
+	{
+		return FAILURE;
+	}
+	for(; converted < count; converted++)
+	{
+		if(heads[converted] == NULL)
+		{
+			apc_printf("ERROR : Input list is Empty! \n");
+			break;
+		}
+		if(limbs_from_list(heads[converted], &items[converted]) == FAILURE)
+		{
+			break;
+		}
+	}
+
+	if(converted == count && limbs_product(items, count, &r) == SUCCESS)
+	{
+		status = limbs_to_list(&r, headR, &tailR);
+	}
+	for(int i = 0; i < converted; i++)
+	{
+		limbs_free(&items[i]);
+	}
+	apc_free(items);
+	limbs_free(&r);
+	return status;
+}
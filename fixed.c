@@ -0,0 +1,172 @@
+/*******************************************************************************************************************************************************************
+ * Fixed-width modular exponentiation
+ * ----------------------------------
+ *  Instantiates the fixed-width kernels of fixed.h for 256, 512, 1024, 2048 and 4096 bits and uses them for
+ *
+ *     ./a.out <base> powmod <exponent> <modulus>      → base^exponent mod modulus, in [0, modulus)
+ *
+ *  An odd modulus of up to 4096 bits runs in the smallest width that holds it, with Montgomery multiplication
+ *  on the stack and a 4-bit exponent window. An even or wider modulus falls back to square-and-multiply on
+ *  limbs (limbs_powmod in primes.c). The Miller-Rabin rounds of isprime go through fixed_powmod as well.
+ *
+ *  Returns:
+ *     SUCCESS (0) on success, FAILURE (-1) if memory allocation fails
+*******************************************************************************************************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "fixed.h"
+
+FIXED_DEFINE(256)
+FIXED_DEFINE(512)
+FIXED_DEFINE(1024)
+FIXED_DEFINE(2048)
+FIXED_DEFINE(4096)
+
+/* Exponent limbs as binary words (caller frees); the word count is returned through *count */
+static uint64_t *exponent_words(const Limbs *e, int *count)
+{
+	// e < 10^(9n) < 2^(30n)
+	int size = (30 * e->n) / 64 + 1;
+	uint64_t *w = apc_calloc(size, sizeof(uint64_t));
+	if(w == NULL)
+	{
+		return NULL;
+	}
+	int n = 0;
+	for(int i = e->n - 1; i >= 0; i--)
+	{
+		fixed_dword carry = e->d[i];
+		for(int j = 0; j < n; j++)
+		{
+			carry += (fixed_dword)w[j] * LIMB_BASE;
+			w[j] = (uint64_t)carry;
+			carry >>= 64;
+		}
+		if(carry)
+		{
+			w[n++] = (uint64_t)carry;
+		}
+	}
+	*count = n;
+	return w;
+}
+
+/* r = a^e mod n in one width; a < n */
+#define FIXED_POW(BITS)                                                                                            \
+static int pow_##BITS(const Limbs *a, const uint64_t *e, int e_words, const Limbs *n, Limbs *r)                    \
+{                                                                                                                  \
+	fixed##BITS x, m;                                                                                              \
+	fixed##BITS##_mont ctx;                                                                                        \
+	if(fixed##BITS##_from_limbs(&x, a) == FAILURE || fixed##BITS##_from_limbs(&m, n) == FAILURE)                   \
+		return FAILURE;                                                                                            \
+	fixed##BITS##_mont_init(&ctx, &m);                                                                             \
+	fixed##BITS##_mod_pow(&x, &x, e, e_words, &ctx);                                                               \
+	return fixed##BITS##_to_limbs(&x, r);                                                                          \
+}
+
+FIXED_POW(256)
+FIXED_POW(512)
+FIXED_POW(1024)
+FIXED_POW(2048)
+FIXED_POW(4096)
+
+/* Fixed width that runs powers modulo n (odd, at most 4096 bits), or 0 */
+int fixed_bits(const Limbs *n)
+{
+	fixed4096 x;
+	if(n->n == 0 || (n->d[0] & 1) == 0 || n->n > 4096 / 29 + 1 || fixed4096_from_limbs(&x, n) == FAILURE)
+	{
+		return 0;
+	}
+	int top = fixed4096_words - 1;
+	while(x.w[top] == 0)
+	{
+		top--;
+	}
+	int bits = 64 * top + 64 - __builtin_clzll(x.w[top]);
+	int width = 256;
+	while(width < bits)
+	{
+		width *= 2;
+	}
+	return width;
+}
+
+/*****************************************************************************************
+ * Function: fixed_powmod
+ * ----------------------
+ * r = base^e mod n in the fixed width for n (fixed_bits(n) must be non-zero).
+ * base is reduced below n first; r may alias an operand.
+ *****************************************************************************************/
+
+int fixed_powmod(const Limbs *base, const Limbs *e, const Limbs *n, Limbs *r)
+{
+	int bits = fixed_bits(n), e_words;
+	Limbs a = { NULL, 0 };
+	uint64_t *w = exponent_words(e, &e_words);
+	if(w == NULL || limbs_divmod(base, n, NULL, &a) == FAILURE)
+	{
+		apc_free(w);
+		return FAILURE;
+	}
+
+	int status;
+	switch(bits)
+	{
+		case 256:  status = pow_256(&a, w, e_words, n, &a);  break;
+		case 512:  status = pow_512(&a, w, e_words, n, &a);  break;
+		case 1024: status = pow_1024(&a, w, e_words, n, &a); break;
+		case 2048: status = pow_2048(&a, w, e_words, n, &a); break;
+		case 4096: status = pow_4096(&a, w, e_words, n, &a); break;
+		default:   status = FAILURE;                         break;
+	}
+	apc_free(w);
+	if(status == SUCCESS)
+	{
+		limbs_free(r);
+		*r = a;
+	}
+	else
+	{
+		limbs_free(&a);
+	}
+	return status;
+}
+
+/*****************************************************************************************
+ * Function: powmod
+ * ----------------
+ * headB = base^e mod m on digit lists, replacing the base list. A negative base is taken
+ * modulo m first, so the result is always in [0, m). e >= 0 and m > 0 are checked by
+ * the caller.
+ *****************************************************************************************/
+
+int powmod(Dlist **headB, Dlist **tailB, char signB, Dlist *headE, Dlist *headM)
+{
+	Limbs b = { NULL, 0 }, e = { NULL, 0 }, m = { NULL, 0 };
+	int status = FAILURE;
+	if(limbs_from_list(*headB, &b) == FAILURE || limbs_from_list(headE, &e) == FAILURE ||
+	   limbs_from_list(headM, &m) == FAILURE || limbs_divmod(&b, &m, NULL, &b) == FAILURE)
+	{
+		goto done;
+	}
+	if(signB == '-' && b.n > 0 && limbs_sub(&m, &b, &b) == FAILURE)
+	{
+		goto done;
+	}
+
+	status = fixed_bits(&m) ? fixed_powmod(&b, &e, &m, &b) : limbs_powmod(&b, &e, &m, &b);
+	if(status == SUCCESS)
+	{
+		delete_list(headB, tailB);
+		status = limbs_to_list(&b, headB, tailB);
+	}
+
+done:
+	limbs_free(&b);
+	limbs_free(&e);
+	limbs_free(&m);
+	return status;
+}
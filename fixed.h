@@ -0,0 +1,266 @@
+/*******************************************************************************************************************************************************************
+ * Fixed-width unsigned integers
+ * -----------------------------
+ *  Cryptographic code knows its widths at compile time (256, 512, 1024, 2048, 4096 bits). FIXED_DEFINE(BITS)
+ *  generates a type fixedBITS holding BITS / 64 binary words on the stack, and a family of static inline
+ *  kernels whose loop bounds are compile-time constants, so the compiler unrolls and schedules them for that
+ *  width (no allocation, no length checks):
+ *
+ *     fixedBITS_zero / _cmp / _is_odd
+ *     fixedBITS_add / _sub          : r = a ± b, returns the carry / borrow
+ *     fixedBITS_mul                 : r[2·W] = a × b (full product, word_mul_basecase)
+ *     fixedBITS_mul_small           : r = a·m + c for single words, returns the word carried out
+ *     fixedBITS_divmod_small        : a /= d, returns a % d
+ *     fixedBITS_mont_init           : Montgomery constants of an odd modulus n (R = 2^BITS)
+ *     fixedBITS_mont_mul            : r = a·b·R⁻¹ mod n (interleaved multiply and reduce rows)
+ *     fixedBITS_to_mont / _from_mont, fixedBITS_mod_pow
+ *     fixedBITS_from_limbs / _to_limbs : conversions with the base-10⁹ Limbs (and so the digit lists)
+ *
+ *  The rows of the products go through the word kernels of basecase.c (mulx/adx when the CPU has them).
+ *  The widths used by the calculator are instantiated in fixed.c; other code includes this header and
+ *  instantiates what it needs. Words are little-endian (w[0] least significant).
+*******************************************************************************************************************************************************************/
+
+#ifndef FIXED_H
+#define FIXED_H
+
+#include <stdint.h>
+#include <string.h>
+#include "apc.h"
+
+typedef unsigned __int128 fixed_dword;
+
+// r[0..n) += a[0..n) × b, returns the carry word (mulx/adx when the CPU has them, basecase.c).
+uint64_t word_addmul_1(uint64_t *r, const uint64_t *a, int n, uint64_t b);
+
+// One implementation of word_addmul_1 by name ("adx" or "generic"); NULL if not built in or not supported by
+// this CPU. For scripts/check-addmul.c, which compares them.
+typedef uint64_t (*word_addmul_1_fn)(uint64_t *r, const uint64_t *a, int n, uint64_t b);
+word_addmul_1_fn word_addmul_1_impl(const char *name);
+
+// r[0..na+nb) = a × b, schoolbook rows of word_addmul_1.
+void word_mul_basecase(uint64_t *r, const uint64_t *a, int na, const uint64_t *b, int nb);
+
+/* Rows of up to this many words are cheaper inline than through the word_addmul_1 call */
+#define FIXED_INLINE_WORDS 4
+
+/* r[0..n) += a[0..n) × b for a compile-time n, returns the carry word */
+static inline uint64_t fixed_addmul_row(uint64_t *r, const uint64_t *a, int n, uint64_t b)
+{
+	if(n > FIXED_INLINE_WORDS)
+	{
+		return word_addmul_1(r, a, n, b);
+	}
+	uint64_t carry = 0;
+	for(int i = 0; i < n; i++)
+	{
+		fixed_dword t = (fixed_dword)a[i] * b + r[i] + carry;
+		r[i] = (uint64_t)t;
+		carry = (uint64_t)(t >> 64);
+	}
+	return carry;
+}
+
+#define FIXED_DEFINE(BITS)                                                                                         \
+                                                                                                                   \
+enum { fixed##BITS##_words = (BITS) / 64 };                                                                        \
+                                                                                                                   \
+typedef struct                                                                                                     \
+{                                                                                                                  \
+	uint64_t w[(BITS) / 64];                                                                                       \
+}fixed##BITS;                                                                                                      \
+                                                                                                                   \
+/* Montgomery context of an odd modulus n: ninv = -n⁻¹ mod 2⁶⁴, rr = R² mod n */                                  \
+typedef struct                                                                                                     \
+{                                                                                                                  \
+	fixed##BITS n;                                                                                                 \
+	fixed##BITS rr;                                                                                                \
+	uint64_t ninv;                                                                                                 \
+}fixed##BITS##_mont;                                                                                               \
+                                                                                                                   \
+static inline void fixed##BITS##_zero(fixed##BITS *r)                                                              \
+{                                                                                                                  \
+	memset(r->w, 0, sizeof(r->w));                                                                                 \
+}                                                                                                                  \
+                                                                                                                   \
+static inline int fixed##BITS##_is_odd(const fixed##BITS *a)                                                       \
+{                                                                                                                  \
+	return (int)(a->w[0] & 1);                                                                                     \
+}                                                                                                                  \
+                                                                                                                   \
+static inline int fixed##BITS##_cmp(const fixed##BITS *a, const fixed##BITS *b)                                    \
+{                                                                                                                  \
+	for(int i = fixed##BITS##_words - 1; i >= 0; i--)                                                              \
+	{                                                                                                              \
+		if(a->w[i] != b->w[i])                                                                                     \
+			return (a->w[i] > b->w[i]) ? GREATER : LESS;                                                           \
+	}                                                                                                              \
+	return EQUAL;                                                                                                  \
+}                                                                                                                  \
+                                                                                                                   \
+static inline uint64_t fixed##BITS##_add(fixed##BITS *r, const fixed##BITS *a, const fixed##BITS *b)               \
+{                                                                                                                  \
+	uint64_t carry = 0;                                                                                            \
+	for(int i = 0; i < fixed##BITS##_words; i++)                                                                   \
+	{                                                                                                              \
+		fixed_dword s = (fixed_dword)a->w[i] + b->w[i] + carry;                                                    \
+		r->w[i] = (uint64_t)s;                                                                                     \
+		carry = (uint64_t)(s >> 64);                                                                               \
+	}                                                                                                              \
+	return carry;                                                                                                  \
+}                                                                                                                  \
+                                                                                                                   \
+static inline uint64_t fixed##BITS##_sub(fixed##BITS *r, const fixed##BITS *a, const fixed##BITS *b)               \
+{                                                                                                                  \
+	uint64_t borrow = 0;                                                                                           \
+	for(int i = 0; i < fixed##BITS##_words; i++)                                                                   \
+	{                                                                                                              \
+		fixed_dword d = (fixed_dword)a->w[i] - b->w[i] - borrow;                                                   \
+		r->w[i] = (uint64_t)d;                                                                                     \
+		borrow = (uint64_t)(d >> 64) & 1;                                                                          \
+	}                                                                                                              \
+	return borrow;                                                                                                 \
+}                                                                                                                  \
+                                                                                                                   \
+static inline void fixed##BITS##_mul(uint64_t r[2 * ((BITS) / 64)], const fixed##BITS *a, const fixed##BITS *b)    \
+{                                                                                                                  \
+	word_mul_basecase(r, a->w, fixed##BITS##_words, b->w, fixed##BITS##_words);                                    \
+}                                                                                                                  \
+                                                                                                                   \
+static inline uint64_t fixed##BITS##_mul_small(fixed##BITS *r, uint64_t m, uint64_t c)                             \
+{                                                                                                                  \
+	fixed_dword t = c;                                                                                             \
+	for(int i = 0; i < fixed##BITS##_words; i++)                                                                   \
+	{                                                                                                              \
+		t += (fixed_dword)r->w[i] * m;                                                                             \
+		r->w[i] = (uint64_t)t;                                                                                     \
+		t >>= 64;                                                                                                  \
+	}                                                                                                              \
+	return (uint64_t)t;                                                                                            \
+}                                                                                                                  \
+                                                                                                                   \
+static inline uint64_t fixed##BITS##_divmod_small(fixed##BITS *a, uint64_t d)                                      \
+{                                                                                                                  \
+	fixed_dword rem = 0;                                                                                           \
+	for(int i = fixed##BITS##_words - 1; i >= 0; i--)                                                              \
+	{                                                                                                              \
+		rem = (rem << 64) | a->w[i];                                                                               \
+		a->w[i] = (uint64_t)(rem / d);                                                                             \
+		rem %= d;                                                                                                  \
+	}                                                                                                              \
+	return (uint64_t)rem;                                                                                          \
+}                                                                                                                  \
+                                                                                                                   \
+/* r = a·b·R⁻¹ mod n for a, b < n: row i adds a·b[i] and then m·n, which clears word i (t advances one word) */    \
+static inline void fixed##BITS##_mont_mul(fixed##BITS *r, const fixed##BITS *a, const fixed##BITS *b,              \
+                                          const fixed##BITS##_mont *ctx)                                           \
+{                                                                                                                  \
+	enum { W = fixed##BITS##_words };                                                                              \
+	uint64_t t[2 * W + 1] = { 0 };                                                                                 \
+	for(int i = 0; i < W; i++)                                                                                     \
+	{                                                                                                              \
+		fixed_dword c = (fixed_dword)t[i + W] + fixed_addmul_row(t + i, a->w, W, b->w[i]);                         \
+		t[i + W] = (uint64_t)c;                                                                                    \
+		t[i + W + 1] = (uint64_t)(c >> 64);                                                                        \
+		c = (fixed_dword)t[i + W] + fixed_addmul_row(t + i, ctx->n.w, W, t[i] * ctx->ninv);                        \
+		t[i + W] = (uint64_t)c;                                                                                    \
+		t[i + W + 1] += (uint64_t)(c >> 64);                                                                       \
+	}                                                                                                              \
+                                                                                                                   \
+	/* t < 2n: one conditional subtraction */                                                                      \
+	memcpy(r->w, t + W, sizeof(r->w));                                                                             \
+	if(t[2 * W] || fixed##BITS##_cmp(r, &ctx->n) != LESS)                                                          \
+		fixed##BITS##_sub(r, r, &ctx->n);                                                                          \
+}                                                                                                                  \
+                                                                                                                   \
+/* Constants for odd n: ninv by Newton iteration, R² mod n by doubling 1 (2·BITS times) */                       \
+static inline void fixed##BITS##_mont_init(fixed##BITS##_mont *ctx, const fixed##BITS *n)                          \
+{                                                                                                                  \
+	ctx->n = *n;                                                                                                   \
+	uint64_t inv = n->w[0];                                                                                        \
+	for(int i = 0; i < 5; i++)                                                                                     \
+		inv *= 2 - n->w[0] * inv;                                                                                  \
+	ctx->ninv = -inv;                                                                                              \
+                                                                                                                   \
+	fixed##BITS##_zero(&ctx->rr);                                                                                  \
+	ctx->rr.w[0] = 1;                                                                                              \
+	for(int i = 0; i < 2 * (BITS); i++)                                                                            \
+	{                                                                                                              \
+		uint64_t carry = fixed##BITS##_add(&ctx->rr, &ctx->rr, &ctx->rr);                                          \
+		if(carry || fixed##BITS##_cmp(&ctx->rr, n) != LESS)                                                        \
+			fixed##BITS##_sub(&ctx->rr, &ctx->rr, n);                                                              \
+	}                                                                                                              \
+}                                                                                                                  \
+                                                                                                                   \
+static inline void fixed##BITS##_to_mont(fixed##BITS *r, const fixed##BITS *a, const fixed##BITS##_mont *ctx)     \
+{                                                                                                                  \
+	fixed##BITS##_mont_mul(r, a, &ctx->rr, ctx);                                                                   \
+}                                                                                                                  \
+                                                                                                                   \
+static inline void fixed##BITS##_from_mont(fixed##BITS *r, const fixed##BITS *a, const fixed##BITS##_mont *ctx)    \
+{                                                                                                                  \
+	fixed##BITS one;                                                                                               \
+	fixed##BITS##_zero(&one);                                                                                      \
+	one.w[0] = 1;                                                                                                  \
+	fixed##BITS##_mont_mul(r, a, &one, ctx);                                                                       \
+}                                                                                                                  \
+                                                                                                                   \
+/* r = a^e mod n for a < n, e of e_words words; fixed 4-bit window over a table of a⁰ .. a¹⁵ */                  \
+static inline void fixed##BITS##_mod_pow(fixed##BITS *r, const fixed##BITS *a, const uint64_t *e, int e_words,     \
+                                         const fixed##BITS##_mont *ctx)                                            \
+{                                                                                                                  \
+	fixed##BITS table[16], x;                                                                                      \
+	fixed##BITS##_zero(&x);                                                                                        \
+	x.w[0] = 1;                                                                                                    \
+	fixed##BITS##_to_mont(&table[0], &x, ctx);                                                                     \
+	fixed##BITS##_to_mont(&table[1], a, ctx);                                                                      \
+	for(int i = 2; i < 16; i++)                                                                                    \
+		fixed##BITS##_mont_mul(&table[i], &table[i - 1], &table[1], ctx);                                          \
+                                                                                                                   \
+	/* Leading zero windows would only square one */                                                              \
+	int top = e_words * 16 - 1;                                                                                    \
+	while(top >= 0 && ((e[top / 16] >> (4 * (top % 16))) & 15) == 0)                                               \
+		top--;                                                                                                     \
+	x = table[0];                                                                                                  \
+	for(int i = top; i >= 0; i--)                                                                                  \
+	{                                                                                                              \
+		for(int k = 0; k < 4; k++)                                                                                 \
+			fixed##BITS##_mont_mul(&x, &x, &x, ctx);                                                               \
+		int window = (int)((e[i / 16] >> (4 * (i % 16))) & 15);                                                    \
+		if(window)                                                                                                 \
+			fixed##BITS##_mont_mul(&x, &x, &table[window], ctx);                                                   \
+	}                                                                                                              \
+	fixed##BITS##_from_mont(r, &x, ctx);                                                                           \
+}                                                                                                                  \
+                                                                                                                   \
+/* Limbs (base 10⁹) → fixed; FAILURE if the value needs more than BITS bits */                                    \
+static inline int fixed##BITS##_from_limbs(fixed##BITS *r, const Limbs *x)                                         \
+{                                                                                                                  \
+	fixed##BITS##_zero(r);                                                                                         \
+	for(int i = x->n - 1; i >= 0; i--)                                                                             \
+	{                                                                                                              \
+		if(fixed##BITS##_mul_small(r, LIMB_BASE, x->d[i]) != 0)                                                    \
+			return FAILURE;                                                                                        \
+	}                                                                                                              \
+	return SUCCESS;                                                                                                \
+}                                                                                                                  \
+                                                                                                                   \
+/* fixed → Limbs (base 10⁹) */                                                                                     \
+static inline int fixed##BITS##_to_limbs(const fixed##BITS *a, Limbs *x)                                          \
+{                                                                                                                  \
+	int n = 0, size = (BITS) / 29 + 1;                                                                             \
+	uint32_t *d = apc_calloc(size, sizeof(uint32_t));                                                              \
+	if(d == NULL)                                                                                                  \
+		return FAILURE;                                                                                            \
+	fixed##BITS t = *a;                                                                                            \
+	fixed##BITS zero;                                                                                              \
+	fixed##BITS##_zero(&zero);                                                                                     \
+	while(fixed##BITS##_cmp(&t, &zero) != EQUAL)                                                                   \
+		d[n++] = (uint32_t)fixed##BITS##_divmod_small(&t, LIMB_BASE);                                              \
+	limbs_free(x);                                                                                                 \
+	x->d = d;                                                                                                      \
+	x->n = n;                                                                                                      \
+	return SUCCESS;                                                                                                \
+}
+
+#endif
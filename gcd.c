@@ -0,0 +1,587 @@
+/*******************************************************************************************************************************************************************
+ * Function: GCD / XGCD / INVMOD
+ * -----------------------------
+ *  Greatest common divisor, extended gcd (Bezout coefficients) and modular inverse.
+ *
+ *  Example:
+ *     gcd(84, 36)     = 12
+ *     xgcd(240, 46)   = 2 = 240·(-9) + 46·47
+ *     invmod(3, 11)   = 4              (3·4 = 12 ≡ 1 mod 11)
+ *
+ *  The operands are converted once to base-10^9 limbs (limbs.c) and reduced there. Every reduction step is
+ *  an exact prefix of Euclid's remainder sequence, recorded as a matrix M with non-negative entries:
+ *
+ *     (a; b) = M · (u; v),   det M = ±1,   so   gcd(a, b) = gcd(u, v)
+ *
+ *  When u reaches the gcd (v = 0), its Bezout coefficients are read off the inverse of M.
+ *
+ *  Kernels (picked from the registry by operand length, family "gcd"):
+ *     gcd_lehmer → Lehmer's algorithm: the quotients of many Euclid steps are found from the top two
+ *                  limbs of u and v (a double-limb, ~18 digit estimate) while they provably agree with the
+ *                  full-precision ones (Knuth's Algorithm L), then applied to u and v in one linear pass.
+ *                  A full division step is made only when the estimate cannot decide a single quotient.
+ *     gcd_hgcd   → half-gcd: the top half of u and v is reduced recursively, the resulting matrix is
+ *                  applied to the full numbers with Karatsuba products, and the step is repeated on the
+ *                  remaining half. O(M(n) log n) instead of the O(n^2) of Lehmer.
+ *
+ *  Parameters:
+ *     head1, tail1 → first number (magnitude)
+ *     head2, tail2 → second number / modulus (magnitude)
+ *     headR        → result list
+ *
+ *  Returns:
+ *     SUCCESS (0) if the result is computed (invmod: headR stays NULL if no inverse exists)
+ *     FAILURE (-1) if an input list is empty or memory allocation fails
+*******************************************************************************************************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include "apc.h"
+
+/* Lehmer cofactors are kept below this bound so a linear combination of limbs fits in 64 bits */
+#define LEHMER_COFACTOR_MAX (1LL << 31)
+
+/* Half-gcd recursion stops below this many limbs and finishes with Lehmer steps */
+#define HGCD_MIN_LIMBS 32
+
+/* Reduction matrix: (a; b) = m · (u; v), non-negative entries, det = ±1 */
+typedef struct
+{
+	Limbs m[2][2];
+	int det;
+}Matrix;
+
+static int matrix_identity(Matrix *M)
+{
+	memset(M, 0, sizeof(*M));
+	M->det = 1;
+	if(limbs_set_small(&M->m[0][0], 1) == FAILURE || limbs_set_small(&M->m[1][1], 1) == FAILURE)
+	{
+		return FAILURE;
+	}
+	return SUCCESS;
+}
+
+static void matrix_free(Matrix *M)
+{
+	for(int i = 0; i < 2; i++)
+	{
+		for(int j = 0; j < 2; j++)
+		{
+			limbs_free(&M->m[i][j]);
+		}
+	}
+}
+
+/* M = M · [[p, q], [r, s]] for single-limb p, q, r, s (each row is two linear combinations) */
+static int matrix_mul_small(Matrix *M, uint32_t p, uint32_t q, uint32_t r, uint32_t s, int det)
+{
+	for(int i = 0; i < 2; i++)
+	{
+		Limbs c0 = { NULL, 0 }, c1 = { NULL, 0 };
+		if(limbs_lincomb(&M->m[i][0], p, &M->m[i][1], r, &c0) == FAILURE ||
+		   limbs_lincomb(&M->m[i][0], q, &M->m[i][1], s, &c1) == FAILURE)
+		{
+			limbs_free(&c0);
+			limbs_free(&c1);
+			return FAILURE;
+		}
+		limbs_free(&M->m[i][0]);
+		limbs_free(&M->m[i][1]);
+		M->m[i][0] = c0;
+		M->m[i][1] = c1;
+	}
+	M->det *= det;
+	return SUCCESS;
+}
+
+/* M = M · S */
+static int matrix_mul(Matrix *M, const Matrix *S)
+{
+	Matrix P;
+	Limbs t = { NULL, 0 };
+	memset(&P, 0, sizeof(P));
+
+	for(int i = 0; i < 2; i++)
+	{
+		for(int j = 0; j < 2; j++)
+		{
+			if(limbs_mul(&M->m[i][0], &S->m[0][j], &P.m[i][j]) == FAILURE ||
+			   limbs_mul(&M->m[i][1], &S->m[1][j], &t) == FAILURE ||
+			   limbs_add(&P.m[i][j], &t, &P.m[i][j]) == FAILURE)
+			{
+				limbs_free(&t);
+				matrix_free(&P);
+				return FAILURE;
+			}
+		}
+	}
+	limbs_free(&t);
+	P.det = M->det * S->det;
+	matrix_free(M);
+	*M = P;
+	return SUCCESS;
+}
+
+/* One full division step: (u, v) = (v, u mod v), M = M · [[q, 1], [1, 0]] */
+static int division_step(Limbs *u, Limbs *v, Matrix *M)
+{
+	Limbs q = { NULL, 0 }, r = { NULL, 0 };
+	if(limbs_divmod(u, v, M ? &q : NULL, &r) == FAILURE)
+	{
+		return FAILURE;
+	}
+
+	if(M)
+	{
+		for(int i = 0; i < 2; i++)
+		{
+			Limbs t = { NULL, 0 };
+			if(limbs_mul(&M->m[i][0], &q, &t) == FAILURE || limbs_add(&t, &M->m[i][1], &t) == FAILURE)
+			{
+				limbs_free(&t);
+				limbs_free(&q);
+				limbs_free(&r);
+				return FAILURE;
+			}
+			limbs_free(&M->m[i][1]);
+			M->m[i][1] = M->m[i][0];
+			M->m[i][0] = t;
+		}
+		M->det = -M->det;
+	}
+
+	limbs_free(&q);
+	limbs_free(u);
+	*u = *v;
+	*v = r;
+	return SUCCESS;
+}
+
+/* Top two limbs of x at the position of the top two limbs of a number of n limbs */
+static long long top_limbs(const Limbs *x, int n)
+{
+	long long hi = (n - 1 < x->n) ? x->d[n - 1] : 0;
+	long long lo = (n >= 2 && n - 2 < x->n) ? x->d[n - 2] : 0;
+	return (n >= 2) ? hi * LIMB_BASE + lo : hi;
+}
+
+/* u·A + v·B for signed single-word A, B; the result is known to be non-negative */
+static int combine(const Limbs *u, long long A, const Limbs *v, long long B, Limbs *r)
+{
+	int n = u->n;
+	uint32_t *d = apc_calloc(n + 1, sizeof(uint32_t));
+	if(d == NULL)
+	{
+		return FAILURE;
+	}
+	PROFILE_ALLOC((n + 1) * sizeof(uint32_t));
+
+	long long carry = 0;
+	for(int i = 0; i < n; i++)
+	{
+		long long t = A * u->d[i] + B * ((i < v->n) ? v->d[i] : 0) + carry;
+		long long digit = t % (long long)LIMB_BASE;
+		carry = t / (long long)LIMB_BASE;
+		if(digit < 0)
+		{
+			digit += LIMB_BASE;
+			carry--;
+		}
+		d[i] = digit;
+	}
+	d[n] = carry;
+
+	limbs_free(r);
+	r->d = d;
+	r->n = n + 1;
+	limbs_trim(r);
+	return SUCCESS;
+}
+
+/*****************************************************************************************
+ * Function: lehmer_step
+ * ---------------------
+ * One Lehmer reduction of u >= v > 0. Euclid runs on the top two limbs û, v̂ while the
+ * quotients of (û + A)/(v̂ + C) and (û + B)/(v̂ + D) agree, i.e. while the quotient is the
+ * same for every value the discarded limbs could have (Knuth, Algorithm L). The steps are
+ * then applied at once: u' = A·u + B·v, v' = C·u + D·v. If no step can be certified, one
+ * full division step is made instead.
+ *****************************************************************************************/
+
+static int lehmer_step(Limbs *u, Limbs *v, Matrix *M)
+{
+	long long uh = top_limbs(u, u->n), vh = top_limbs(v, u->n);
+	long long A = 1, B = 0, C = 0, D = 1;
+
+	while(vh + C != 0 && vh + D != 0)
+	{
+		long long q = (uh + A) / (vh + C);
+		if(q != (uh + B) / (vh + D))
+		{
+			break;
+		}
+
+		long long nextC = A - q * C, nextD = B - q * D;
+		if(llabs(nextC) >= LEHMER_COFACTOR_MAX || llabs(nextD) >= LEHMER_COFACTOR_MAX)
+		{
+			break;
+		}
+		A = C; C = nextC;
+		B = D; D = nextD;
+
+		long long t = uh - q * vh;
+		uh = vh;
+		vh = t;
+	}
+
+	if(B == 0)
+	{
+		return division_step(u, v, M);
+	}
+
+	Limbs nu = { NULL, 0 }, nv = { NULL, 0 };
+	if(combine(u, A, v, B, &nu) == FAILURE || combine(u, C, v, D, &nv) == FAILURE ||
+	   (M && matrix_mul_small(M, llabs(D), llabs(B), llabs(C), llabs(A), (A * D - B * C > 0) ? 1 : -1) == FAILURE))
+	{
+		limbs_free(&nu);
+		limbs_free(&nv);
+		return FAILURE;
+	}
+	limbs_free(u);
+	limbs_free(v);
+	*u = nu;
+	*v = nv;
+	return SUCCESS;
+}
+
+/* (u; v) = S^-1 · (a; b); returns 1 if u > v >= 0 (S is a valid Euclid prefix), 0 if not, FAILURE on error */
+static int apply_inverse(const Matrix *S, const Limbs *a, const Limbs *b, Limbs *u, Limbs *v)
+{
+	// S^-1 = det · [[s11, -s01], [-s10, s00]]
+	Limbs p = { NULL, 0 }, q = { NULL, 0 }, r = { NULL, 0 }, s = { NULL, 0 };
+	int valid = FAILURE;
+
+	if(limbs_mul(&S->m[1][1], a, &p) == FAILURE || limbs_mul(&S->m[0][1], b, &q) == FAILURE ||
+	   limbs_mul(&S->m[0][0], b, &r) == FAILURE || limbs_mul(&S->m[1][0], a, &s) == FAILURE)
+	{
+		goto done;
+	}
+
+	// u = ±(s11·a - s01·b), v = ±(s00·b - s10·a), both must come out non-negative
+	const Limbs *up = (S->det > 0) ? &p : &q, *un = (S->det > 0) ? &q : &p;
+	const Limbs *vp = (S->det > 0) ? &r : &s, *vn = (S->det > 0) ? &s : &r;
+	valid = 0;
+	if(limbs_cmp(up, un) == LESS || limbs_cmp(vp, vn) == LESS)
+	{
+		goto done;
+	}
+	if(limbs_sub(up, un, u) == FAILURE || limbs_sub(vp, vn, v) == FAILURE)
+	{
+		valid = FAILURE;
+		goto done;
+	}
+	valid = (limbs_cmp(u, v) == GREATER);
+
+done:
+	limbs_free(&p);
+	limbs_free(&q);
+	limbs_free(&r);
+	limbs_free(&s);
+	return valid;
+}
+
+/*****************************************************************************************
+ * Function: hgcd
+ * --------------
+ * Reduces u > v >= 0 (n limbs) in place until v has at most n/2 + 1 limbs, multiplying the
+ * steps into M. While more than HGCD_MIN_LIMBS limbs remain above the target, the top part
+ * of u and v (at most half of the original length) is reduced recursively and its matrix S
+ * is applied to the full numbers; this is valid as long as the result satisfies u > v >= 0,
+ * which is checked, and a Lehmer step is taken whenever S cannot be used.
+ *****************************************************************************************/
+
+static int hgcd(Limbs *u, Limbs *v, Matrix *M)
+{
+	int n = u->n, s = n / 2 + 1;
+
+	while(v->n > s)
+	{
+		int excess = u->n - s;
+		int length = (2 * excess < n / 2) ? 2 * excess : n / 2;     // prefix length for the recursion
+		int shift = u->n - length;
+
+		if(length < HGCD_MIN_LIMBS || shift <= 0)
+		{
+			if(lehmer_step(u, v, M) == FAILURE)
+				return FAILURE;
+			continue;
+		}
+
+		// Reduce the top `length` limbs of u and v
+		Limbs hu = { NULL, 0 }, hv = { NULL, 0 }, nu = { NULL, 0 }, nv = { NULL, 0 };
+		Limbs lu = { u->d + shift, u->n - shift }, lv = { v->d + shift, v->n - shift };
+		Matrix S;
+		int valid = FAILURE;
+		memset(&S, 0, sizeof(S));
+
+		if(limbs_copy(&lu, &hu) == SUCCESS && limbs_copy(&lv, &hv) == SUCCESS && matrix_identity(&S) == SUCCESS)
+		{
+			valid = 0;
+			if(limbs_cmp(&hu, &hv) == GREATER && hgcd(&hu, &hv, &S) == SUCCESS)
+			{
+				// S must contain at least one step (m10 > 0) and hold for the full numbers
+				valid = (S.m[1][0].n > 0) ? apply_inverse(&S, u, v, &nu, &nv) : 0;
+			}
+		}
+		limbs_free(&hu);
+		limbs_free(&hv);
+
+		if(valid == 1 && M)
+		{
+			valid = (matrix_mul(M, &S) == SUCCESS) ? 1 : FAILURE;
+		}
+		matrix_free(&S);
+
+		if(valid == 1)
+		{
+			limbs_free(u);
+			limbs_free(v);
+			*u = nu;
+			*v = nv;
+			continue;
+		}
+		limbs_free(&nu);
+		limbs_free(&nv);
+		if(valid == FAILURE || lehmer_step(u, v, M) == FAILURE)
+		{
+			return FAILURE;
+		}
+	}
+	return SUCCESS;
+}
+
+/* Reduce (u, v) to (gcd, 0); M (or NULL) collects the steps. Half-gcd passes from hgcd_limbs limbs. */
+static int gcd_limbs(Limbs *u, Limbs *v, Matrix *M, int hgcd_limbs)
+{
+	if(limbs_cmp(u, v) == LESS)
+	{
+		Limbs t = *u; *u = *v; *v = t;
+		if(M)
+		{
+			// (v; u) = [[0, 1], [1, 0]] · (u; v)
+			if(matrix_mul_small(M, 0, 1, 1, 0, -1) == FAILURE)
+				return FAILURE;
+		}
+	}
+
+	while(v->n > 0)
+	{
+		if(u->n >= hgcd_limbs && v->n > u->n / 2 + 1)
+		{
+			if(hgcd(u, v, M) == FAILURE)
+				return FAILURE;
+		}
+		else if(lehmer_step(u, v, M) == FAILURE)
+		{
+			return FAILURE;
+		}
+	}
+	return SUCCESS;
+}
+
+/* Limb threshold of the half-gcd kernel (registry value is in digits) */
+static int hgcd_threshold_limbs(void)
+{
+	int digits = kernel_threshold("gcd", "hgcd");
+	if(digits >= INT_MAX - LIMB_DIGITS)
+	{
+		return INT_MAX;
+	}
+	int limbs = (digits + LIMB_DIGITS - 1) / LIMB_DIGITS;
+	return (limbs < 2 * HGCD_MIN_LIMBS) ? 2 * HGCD_MIN_LIMBS : limbs;
+}
+
+static int gcd_kernel(Dlist *head1, Dlist *head2, Dlist **headR, int hgcd_limbs)
+{
+	Limbs u = { NULL, 0 }, v = { NULL, 0 };
+	int status = FAILURE;
+
+	if(limbs_from_list(head1, &u) == SUCCESS && limbs_from_list(head2, &v) == SUCCESS &&
+	   gcd_limbs(&u, &v, NULL, hgcd_limbs) == SUCCESS)
+	{
+		Dlist *tailR = NULL;
+		status = limbs_to_list(&u, headR, &tailR);
+	}
+	limbs_free(&u);
+	limbs_free(&v);
+	return status;
+}
+
+int limbs_gcd(const Limbs *a, const Limbs *b, Limbs *g)
+{
+	Limbs u = { NULL, 0 }, v = { NULL, 0 };
+	int status = FAILURE;
+
+	if(limbs_copy(a, &u) == SUCCESS && limbs_copy(b, &v) == SUCCESS &&
+	   gcd_limbs(&u, &v, NULL, hgcd_threshold_limbs()) == SUCCESS)
+	{
+		limbs_free(g);
+		*g = u;
+		u.d = NULL;
+		status = SUCCESS;
+	}
+	limbs_free(&u);
+	limbs_free(&v);
+	return status;
+}
+
+int gcd_lehmer(Dlist **head1, Dlist **tail1, Dlist **head2, Dlist **tail2, Dlist **headR)
+{
+	if(*head1 == NULL || *head2 == NULL)
+	{
+		apc_printf("ERROR : One or Both input Lists are Empty! \n");
+		return FAILURE;
+	}
+	return gcd_kernel(*head1, *head2, headR, INT_MAX);
+}
+
+int gcd_hgcd(Dlist **head1, Dlist **tail1, Dlist **head2, Dlist **tail2, Dlist **headR)
+{
+	if(*head1 == NULL || *head2 == NULL)
+	{
+		apc_printf("ERROR : One or Both input Lists are Empty! \n");
+		return FAILURE;
+	}
+	return gcd_kernel(*head1, *head2, headR, hgcd_threshold_limbs());
+}
+
+int gcd(Dlist **head1, Dlist **tail1, Dlist **head2, Dlist **tail2, Dlist **headR)
+{
+	if(*head1 == NULL || *head2 == NULL)
+	{
+		apc_printf("ERROR : One or Both input Lists are Empty! \n");
+		return FAILURE;
+	}
+
+	int length = find_length(*head1);
+	if(find_length(*head2) > length)
+	{
+		length = find_length(*head2);
+	}
+	const kernel_t *kernel = select_kernel("gcd", length);
+	return kernel->binary(head1, tail1, head2, tail2, headR);
+}
+
+/*****************************************************************************************
+ * Function: xgcd
+ * --------------
+ * g = gcd(a, b) and Bezout coefficients with a·s + b·t = g. With (a; b) = M·(g; 0),
+ * g = det·(m11·a - m01·b), so |s| = m11 and |t| = m01 with opposite signs given by det.
+ * The signs are returned in sign_s / sign_t ('+' or '-'); a zero coefficient gets '+'.
+ *****************************************************************************************/
+
+int xgcd(Dlist *head1, Dlist *head2, Dlist **headG, Dlist **headS, char *sign_s, Dlist **headT, char *sign_t)
+{
+	if(head1 == NULL || head2 == NULL)
+	{
+		apc_printf("ERROR : One or Both input Lists are Empty! \n");
+		return FAILURE;
+	}
+
+	Limbs u = { NULL, 0 }, v = { NULL, 0 };
+	Matrix M;
+	int status = FAILURE;
+	Dlist *tail = NULL;
+
+	if(matrix_identity(&M) == FAILURE || limbs_from_list(head1, &u) == FAILURE || limbs_from_list(head2, &v) == FAILURE)
+	{
+		goto done;
+	}
+
+	if(u.n == 0 || v.n == 0)
+	{
+		// gcd(a, 0) = a = a·1 + 0·0 (and gcd(0, 0) = 0)
+		int a_zero = (u.n == 0);
+		status = limbs_to_list(a_zero ? &v : &u, headG, &tail);
+		tail = NULL;
+		if(status == SUCCESS)
+			status = long_to_list(a_zero ? 0 : 1, headS, &tail);
+		tail = NULL;
+		if(status == SUCCESS)
+			status = long_to_list((a_zero && v.n) ? 1 : 0, headT, &tail);
+		*sign_s = *sign_t = '+';
+		goto done;
+	}
+
+	if(gcd_limbs(&u, &v, &M, hgcd_threshold_limbs()) == FAILURE)
+	{
+		goto done;
+	}
+
+	status = limbs_to_list(&u, headG, &tail);
+	tail = NULL;
+	if(status == SUCCESS)
+		status = limbs_to_list(&M.m[1][1], headS, &tail);
+	tail = NULL;
+	if(status == SUCCESS)
+		status = limbs_to_list(&M.m[0][1], headT, &tail);
+
+	*sign_s = (M.det > 0 || M.m[1][1].n == 0) ? '+' : '-';
+	*sign_t = (M.det < 0 || M.m[0][1].n == 0) ? '+' : '-';
+
+done:
+	limbs_free(&u);
+	limbs_free(&v);
+	matrix_free(&M);
+	return status;
+}
+
+/*****************************************************************************************
+ * Function: invmod
+ * ----------------
+ * Inverse of a modulo m (m > 0): the x in [0, m) with a·x ≡ 1 (mod m). From xgcd(a, m),
+ * x = s when s >= 0, else m - |s|. If gcd(a, m) != 1 no inverse exists and headR stays NULL.
+ *****************************************************************************************/
+
+int invmod(Dlist **head1, Dlist **tail1, Dlist **head2, Dlist **tail2, Dlist **headR)
+{
+	Dlist *g = NULL, *s = NULL, *t = NULL, *tail = NULL;
+	char sign_s, sign_t;
+
+	if(xgcd(*head1, *head2, &g, &s, &sign_s, &t, &sign_t) == FAILURE)
+	{
+		return FAILURE;
+	}
+
+	int status = SUCCESS;
+	long long value;
+	if(list_to_long(g, &value) == SUCCESS && value == 1)
+	{
+		Dlist *s_tail = list_tail(s);
+
+		if(list_to_long(*head2, &value) == SUCCESS && value == 1)
+		{
+			status = long_to_list(0, headR, &tail);         // everything is 0 modulo 1
+		}
+		else if(sign_s == '+')
+		{
+			status = copy_list(s, headR, &tail);
+		}
+		else
+		{
+			// subtraction() only reads m, but may swap the pointers it is given: pass local ones
+			Dlist *m = *head2, *m_tail = *tail2;
+			status = subtraction(&m, &m_tail, &s, &s_tail, headR);
+			remove_leading_zeros(headR);
+		}
+		delete_list(&s, &s_tail);
+	}
+
+	delete_list(&g, &tail);
+	delete_list(&s, &tail);
+	delete_list(&t, &tail);
+	return status;
+}
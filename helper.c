@@ -2,14 +2,26 @@
 #include <stdlib.h>
 #include <string.h>
 #include <ctype.h>
+#include <stdarg.h>
 #include "apc.h"
 
+/* Digits print_list hands to fwrite at a time */
+#define PRINT_BLOCK 4096
+
+/* Work of a parallel print: chunk starts every CONVERT_GRAIN nodes, and the characters of the whole list */
+typedef struct
+{
+    Dlist **start;          // start[g]: node of digit g * CONVERT_GRAIN
+    char *out;
+}PrintJob;
+
 
 /* =========================================================================================
  * Function: check_sign
  * -----------------------------------------------------------------------------------------
  *  Validates that the input string represents a valid signed number (+ / - optional).
- *  Ensures that all remaining characters after the sign are digits.
+ *  Ensures that all remaining characters after the sign are digits, allowing a single
+ *  decimal point ('.') or fraction bar ('/') as long as at least one digit is present.
  *
  *  Returns: SUCCESS if valid, FAILURE if invalid or empty.
  * ========================================================================================= */
@@ -34,66 +46,159 @@ int check_sign(const char *s)
         return FAILURE;
     }
 
-    // Verify that all remaining characters are digits
+    // Verify that all remaining characters are digits (one '.' or '/' allowed)
+    int points = 0, digits = 0;
     while (s[i] != '\0')
     {
-        if(!isdigit(s[i]))
+        if(s[i] == '.' || s[i] == '/')
+        {
+            points++;
+        }
+        else if(!isdigit(s[i]))
         {
             return FAILURE;
         }
+        else
+        {
+            digits++;
+        }
         i++;
     }
 
-    return SUCCESS;
+    return (points <= 1 && digits > 0) ? SUCCESS : FAILURE;
 }
 
 
 
+/* =========================================================================================
+ * Function: operator_arity
+ * -----------------------------------------------------------------------------------------
+ *  Returns how many operands the operator takes:
+ *     1 → isqrt  isprime  nextprime  factor  !     (./a.out <num> <operator>)
+ *     2 → +  -  *  /  ^  %  iroot  binomial ...    (./a.out <num1> <operator> <num2>)
+ *     3 → addmul  submul  powmod                   (./a.out <acc> <operator> <num1> <num2>)
+ *     ARITY_LIST → prod                            (./a.out <num1> <operator> <num2> [<num3> ...])
+ *  Returns FAILURE for an unknown operator.
+ * ========================================================================================= */
+
+static const struct
+{
+    const char *symbol;
+    int arity;
+    const char *help;
+}operators[] =
+{
+    { "+",      2, "Addition" },
+    { "-",      2, "subtraction" },
+    { "*",      2, "Multiplication" },
+    { "/",      2, "Division" },
+    { "^",      2, "Square" },
+    { "%",      2, "Modulus" },
+    { "addmul", 3, "acc + (num1 * num2)" },
+    { "submul", 3, "acc - (num1 * num2)" },
+    { "powmod", 3, "Modular power: ./a.out <base> powmod <exponent> <modulus>" },
+    { "isqrt",  1, "Integer square root: ./a.out <num> isqrt" },
+    { "iroot",  2, "Integer n-th root: ./a.out <num> iroot <n>" },
+    { "gcd",    2, "Greatest common divisor" },
+    { "xgcd",   2, "Extended gcd: g = num1*s + num2*t" },
+    { "invmod", 2, "Modular inverse: ./a.out <num> invmod <modulus>" },
+    { "cmp",    2, "Compare: prints -1, 0 or 1" },
+    { "isprime",   1, "Primality: prime, probable prime or composite" },
+    { "nextprime", 1, "Smallest prime greater than num" },
+    { "factor",    1, "Prime factorization" },
+    { "!",         1, "Factorial: ./a.out <n> !" },
+    { "binomial",  2, "Binomial coefficient: ./a.out <n> binomial <k>" },
+    { "prod",      ARITY_LIST, "Product of all operands: ./a.out <num1> prod <num2> [<num3> ...]" },
+};
+
+int operator_arity(const char *op)
+{
+    for (size_t i = 0; i < sizeof(operators) / sizeof(operators[0]); i++)
+    {
+        if (strcmp(op, operators[i].symbol) == 0)
+        {
+            return operators[i].arity;
+        }
+    }
+    return FAILURE;
+}
+
+
 /* =========================================================================================
  * Function: validate_arguments
  * -----------------------------------------------------------------------------------------
  *  Ensures valid command-line arguments and correct operator.
  *  Usage format: ./a.out <num1> <operator> <num2>
+ *                ./a.out <num> <operator>                  (unary operators)
+ *                ./a.out <acc> <addmul|submul> <num1> <num2>
  *
- *  Allowed operators: +  -  *  /  ^  %
+ *  Allowed operators: see the operators[] table above.
  *  Notes: For shell interpretation, enclose * / ^ % in quotes.
  * ========================================================================================= */
 
-int validate_arguments(int argc , char* argv[])
+static void print_usage(void)
 {
-    // Require exactly 4 arguments (program name + 3 inputs)
-    if(argc != 4)
-    {
-        printf("ERROR : Invalid Number of Arguments!\n");
-        printf("USAGE : ./a.out <num1> <operator> <num2>\n");
-        printf("Operations that can be performed: \n");
-        printf("+ --> Addition \n");
-        printf("- --> subtraction \n");
-        printf("* --> Multiplication \n");
-        printf("/ --> Division \n");
-        printf("^ --> Square \n");
-        printf("%% --> Modulus \n");
-        printf("Note: Use quotes for special symbols (*, /, ^, %%).\n");
-        return FAILURE;
+    apc_printf("USAGE : ./a.out <num1> <operator> <num2>\n");
+    apc_printf("        ./a.out <num> <operator>\n");
+    apc_printf("        ./a.out <acc> <addmul|submul> <num1> <num2>\n");
+    apc_printf("        ./a.out --tune [thresholds file]\n");
+    apc_printf("        ./a.out --profile <arguments...>  (JSON counters on stderr, also APC_PROFILE=1)\n");
+    apc_printf("        ./a.out [--precision N] [--rounding MODE] <num1> <operator> <num2>   (decimal operands)\n");
+    apc_printf("        rounding modes: half-even (default), half-up, half-down, down, up, ceiling, floor\n");
+    apc_printf("        ./a.out <p/q> <operator> <r/s>   (exact rational operands)\n");
+    apc_printf("        ./a.out --out-of-core [--memory MB] <file1> <+|-|*|cmp> <file2> [<result file>]\n");
+    apc_printf("        ./a.out [--rounds N] <num> isprime   (N extra Miller-Rabin rounds after Baillie-PSW)\n");
+    apc_printf("        ./a.out [--memory-limit MB] [--op-memory-limit MB] <arguments...>\n");
+    apc_printf("        ./a.out --serve <socket> [--threads N]   ./a.out --client <socket> <arguments...|->\n");
+    apc_printf("Operations that can be performed: \n");
+    for (size_t i = 0; i < sizeof(operators) / sizeof(operators[0]); i++)
+    {
+        apc_printf("%s --> %s \n", operators[i].symbol, operators[i].help);
     }
+    apc_printf("Note: Use quotes for special symbols (*, /, ^, %%).\n");
+}
 
-    // Validate both operands
-    if (check_sign(argv[1]) == FAILURE)
+int validate_arguments(int argc , char* argv[])
+{
+    // Require program name + operand + operator + up to two more operands (any number for list operators)
+    if(argc < 3 || (argc > 5 && operator_arity(argv[2]) != ARITY_LIST))
     {
-        printf("ERROR : Operand 1 failed validation ->  %s\n", argv[1]);
+        apc_printf("ERROR : Invalid Number of Arguments!\n");
+        print_usage();
+        return FAILURE;
     }
-    if (check_sign(argv[3]) == FAILURE)
+
+    // Validate operator and that it matches the number of operands given
+    int arity = operator_arity(argv[2]);
+    if (arity == FAILURE)
     {
-        printf("ERROR : Operand 2 failed validation ->  %s\n", argv[3]);
+        apc_printf("ERROR : Enter Only these Operators [");
+        for (size_t i = 0; i < sizeof(operators) / sizeof(operators[0]); i++)
+        {
+            apc_printf("%s%s", i ? "," : "", operators[i].symbol);
+        }
+        apc_printf("] \n");
+        return FAILURE;
     }
-    
-    // Validate operator
-    if (strcmp(argv[2], "+") != 0 && strcmp(argv[2], "-") != 0 && strcmp(argv[2], "*") != 0 && strcmp(argv[2], "/") != 0 && strcmp(argv[2], "^") != 0 && strcmp(argv[2], "%") != 0)
-    {
+    if (arity == ARITY_LIST ? argc < 4 : arity + 2 != argc)
     {
-        printf("ERROR : Enter Only these Operators [+,-,*,/,^,%%] \n");
+        if (arity == ARITY_LIST)
+            apc_printf("ERROR : Operator %s takes at least 2 operands!\n", argv[2]);
+        else
+            apc_printf("ERROR : Operator %s takes %d operands!\n", argv[2], arity);
+        print_usage();
         return FAILURE;
     }
+
+    // Validate every operand
+    for (int i = 1; i < argc; i++)
+    {
+        if (i == 2)
+            continue;
+        if (check_sign(argv[i]) == FAILURE)
+        {
+            apc_printf("ERROR : Operand %d failed validation ->  %s\n", (i == 1) ? 1 : i - 1, argv[i]);
+        }
     }
     return SUCCESS;
 }
@@ -137,26 +242,16 @@ int string_to_list(Dlist **head, Dlist **tail, char *str)
 {
     if (!str || *str == '\0')        // empty or NULL input
     {
-        printf("ERROR : Empty string input.\n");
+        apc_printf("ERROR : Empty string input.\n");
         return FAILURE;
     }
 
-    for (int i = 0; str[i] != '\0'; i++)
-    {
-        if (!isdigit(str[i]))       // reject non-digit characters
-        {
-            printf("ERROR : Invalid character '%c'\n", str[i]);
-            return FAILURE;
-        }
-
-        if (insert_at_end(head, tail, str[i] - '0') == FAILURE)
-        {
-            printf("ERROR : Node creation failed.\n");
-            return FAILURE;
-        }
-    }
+    // Long strings are split into chunks converted in parallel (convert.c)
+    PROFILE_BEGIN(PHASE_CONVERT);
+    int status = digits_to_list(str, strlen(str), head, tail);
+    PROFILE_END(PHASE_CONVERT);
 
-    return SUCCESS;
+    return status;
 }
 
 
@@ -171,11 +266,12 @@ int string_to_list(Dlist **head, Dlist **tail, char *str)
 int insert_at_end(Dlist **head, Dlist **tail, data_t data)
 {
     Dlist *newnode;
-    newnode = malloc(sizeof(Dlist));
+    newnode = node_alloc();
     if(newnode == NULL)
     {
         return FAILURE;
     }
+    PROFILE_ALLOC(sizeof(Dlist));
     newnode->data = data;
     newnode->next = NULL;
     newnode->prev = NULL;
@@ -208,11 +304,12 @@ int insert_at_end(Dlist **head, Dlist **tail, data_t data)
 int insert_at_begin(Dlist **head, Dlist **tail, data_t data)
 {
     Dlist *newnode;
-    newnode = malloc(sizeof(Dlist));
+    newnode = node_alloc();
     if(newnode == NULL)
     {
         return FAILURE;
     }
+    PROFILE_ALLOC(sizeof(Dlist));
     newnode->data = data;
     newnode->prev = NULL;
     newnode->next = *head;
@@ -233,29 +330,124 @@ int insert_at_begin(Dlist **head, Dlist **tail, data_t data)
 
 
 
+/* =========================================================================================
+ * Function: apc_printf
+ * -----------------------------------------------------------------------------------------
+ *  printf to the calculator output. apc_output is NULL (stdout) except in a --serve worker,
+ *  where it is the response buffer of the request being run (see server.c).
+ * ========================================================================================= */
+
+__thread FILE *apc_output;
+
+int apc_printf(const char *format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    int length = vfprintf(apc_output ? apc_output : stdout, format, args);
+    va_end(args);
+    return length;
+}
+
+
+/* Characters of the digits [begin, end); begin is a multiple of CONVERT_GRAIN */
+static void print_chunk(void *arg, int chunk, long begin, long end)
+{
+    (void)chunk;
+    PrintJob *job = arg;
+    Dlist *temp = job->start[begin / CONVERT_GRAIN];
+    for (long i = begin; i < end; i++)
+    {
+        job->out[i] = '0' + temp->data;
+        temp = temp->next;
+    }
+}
+
+/* Writes the digits from `first` on with one thread per chunk; FAILURE, having written nothing, if the list is
+ * too short to split or the buffers do not fit (the caller then prints it in one pass) */
+static int print_parallel(Dlist *first, FILE *out)
+{
+    PrintJob job = { NULL, NULL };
+    long length = 0, grains = 0, room = 0;
+    int status = SUCCESS;
+
+    // One walk records where every chunk may start
+    for (Dlist *temp = first; temp != NULL && status == SUCCESS; temp = temp->next, length++)
+    {
+        if (length % CONVERT_GRAIN != 0)
+            continue;
+        if (grains == room)
+        {
+            room = room ? 2 * room : 64;
+            Dlist **start = apc_realloc(job.start, room * sizeof(Dlist *));
+            if (start == NULL)
+                status = FAILURE;
+            else
+                job.start = start;
+        }
+        if (status == SUCCESS)
+            job.start[grains++] = temp;
+    }
+
+    int threads = convert_threads(length, CONVERT_GRAIN, 0);
+    if (status == SUCCESS && threads > 1)
+    {
+        job.out = ((size_t)length < memory_available()) ? apc_malloc(length) : NULL;
+        status = (job.out != NULL) ? SUCCESS : FAILURE;
+    }
+    else
+    {
+        status = FAILURE;
+    }
+    if (status == SUCCESS)
+    {
+        convert_run(length, CONVERT_GRAIN, threads, print_chunk, &job);
+        fwrite(job.out, 1, length, out);
+    }
+    apc_free(job.out);
+    apc_free(job.start);
+    return status;
+}
+
+
 /* =========================================================================================
  * Function: print_list
  * -----------------------------------------------------------------------------------------
- *  Prints all digits in the linked list (head → tail order).
- *  Displays an error if the list is empty.
+ *  Prints all digits in the linked list (head → tail order), skipping leading zeros.
+ *  Displays an error if the list is empty. With more than one CPU, lists longer than one
+ *  conversion grain are formatted in parallel chunks into one buffer (convert.c).
  * ========================================================================================= */
 
 void print_list(Dlist *head)
 {
     if (head == NULL)               // no digits to print
     {
-        printf("ERROR : Empty list\n");
+        apc_printf("ERROR : Empty list\n");
         return;
     }
-    Dlist *temp = head;
+    Dlist *temp = skip_leading_zeros(head);
+    FILE *out = apc_output ? apc_output : stdout;
 
-    while (temp != NULL)            // iterate list
+    PROFILE_BEGIN(PHASE_PRINT);
+    // Only a machine that can split two grains is worth the walk that records the chunk starts
+    if (convert_threads(2 * CONVERT_GRAIN, CONVERT_GRAIN, 0) == 1 || print_parallel(temp, out) == FAILURE)
     {
-        printf("%d", temp->data);   // print digit
-        temp = temp->next;          // move forward
+        char block[PRINT_BLOCK];    // digits go out a block at a time, not one putc each
+        int used = 0;
+        while (temp != NULL)        // iterate list
+        {
+            block[used++] = '0' + temp->data;
+            if (used == PRINT_BLOCK)
+            {
+                fwrite(block, 1, used, out);
+                used = 0;
+            }
+            temp = temp->next;      // move forward
+        }
+        fwrite(block, 1, used, out);
     }
 
-    printf("\n");                   // end of output
+    putc('\n', out);                // end of output
+    PROFILE_END(PHASE_PRINT);
 }
 
 
@@ -279,10 +471,29 @@ int find_length(Dlist *head)
 }
 
 
+/* =========================================================================================
+ * Function: skip_leading_zeros
+ * -----------------------------------------------------------------------------------------
+ *  Returns the first significant node of a number (its last node if the value is zero)
+ *  without freeing anything. Kernels may leave leading zeros in their results; readers
+ *  that compare, print or convert a number look through them with this instead of
+ *  normalizing the list after every step.
+ * ========================================================================================= */
+
+Dlist *skip_leading_zeros(Dlist *head)
+{
+    while(head && head->next && head->data == 0)
+        head = head->next;
+    return head;
+}
+
+
 /* =========================================================================================
  * Function: compare_numbers
  * -----------------------------------------------------------------------------------------
- *  Compares two numbers represented as doubly linked lists.
+ *  Compares two numbers represented as doubly linked lists. Leading zeros are ignored.
+ *  Both lists are walked once, side by side: the longer significant part is larger,
+ *  otherwise the first differing digit decides.
  *
  *  Returns:
  *     GREATER (1) if h1 > h2
@@ -292,40 +503,29 @@ int find_length(Dlist *head)
 
 int compare_numbers(Dlist *h1, Dlist *h2)
 {
-    // Compare based on length first
-    if(find_length(h1) > find_length(h2))
+    Dlist *p1 = skip_leading_zeros(h1), *p2 = skip_leading_zeros(h2);
+    int first_difference = EQUAL;
+
+    while(p1 && p2)
     {
-        return GREATER;
+        if(first_difference == EQUAL && p1->data != p2->data)
+        {
+            first_difference = (p1->data > p2->data) ? GREATER : LESS;
+        }
+        p1 = p1->next;
+        p2 = p2->next;
     }
 
-    else if(find_length(h1) < find_length(h2))
+    // The longer significant part is the larger number
+    if(p1)
     {
-        return LESS;
+        return GREATER;
     }
-
-    else
+    if(p2)
     {
-        // Compare digit by digit if lengths are equal
-        Dlist *p1 = h1, *p2 = h2;
-        while(p1 && p2)
-        {
-            if(p1->data > p2->data)
-            {
-                return GREATER;
-            }
-            else if(p1->data < p2->data)
-            {
-                return LESS;
-            }
-            else
-            {
-                p1 = p1->next;
-                p2 = p2->next;
-            }
-        }
-
-        return EQUAL;
+        return LESS;
     }
+    return first_difference;
 }
 
 /****************************************************************************************************
@@ -340,14 +540,17 @@ void remove_leading_zeros(Dlist **head)
     if(*head == NULL)       // nothing to clean
     return;
 
+    PROFILE_BEGIN(PHASE_NORMALIZE);
     // delete zeros while more digits follow
     while((*head)->next && (*head)->data == 0)
     {
         Dlist *temp = *head;
         *head = (*head)->next;             // move head forward
         (*head)->prev = NULL;              // fix backward link
-        free(temp);                        // free old zero node
+        node_free(temp);                       // free old zero node
+        PROFILE_FREE(1);
     }
+    PROFILE_END(PHASE_NORMALIZE);
 
     // if single node AND it is zero → keep it (represents number 0)
     if((*head)->next == NULL && (*head)->data == 0)
@@ -393,10 +596,187 @@ int delete_list(Dlist **head, Dlist **tail)
     while(temp)
     {
         Dlist *next = temp->next;   // Save next pointer
-        free(temp);                 // Free current node
+        node_free(temp);                // Free current node
+        PROFILE_FREE(1);
         temp = next;                // Move ahead
     }
     *head = NULL;                   // Reset head
     *tail = NULL;                   // Reset tail
     return SUCCESS;
-}
\ No newline at end of file
+}
+
+/*****************************************************************************************
+ * Function: free_lists
+ * ------------------------
+ * Deletes `count` lists given by their heads (NULL entries are skipped) and resets each
+ * head to NULL. The array itself is not freed.
+ *****************************************************************************************/
+
+void free_lists(Dlist **heads, int count)
+{
+    for(int i = 0; i < count; i++)
+    {
+        Dlist *tail = NULL;
+        list_release(&heads[i], &tail);
+    }
+}
+/*****************************************************************************************
+ * Function: list_to_array
+ * ------------------------
+ * Copies the digits of a list into a newly allocated array, least significant digit
+ * first (digits[0] is the units digit), without leading zeros. Used by the array based kernels.
+ * head    : First node of the number.
+ * digits  : Receives the allocated array (caller frees).
+ * length  : Receives the number of digits.
+ * Returns SUCCESS, or FAILURE if the list is empty or allocation fails.
+ *****************************************************************************************/
+
+int list_to_array(Dlist *head, data_t **digits, int *length)
+{
+    head = skip_leading_zeros(head);
+    int n = find_length(head);
+    if(n == 0)
+        return FAILURE;
+
+    *digits = apc_malloc(n * sizeof(data_t));
+    if(*digits == NULL)
+        return FAILURE;
+    PROFILE_ALLOC(n * sizeof(data_t));
+
+    for(int i = n - 1; head; i--, head = head->next)
+        (*digits)[i] = head->data;
+
+    *length = n;
+    return SUCCESS;
+}
+
+/*****************************************************************************************
+ * Function: array_to_list
+ * ------------------------
+ * Builds a list from a digit array stored least significant digit first.
+ * Leading zeros are not copied (a zero value becomes a single 0 node).
+ * Returns SUCCESS, or FAILURE if node creation fails.
+ *****************************************************************************************/
+
+int array_to_list(const data_t *digits, int length, Dlist **head, Dlist **tail)
+{
+    while(length > 1 && digits[length - 1] == 0)    // skip leading zeros
+        length--;
+
+    for(int i = 0; i < length; i++)
+    {
+        if(insert_at_begin(head, tail, digits[i]) == FAILURE)
+        {
+            delete_list(head, tail);
+            return FAILURE;
+        }
+    }
+    return SUCCESS;
+}
+
+/*****************************************************************************************
+ * Function: columns_to_list
+ * --------------------------
+ * Resolves an array of column sums (least significant column first, each column may
+ * hold any non-negative value) into a normalized digit list with one carry pass.
+ * Returns SUCCESS, or FAILURE if node creation fails.
+ *****************************************************************************************/
+
+int columns_to_list(const long long *columns, int length, Dlist **head, Dlist **tail)
+{
+    long long carry = 0;
+
+    for(int k = 0; k < length || carry != 0; k++)
+    {
+        long long sum = carry + ((k < length) ? columns[k] : 0);
+        if(insert_at_begin(head, tail, sum % 10) == FAILURE)
+        {
+            delete_list(head, tail);
+            return FAILURE;
+        }
+        carry = sum / 10;
+    }
+    remove_leading_zeros(head);
+    return SUCCESS;
+}
+
+/*****************************************************************************************
+ * Function: long_to_list / list_to_long
+ * --------------------------------------
+ * Conversions between a non-negative machine integer and a digit list.
+ * list_to_long returns FAILURE if the number does not fit in 18 digits.
+ *****************************************************************************************/
+
+int long_to_list(long long value, Dlist **head, Dlist **tail)
+{
+    do
+    {
+        if(insert_at_begin(head, tail, value % 10) == FAILURE)
+        {
+            delete_list(head, tail);
+            return FAILURE;
+        }
+        value /= 10;
+    }while(value > 0);
+    return SUCCESS;
+}
+
+int list_to_long(Dlist *head, long long *value)
+{
+    while(head && head->next && head->data == 0)    // skip leading zeros
+        head = head->next;
+    if(head == NULL || find_length(head) > 18)
+        return FAILURE;
+
+    *value = 0;
+    for(; head; head = head->next)
+        *value = *value * 10 + head->data;
+    return SUCCESS;
+}
+
+/*****************************************************************************************
+ * Function: divide_by_small
+ * --------------------------
+ * Divides the number in place by a small positive integer (one pass from the head) and
+ * strips the leading zeros of the quotient. Returns the remainder.
+ *****************************************************************************************/
+
+long long divide_by_small(Dlist **head, long long divisor)
+{
+    long long rem = 0;
+    for(Dlist *p = *head; p; p = p->next)
+    {
+        long long cur = rem * 10 + p->data;
+        p->data = cur / divisor;
+        rem = cur % divisor;
+    }
+    remove_leading_zeros(head);
+    return rem;
+}
+
+/*****************************************************************************************
+ * Function: list_tail / copy_list
+ * --------------------------------
+ * list_tail returns the last node of a list (kernels only hand back the head).
+ * copy_list appends a copy of every digit of `head` to the list headR/tailR.
+ *****************************************************************************************/
+
+Dlist *list_tail(Dlist *head)
+{
+    while(head && head->next)
+        head = head->next;
+    return head;
+}
+
+int copy_list(Dlist *head, Dlist **headR, Dlist **tailR)
+{
+    for(; head; head = head->next)
+    {
+        if(insert_at_end(headR, tailR, head->data) == FAILURE)
+        {
+            delete_list(headR, tailR);
+            return FAILURE;
+        }
+    }
+    return SUCCESS;
+}
@@ -0,0 +1,352 @@
+/*******************************************************************************************************************************************************************
+ * Function: KARATSUBA MULTIPLICATION / SQUARE
+ * -------------------------------------------
+ *  Sub-quadratic multiplication of two large numbers represented as doubly linked lists.
+ *
+ *  The digits are copied into arrays and multiplied as polynomials in 10 (no carries
+ *  inside the recursion). Each operand is split into a low half (h digits) and a high
+ *  half, and three half-size products replace the four of long multiplication:
+ *
+ *     z0 = a0 × b0
+ *     z2 = a1 × b1
+ *     z1 = (a0 + a1) × (b0 + b1) - z0 - z2
+ *     A × B = z2·x^2h + z1·x^h + z0
+ *
+ *  Below the Karatsuba threshold of the kernel registry the recursion falls back to
+ *  column (schoolbook) multiplication. All carries are resolved once at the end by
+ *  columns_to_list(). The schoolbook rows go in blocks of four (poly_addmul_basecase):
+ *  the four products landing in one column are summed in registers, so each column is
+ *  loaded and stored once per block instead of once per row. mul_basecase (addmul.c)
+ *  and sqr_basecase (square.c) run on the same rows.
+ *
+ *  Unbalanced operands (one at least UNBALANCED_RATIO times longer than the other) are
+ *  not padded to a common length: the long operand is cut into chunks as long as the
+ *  short one, each chunk × short operand is a balanced product, and the chunk products
+ *  are added into one column array at their offsets before the single carry pass.
+ *
+ *  Parameters:
+ *     head1, tail1 → pointers to first and last node of first number
+ *     head2, tail2 → pointers to first and last node of second number
+ *     headR        → pointer to the head of result list (stores result)
+ *
+ *  Returns:
+ *     SUCCESS (0) if multiplication succeeds
+ *     FAILURE (-1) if any error occurs
+ *
+*******************************************************************************************************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "apc.h"
+
+/* Smallest size the recursion is allowed to split, whatever the tuned threshold says */
+#define KARATSUBA_MIN_SPLIT 8
+
+/* Products whose longer operand is at least this many times the shorter go through poly_unbalanced */
+#define UNBALANCED_RATIO 2
+
+/*
+ * Schoolbook rows: out[0 .. la+lb-2] += a × b. Rows of a go in blocks of four, the four products
+ * of a column summed before one load and store of out[]; the rows left over (and every row when b
+ * is shorter than four) take the plain row loop.
+ */
+void poly_addmul_basecase(const long long *a, int la, const long long *b, int lb, long long *out)
+{
+	int i = 0;
+	for(; lb >= 4 && i + 4 <= la; i += 4)
+	{
+		long long a0 = a[i], a1 = a[i + 1], a2 = a[i + 2], a3 = a[i + 3];
+		long long *o = out + i;
+		if((a0 | a1 | a2 | a3) == 0)
+			continue;
+
+		o[0] += a0 * b[0];
+		o[1] += a0 * b[1] + a1 * b[0];
+		o[2] += a0 * b[2] + a1 * b[1] + a2 * b[0];
+		for(int k = 3; k < lb; k++)
+		{
+			o[k] += a0 * b[k] + a1 * b[k - 1] + a2 * b[k - 2] + a3 * b[k - 3];
+		}
+		o[lb] += a1 * b[lb - 1] + a2 * b[lb - 2] + a3 * b[lb - 3];
+		o[lb + 1] += a2 * b[lb - 1] + a3 * b[lb - 2];
+		o[lb + 2] += a3 * b[lb - 1];
+	}
+	for(; i < la; i++)
+	{
+		if(a[i] == 0)
+			continue;
+		for(int j = 0; j < lb; j++)
+		{
+			out[i + j] += a[i] * b[j];
+		}
+	}
+}
+
+/* Schoolbook polynomial product: out[0 .. 2n-2] = a × b */
+static void poly_mul_basecase(const long long *a, const long long *b, int n, long long *out)
+{
+	memset(out, 0, (2 * n - 1) * sizeof(long long));
+	poly_addmul_basecase(a, n, b, n, out);
+}
+
+/*
+ * Schoolbook polynomial square using symmetry: out[0 .. 2n-2] = a². Every cross product is
+ * computed once: a block of four coefficients times the coefficients above it is one call of
+ * the blocked rows, the six products inside the block are added directly.
+ */
+void poly_sqr_basecase(const long long *a, int n, long long *out)
+{
+	memset(out, 0, (2 * n - 1) * sizeof(long long));
+	for(int i = 0; i < n; i += 4)
+	{
+		int width = (n - i < 4) ? n - i : 4;
+		for(int p = 0; p < width; p++)
+		{
+			for(int q = p + 1; q < width; q++)
+			{
+				out[2 * i + p + q] += a[i + p] * a[i + q];
+			}
+		}
+		if(i + width < n)
+		{
+			poly_addmul_basecase(a + i, width, a + i + width, n - i - width, out + 2 * i + width);
+		}
+	}
+	for(int k = 0; k < 2 * n - 1; k++)
+	{
+		out[k] *= 2;
+	}
+	for(int i = 0; i < n; i++)
+	{
+		out[2 * i] += a[i] * a[i];
+	}
+}
+
+/*
+ * out[0 .. 2n-2] = a × b for two n-coefficient polynomials (b == a squares).
+ * Returns SUCCESS, or FAILURE on allocation failure.
+ */
+static int poly_karatsuba(const long long *a, const long long *b, int n, long long *out, int cutoff)
+{
+	int squaring = (a == b);
+
+	if(n < cutoff || n < KARATSUBA_MIN_SPLIT)
+	{
+		if(squaring)
+			poly_sqr_basecase(a, n, out);
+		else
+			poly_mul_basecase(a, b, n, out);
+		return SUCCESS;
+	}
+
+	int h = n / 2;          // low half length
+	int k = n - h;          // high half length (k >= h)
+
+	// sa, sb: k coefficients each; z1: 2k-1 coefficients
+	long long *buffer = apc_calloc(4 * k, sizeof(long long));
+	if(buffer == NULL)
+	{
+		return FAILURE;
+	}
+	PROFILE_ALLOC(4 * k * sizeof(long long));
+	long long *sa = buffer;
+	long long *sb = squaring ? sa : buffer + k;
+	long long *z1 = buffer + 2 * k;
+
+	for(int i = 0; i < k; i++)
+	{
+		sa[i] = a[h + i] + ((i < h) ? a[i] : 0);
+		if(!squaring)
+			sb[i] = b[h + i] + ((i < h) ? b[i] : 0);
+	}
+
+	// z0 → out[0 .. 2h-2], z2 → out[2h .. 2n-2]; slot out[2h-1] lies between them
+	memset(out, 0, (2 * n - 1) * sizeof(long long));
+	if(poly_karatsuba(a, squaring ? a : b, h, out, cutoff) == FAILURE ||
+	   poly_karatsuba(a + h, squaring ? a + h : b + h, k, out + 2 * h, cutoff) == FAILURE ||
+	   poly_karatsuba(sa, sb, k, z1, cutoff) == FAILURE)
+	{
+		apc_free(buffer);
+		return FAILURE;
+	}
+
+	// z1 -= z0 + z2
+	for(int i = 0; i < 2 * h - 1; i++)
+	{
+		z1[i] -= out[i];
+	}
+	for(int i = 0; i < 2 * k - 1; i++)
+	{
+		z1[i] -= out[2 * h + i];
+	}
+
+	// out += z1 · x^h
+	for(int i = 0; i < 2 * k - 1; i++)
+	{
+		out[h + i] += z1[i];
+	}
+
+	apc_free(buffer);
+	return SUCCESS;
+}
+
+/*
+ * out[0 .. la+lb-2] = a × b for la >= lb, in chunks of lb coefficients of a. The last chunk
+ * is zero-padded to lb; the zero coefficients it adds beyond la+lb-2 are not copied.
+ * Returns SUCCESS, or FAILURE on allocation failure.
+ */
+static int poly_unbalanced(const long long *a, int la, const long long *b, int lb, long long *out, int cutoff)
+{
+	long long *chunk = apc_calloc(lb, sizeof(long long));
+	long long *part = apc_malloc((2 * lb - 1) * sizeof(long long));
+	if(chunk == NULL || part == NULL)
+	{
+		apc_free(chunk);
+		apc_free(part);
+		return FAILURE;
+	}
+	PROFILE_ALLOC((3 * lb - 1) * sizeof(long long));
+
+	int status = SUCCESS;
+	memset(out, 0, (la + lb - 1) * sizeof(long long));
+	for(int offset = 0; offset < la && status == SUCCESS; offset += lb)
+	{
+		int length = (la - offset < lb) ? la - offset : lb;
+		const long long *source = a + offset;
+		if(length < lb)
+		{
+			memcpy(chunk, source, length * sizeof(long long));
+			source = chunk;
+		}
+		status = poly_karatsuba(source, b, lb, part, cutoff);
+
+		int count = length + lb - 1;
+		for(int i = 0; i < count && status == SUCCESS; i++)
+		{
+			out[offset + i] += part[i];
+		}
+	}
+
+	apc_free(chunk);
+	apc_free(part);
+	return status;
+}
+
+/*
+ * out[0 .. la+lb-2] = a × b for any la, lb >= 1 (b == a with la == lb squares). The shorter operand
+ * is zero-padded to the longer one for poly_karatsuba, or the longer one is chunked when unbalanced.
+ * Returns SUCCESS, or FAILURE on allocation failure.
+ */
+int poly_mul(const long long *a, int la, const long long *b, int lb, long long *out, int cutoff)
+{
+	if(la < lb)
+	{
+		const long long *t = a; a = b; b = t;
+		int l = la; la = lb; lb = l;
+	}
+	if(la >= UNBALANCED_RATIO * lb)
+	{
+		return poly_unbalanced(a, la, b, lb, out, cutoff);
+	}
+	if(la == lb)
+	{
+		return poly_karatsuba(a, b, la, out, cutoff);
+	}
+
+	// b padded to la coefficients; its product has 2la-1 columns, the top la-lb of them zero
+	long long *padded = apc_calloc(la + 2 * la - 1, sizeof(long long));
+	if(padded == NULL)
+	{
+		return FAILURE;
+	}
+	PROFILE_ALLOC((3 * la - 1) * sizeof(long long));
+	long long *full = padded + la;
+	memcpy(padded, b, lb * sizeof(long long));
+	int status = poly_karatsuba(a, padded, la, full, cutoff);
+	if(status == SUCCESS)
+	{
+		memcpy(out, full, (la + lb - 1) * sizeof(long long));
+	}
+	apc_free(padded);
+	return status;
+}
+
+/* Copy a list into a zero-padded coefficient array of n entries (least significant first) */
+static long long *list_to_coeffs(Dlist *tail, int n)
+{
+	long long *coeffs = apc_calloc(n, sizeof(long long));
+	if(coeffs == NULL)
+	{
+		return NULL;
+	}
+	PROFILE_ALLOC(n * sizeof(long long));
+	for(int i = 0; tail; i++, tail = tail->prev)
+	{
+		coeffs[i] = tail->data;
+	}
+	return coeffs;
+}
+
+/* Shared driver: squares when the second operand is NULL */
+static int karatsuba_product(Dlist *head1, Dlist *tail1, Dlist *head2, Dlist *tail2, Dlist **headR, const char *family)
+{
+	int len1 = find_length(head1);
+	int len2 = head2 ? find_length(head2) : 0;
+	int n = (len1 > len2) ? len1 : len2;
+	int cutoff = kernel_threshold(family, "karatsuba");
+
+	// Long operand first; a short one far below it is multiplied chunk by chunk, without padding
+	if(head2 && len1 < len2)
+	{
+		Dlist *t = tail1; tail1 = tail2; tail2 = t;
+		int l = len1; len1 = len2; len2 = l;
+	}
+	int unbalanced = head2 && len1 >= UNBALANCED_RATIO * len2;
+	int length = unbalanced ? len1 + len2 - 1 : 2 * n - 1;
+
+	long long *a = list_to_coeffs(tail1, n);
+	long long *b = head2 ? list_to_coeffs(tail2, unbalanced ? len2 : n) : a;
+	long long *out = apc_malloc(length * sizeof(long long));
+	PROFILE_ALLOC(length * sizeof(long long));
+
+	if(a == NULL || b == NULL || out == NULL ||
+	   (unbalanced ? poly_unbalanced(a, len1, b, len2, out, cutoff) : poly_karatsuba(a, b, n, out, cutoff)) == FAILURE)
+	{
+		apc_printf("ERROR : Failed to allocate the Karatsuba buffers. \n");
+		if(b != a)
+			apc_free(b);
+		apc_free(a);
+		apc_free(out);
+		return FAILURE;
+	}
+
+	Dlist *tailR = NULL;
+	int status = columns_to_list(out, length, headR, &tailR);
+
+	if(b != a)
+		apc_free(b);
+	apc_free(a);
+	apc_free(out);
+	return status;
+}
+
+int mul_karatsuba(Dlist **head1, Dlist **tail1, Dlist **head2, Dlist **tail2, Dlist **headR)
+{
+	if(*head1 == NULL || *head2 == NULL)
+	{
+		apc_printf("ERROR : One or Both input Lists are Empty! \n");
+		return FAILURE;
+	}
+	return karatsuba_product(*head1, *tail1, *head2, *tail2, headR, "mul");
+}
+
+int sqr_karatsuba(Dlist **head1, Dlist **tail1, Dlist **headR)
+{
+	if(*head1 == NULL)
+	{
+		apc_printf("ERROR : Input list is Empty! \n");
+		return FAILURE;
+	}
+	return karatsuba_product(*head1, *tail1, NULL, NULL, headR, "sqr");
+}
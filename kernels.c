@@ -0,0 +1,198 @@
+/*******************************************************************************************************************************************************************
+ * Kernel registry
+ * ---------------
+ *  multiplication(), square(), division(), modulus() and gcd() do not call a fixed algorithm; they ask the registry
+ *  for the kernel that suits the operand size. Each family lists its kernels from the smallest to the largest
+ *  sizes they are meant for, together with the size (in digits) from which each kernel takes over:
+ *
+ *     mul : mul_basecase   → mul_karatsuba
+ *     sqr : sqr_basecase   → sqr_karatsuba
+ *     div : div_subtract   → div_schoolbook
+ *     mod : mod_subtract   → mod_schoolbook
+ *     gcd : gcd_lehmer     → gcd_hgcd
+ *
+ *  The crossover sizes depend on the host, so the compiled-in defaults can be replaced by a thresholds file
+ *  written by `apc --tune` (see tune.c). The file is looked up in $APC_THRESHOLDS, then ./apc_thresholds.conf,
+ *  and holds one "<family> <kernel> <min_digits>" line per kernel.
+*******************************************************************************************************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "apc.h"
+
+#define THRESHOLDS_FILE "apc_thresholds.conf"
+#define MAX_LINE        128
+
+static kernel_t mul_kernels[] =
+{
+    { "basecase",  mul_basecase,   NULL,          0  },
+    { "karatsuba", mul_karatsuba,  NULL,          48 },
+};
+
+static kernel_t sqr_kernels[] =
+{
+    { "basecase",  NULL,           sqr_basecase,  0  },
+    { "karatsuba", NULL,           sqr_karatsuba, 64 },
+};
+
+static kernel_t div_kernels[] =
+{
+    { "subtract",   div_subtract,   NULL,         0 },
+    { "schoolbook", div_schoolbook, NULL,         1 },
+};
+
+static kernel_t mod_kernels[] =
+{
+    { "subtract",   mod_subtract,   NULL,         0 },
+    { "schoolbook", mod_schoolbook, NULL,         1 },
+};
+
+static kernel_t gcd_kernels[] =
+{
+    { "lehmer",     gcd_lehmer,     NULL,         0    },
+    { "hgcd",       gcd_hgcd,       NULL,         50000 },
+};
+
+static kernel_family families[] =
+{
+    { "mul", mul_kernels, sizeof(mul_kernels) / sizeof(mul_kernels[0]) },
+    { "sqr", sqr_kernels, sizeof(sqr_kernels) / sizeof(sqr_kernels[0]) },
+    { "div", div_kernels, sizeof(div_kernels) / sizeof(div_kernels[0]) },
+    { "mod", mod_kernels, sizeof(mod_kernels) / sizeof(mod_kernels[0]) },
+    { "gcd", gcd_kernels, sizeof(gcd_kernels) / sizeof(gcd_kernels[0]) },
+};
+
+/* Look up a kernel family by name; NULL if unknown */
+kernel_family *find_family(const char *family)
+{
+    for(size_t i = 0; i < sizeof(families) / sizeof(families[0]); i++)
+    {
+        if(strcmp(families[i].name, family) == 0)
+        {
+            return &families[i];
+        }
+    }
+    return NULL;
+}
+
+/* Look up a kernel inside a family; NULL if unknown */
+kernel_t *find_kernel(const char *family, const char *name)
+{
+    kernel_family *f = find_family(family);
+    for(int i = 0; f && i < f->count; i++)
+    {
+        if(strcmp(f->kernels[i].name, name) == 0)
+        {
+            return &f->kernels[i];
+        }
+    }
+    return NULL;
+}
+
+/* =========================================================================================
+ * Function: select_kernel
+ * -----------------------------------------------------------------------------------------
+ *  Returns the kernel of `family` with the largest threshold not above `size` digits.
+ *  The first kernel of every family has threshold 0, so a kernel is always returned.
+ * ========================================================================================= */
+
+const kernel_t *select_kernel(const char *family, int size)
+{
+    load_thresholds(NULL);
+
+    kernel_family *f = find_family(family);
+    const kernel_t *best = &f->kernels[0];
+
+    for(int i = 1; i < f->count; i++)
+    {
+        if(size >= f->kernels[i].threshold && f->kernels[i].threshold >= best->threshold)
+        {
+            best = &f->kernels[i];
+        }
+    }
+    PROFILE_KERNEL(f->name, best->name, size);
+    return best;
+}
+
+/* Threshold (digits) of one kernel, used by recursive kernels to find their base case */
+int kernel_threshold(const char *family, const char *name)
+{
+    kernel_t *k = find_kernel(family, name);
+    return k ? k->threshold : 0;
+}
+
+/* Path of the thresholds file: $APC_THRESHOLDS or ./apc_thresholds.conf */
+const char *thresholds_path(void)
+{
+    const char *path = getenv("APC_THRESHOLDS");
+    return (path && *path) ? path : THRESHOLDS_FILE;
+}
+
+/* =========================================================================================
+ * Function: load_thresholds
+ * -----------------------------------------------------------------------------------------
+ *  Reads "<family> <kernel> <min_digits>" lines into the registry. Only the first call
+ *  does any work; a missing file keeps the compiled-in defaults.
+ *  path : file to read, or NULL for thresholds_path().
+ *  Returns SUCCESS if the file was read, FAILURE if it was missing or already loaded.
+ * ========================================================================================= */
+
+int load_thresholds(const char *path)
+{
+    static int loaded = 0;
+    if(loaded)
+    {
+        return FAILURE;
+    }
+    loaded = 1;
+
+    FILE *fp = fopen(path ? path : thresholds_path(), "r");
+    if(fp == NULL)
+    {
+        return FAILURE;
+    }
+
+    char line[MAX_LINE], family[16], name[32];
+    int threshold;
+    while(fgets(line, sizeof(line), fp))
+    {
+        if(line[0] == '#')
+        {
+            continue;
+        }
+        if(sscanf(line, "%15s %31s %d", family, name, &threshold) == 3)
+        {
+            kernel_t *k = find_kernel(family, name);
+            if(k && threshold >= 0 && k != &find_family(family)->kernels[0])
+            {
+                k->threshold = threshold;
+            }
+        }
+    }
+    fclose(fp);
+    return SUCCESS;
+}
+
+/* Write the current registry thresholds to `path`; returns SUCCESS or FAILURE */
+int save_thresholds(const char *path)
+{
+    FILE *fp = fopen(path, "w");
+    if(fp == NULL)
+    {
+        apc_printf("ERROR : Cannot write thresholds file %s\n", path);
+        return FAILURE;
+    }
+
+    fprintf(fp, "# APC kernel thresholds, generated by apc --tune\n");
+    fprintf(fp, "# <family> <kernel> <min_digits>\n");
+    for(size_t i = 0; i < sizeof(families) / sizeof(families[0]); i++)
+    {
+        for(int j = 0; j < families[i].count; j++)
+        {
+            fprintf(fp, "%s %s %d\n", families[i].name, families[i].kernels[j].name, families[i].kernels[j].threshold);
+        }
+    }
+    fclose(fp);
+    return SUCCESS;
+}
@@ -0,0 +1,762 @@
+/*******************************************************************************************************************************************************************
+ * Limb arithmetic
+ * ---------------
+ *  Number-theoretic operations (gcd, xgcd, invmod) run long chains of multiplications and divisions on the same
+ *  operands, where walking one-digit nodes would dominate the cost. They convert the lists once into limb arrays
+ *  and work there:
+ *
+ *     Limbs : d[0 .. n-1] little-endian limbs in base 10^9 (LIMB_BASE), n == 0 represents zero
+ *
+ *  Base 10^9 keeps the conversion to and from the decimal lists a plain regrouping of digits, while a limb
+ *  product (< 10^18) plus carries still fits in 64 bits.
+ *
+ *     limbs_from_list / limbs_to_list : conversions to and from digit lists
+ *     limbs_from_string                : digit string (no sign) to limbs, without a list
+ *     limbs_print_result               : "Result          : ±value" straight from limbs
+ *                                        (limbs_to_list, limbs_from_string and limbs_print_result convert long
+ *                                        numbers in limb ranges on parallel threads, convert.c)
+ *     limbs_add / limbs_sub            : r = a + b, r = a - b (a >= b)
+ *     limbs_mul                        : r = a × b, column multiplication, Karatsuba from LIMBS_KARATSUBA limbs
+ *                                        (squares when a and b are the same number)
+ *     limbs_lincomb                    : r = a·p + b·q for single-limb p, q
+ *     limbs_divmod                     : q = a / b, r = a % b (Knuth long division on limbs)
+ *     limbs_divmod_small               : q = a / d, returns a % d for a single-word d
+ *
+ *  Every function writing a result `r` builds it in a new buffer and then replaces r's old buffer, so r may
+ *  alias an operand. Functions return SUCCESS, or FAILURE when memory allocation fails.
+*******************************************************************************************************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "apc.h"
+
+/* Balanced products from this many limbs are split by Karatsuba */
+#define LIMBS_KARATSUBA 32
+
+/* Rows of a column multiplication summed before one carry: 8 products < 8·10^18, plus a limb and a carry, fit in 64 bits */
+#define LIMBS_BLOCK 8
+
+/* Zeroed buffer of `size` limbs (at least one) */
+static uint32_t *limbs_buffer(int size)
+{
+	if(size < 1)
+	{
+		size = 1;
+	}
+	uint32_t *d = apc_calloc(size, sizeof(uint32_t));
+	if(d != NULL)
+	{
+		PROFILE_ALLOC(size * sizeof(uint32_t));
+	}
+	return d;
+}
+
+/* Replace the buffer of r by d holding n limbs, trimmed */
+static void limbs_assign(Limbs *r, uint32_t *d, int n)
+{
+	apc_free(r->d);
+	r->d = d;
+	r->n = n;
+	limbs_trim(r);
+}
+
+void limbs_trim(Limbs *x)
+{
+	while(x->n > 0 && x->d[x->n - 1] == 0)
+	{
+		x->n--;
+	}
+}
+
+void limbs_free(Limbs *x)
+{
+	apc_free(x->d);
+	x->d = NULL;
+	x->n = 0;
+}
+
+int limbs_set_small(Limbs *x, uint32_t value)
+{
+	uint32_t *d = limbs_buffer(1);
+	if(d == NULL)
+	{
+		return FAILURE;
+	}
+	d[0] = value;
+	limbs_assign(x, d, 1);
+	return SUCCESS;
+}
+
+int limbs_copy(const Limbs *src, Limbs *dst)
+{
+	uint32_t *d = limbs_buffer(src->n);
+	if(d == NULL)
+	{
+		return FAILURE;
+	}
+	if(src->n > 0)
+	{
+		memcpy(d, src->d, src->n * sizeof(uint32_t));
+	}
+	limbs_assign(dst, d, src->n);
+	return SUCCESS;
+}
+
+/* Values below LIMB_BASE^2 (10^18) fit in two limbs and in a machine word */
+int limbs_set_u64(Limbs *x, uint64_t value)
+{
+	uint32_t *d = limbs_buffer(3);
+	if(d == NULL)
+	{
+		return FAILURE;
+	}
+	for(int i = 0; i < 3; i++)
+	{
+		d[i] = value % LIMB_BASE;
+		value /= LIMB_BASE;
+	}
+	limbs_assign(x, d, 3);
+	return SUCCESS;
+}
+
+uint64_t limbs_to_u64(const Limbs *x)
+{
+	uint64_t value = 0;
+	for(int i = (x->n < 3 ? x->n : 3) - 1; i >= 0; i--)
+	{
+		value = value * LIMB_BASE + x->d[i];
+	}
+	return value;
+}
+
+int limbs_cmp(const Limbs *a, const Limbs *b)
+{
+	if(a->n != b->n)
+	{
+		return (a->n > b->n) ? GREATER : LESS;
+	}
+	for(int i = a->n - 1; i >= 0; i--)
+	{
+		if(a->d[i] != b->d[i])
+		{
+			return (a->d[i] > b->d[i]) ? GREATER : LESS;
+		}
+	}
+	return EQUAL;
+}
+
+/*****************************************************************************************
+ * Function: limbs_from_list / limbs_to_list
+ * ------------------------------------------
+ * Regroup the digits of a list into limbs of LIMB_DIGITS digits (from the tail), and back.
+ * A zero limb number becomes the single node 0.
+ *****************************************************************************************/
+
+int limbs_from_list(Dlist *head, Limbs *x)
+{
+	int length = find_length(head);
+	uint32_t *d = limbs_buffer((length + LIMB_DIGITS - 1) / LIMB_DIGITS);
+	if(d == NULL)
+	{
+		return FAILURE;
+	}
+
+	int i = 0, k = 0;
+	uint32_t scale = 1;
+	for(Dlist *p = list_tail(head); p; p = p->prev)
+	{
+		d[i] += p->data * scale;
+		scale *= 10;
+		if(++k == LIMB_DIGITS)
+		{
+			i++;
+			k = 0;
+			scale = 1;
+		}
+	}
+	limbs_assign(x, d, (length + LIMB_DIGITS - 1) / LIMB_DIGITS);
+	return SUCCESS;
+}
+
+/* Work of a conversion between limbs and decimal characters */
+typedef struct
+{
+	const char *digits;     // limbs_from_string: the string and its length
+	long length;
+	uint32_t *d;
+	const Limbs *x;         // limbs_to_digits: the limbs, the digits of the top one, the output
+	int top;
+	char *out;
+}LimbsJob;
+
+/* Limbs [begin, end) from the digits: limb i is the LIMB_DIGITS digits ending LIMB_DIGITS·i from the end */
+static void parse_limbs(void *arg, int chunk, long begin, long end)
+{
+	LimbsJob *job = arg;
+	for(long i = begin; i < end; i++)
+	{
+		long last = job->length - i * LIMB_DIGITS;
+		long first = (last > LIMB_DIGITS) ? last - LIMB_DIGITS : 0;
+		uint32_t limb = 0;
+		for(long j = first; j < last; j++)
+		{
+			limb = limb * 10 + (job->digits[j] - '0');
+		}
+		job->d[i] = limb;
+	}
+}
+
+/* Characters of the limbs [begin, end) counted from the top one, which has `top` digits, the others LIMB_DIGITS */
+static void format_limbs(void *arg, int chunk, long begin, long end)
+{
+	LimbsJob *job = arg;
+	for(long j = begin; j < end; j++)
+	{
+		uint32_t limb = job->x->d[job->x->n - 1 - j];
+		int width = (j == 0) ? job->top : LIMB_DIGITS;
+		char *p = job->out + ((j == 0) ? 0 : job->top + (j - 1) * LIMB_DIGITS);
+		for(int k = width - 1; k >= 0; k--)
+		{
+			p[k] = '0' + limb % 10;
+			limb /= 10;
+		}
+	}
+}
+
+/* Decimal digits of a non-zero x in a new NUL-terminated buffer; FAILURE, without the limit error, if it does not fit */
+static int limbs_to_digits(const Limbs *x, char **digits, long *length)
+{
+	LimbsJob job = { .x = x, .top = 1 };
+	for(uint32_t top = x->d[x->n - 1]; top >= 10; top /= 10)
+	{
+		job.top++;
+	}
+	*length = job.top + (long)(x->n - 1) * LIMB_DIGITS;
+	job.out = ((size_t)*length + 1 < memory_available()) ? apc_malloc(*length + 1) : NULL;
+	if(job.out == NULL)
+	{
+		return FAILURE;
+	}
+	convert_run(x->n, CONVERT_GRAIN, convert_threads(x->n, CONVERT_GRAIN, 0), format_limbs, &job);
+	job.out[*length] = '\0';
+	*digits = job.out;
+	return SUCCESS;
+}
+
+int limbs_to_list(const Limbs *x, Dlist **head, Dlist **tail)
+{
+	if(x->n == 0)
+	{
+		return insert_at_end(head, tail, 0);
+	}
+
+	// Long numbers: characters, then nodes, both converted in parallel
+	char *digits;
+	long length;
+	if(limbs_to_digits(x, &digits, &length) == SUCCESS)
+	{
+		int status = digits_to_list(digits, length, head, tail);
+		apc_free(digits);
+		return status;
+	}
+
+	for(int i = 0; i < x->n; i++)
+	{
+		uint32_t limb = x->d[i];
+		for(int k = 0; k < LIMB_DIGITS; k++)
+		{
+			// The top limb stops at its last non-zero digit
+			if(i == x->n - 1 && limb == 0 && k > 0)
+			{
+				break;
+			}
+			if(insert_at_begin(head, tail, limb % 10) == FAILURE)
+			{
+				delete_list(head, tail);
+				return FAILURE;
+			}
+			limb /= 10;
+		}
+	}
+	return SUCCESS;
+}
+
+/* Digits (no sign) straight into limbs, without a digit list */
+int limbs_from_string(const char *digits, Limbs *x)
+{
+	long length = strlen(digits);
+	int n = (length + LIMB_DIGITS - 1) / LIMB_DIGITS;
+	LimbsJob job = { .digits = digits, .length = length, .d = limbs_buffer(n) };
+	if(job.d == NULL)
+	{
+		return FAILURE;
+	}
+	convert_run(n, CONVERT_GRAIN, convert_threads(n, CONVERT_GRAIN, 0), parse_limbs, &job);
+	limbs_assign(x, job.d, n);
+	return SUCCESS;
+}
+
+/* "Result          : ±value" (0 unsigned) */
+void limbs_print_result(char sign, const Limbs *x)
+{
+	if(x->n == 0)
+	{
+		apc_printf("Result          : 0\n");
+		PROFILE_RESULT_DIGITS(1);
+		return;
+	}
+	char *digits;
+	long length;
+	if(limbs_to_digits(x, &digits, &length) == SUCCESS)
+	{
+		PROFILE_RESULT_DIGITS(length);
+		apc_printf("Result          : %c", sign);
+		fwrite(digits, 1, length, apc_output ? apc_output : stdout);
+		apc_printf("\n");
+		apc_free(digits);
+		return;
+	}
+	apc_printf("Result          : %c%u", sign, x->d[x->n - 1]);
+	for(int i = x->n - 2; i >= 0; i--)
+	{
+		apc_printf("%09u", x->d[i]);
+	}
+	apc_printf("\n");
+}
+
+/* ------------------------------- raw limb array kernels ------------------------------- */
+
+/* r[0 .. rn) += x[0 .. xn), rn >= xn; returns the carry out of r */
+static uint32_t add_into(uint32_t *r, int rn, const uint32_t *x, int xn)
+{
+	uint32_t carry = 0;
+	for(int i = 0; i < rn && (i < xn || carry); i++)
+	{
+		uint32_t s = r[i] + carry + ((i < xn) ? x[i] : 0);
+		carry = (s >= LIMB_BASE);
+		r[i] = carry ? s - LIMB_BASE : s;
+	}
+	return carry;
+}
+
+/* r[0 .. rn) -= x[0 .. xn), r >= x */
+static void sub_from(uint32_t *r, int rn, const uint32_t *x, int xn)
+{
+	uint32_t borrow = 0;
+	for(int i = 0; i < rn && (i < xn || borrow); i++)
+	{
+		uint32_t v = ((i < xn) ? x[i] : 0) + borrow;
+		borrow = (r[i] < v);
+		r[i] = borrow ? r[i] + LIMB_BASE - v : r[i] - v;
+	}
+}
+
+/* One row: o[0 .. bn) += x × b with the carries resolved; returns the carry for o[bn] (below LIMB_BASE) */
+static uint32_t addmul_row(uint32_t x, const uint32_t *b, int bn, uint32_t *o)
+{
+	uint64_t carry = 0;
+	for(int j = 0; j < bn; j++)
+	{
+		uint64_t t = o[j] + (uint64_t)x * b[j] + carry;
+		o[j] = t % LIMB_BASE;
+		carry = t / LIMB_BASE;
+	}
+	return carry;
+}
+
+/*
+ * LIMBS_BLOCK rows at once: o[0 .. bn + LIMBS_BLOCK - 1) += x[0 .. LIMBS_BLOCK) × b for bn >= LIMBS_BLOCK.
+ * The products of one column are summed in one 64-bit word and divided by LIMB_BASE once, instead
+ * of once per row. Returns the carry for o[bn + LIMBS_BLOCK - 1] (at most LIMB_BASE).
+ */
+static uint32_t addmul_block(const uint32_t *x, const uint32_t *b, int bn, uint32_t *o)
+{
+	uint64_t carry = 0;
+
+	// Columns where the block is only partly over b, then the full columns, then the tail
+	for(int k = 0; k < LIMBS_BLOCK - 1; k++)
+	{
+		uint64_t t = o[k] + carry;
+		for(int m = 0; m <= k; m++)
+			t += (uint64_t)x[m] * b[k - m];
+		o[k] = t % LIMB_BASE;
+		carry = t / LIMB_BASE;
+	}
+	for(int k = LIMBS_BLOCK - 1; k < bn; k++)
+	{
+		uint64_t t = o[k] + carry
+		           + (uint64_t)x[0] * b[k]     + (uint64_t)x[1] * b[k - 1]
+		           + (uint64_t)x[2] * b[k - 2] + (uint64_t)x[3] * b[k - 3]
+		           + (uint64_t)x[4] * b[k - 4] + (uint64_t)x[5] * b[k - 5]
+		           + (uint64_t)x[6] * b[k - 6] + (uint64_t)x[7] * b[k - 7];
+		o[k] = t % LIMB_BASE;
+		carry = t / LIMB_BASE;
+	}
+	for(int k = bn; k < bn + LIMBS_BLOCK - 1; k++)
+	{
+		uint64_t t = o[k] + carry;
+		for(int m = k - bn + 1; m < LIMBS_BLOCK; m++)
+			t += (uint64_t)x[m] * b[k - m];
+		o[k] = t % LIMB_BASE;
+		carry = t / LIMB_BASE;
+	}
+	return carry;
+}
+
+/*
+ * Column multiplication: r[0 .. an+bn) = a × b (r zeroed by the caller). Rows of a go in blocks
+ * of LIMBS_BLOCK (addmul_block); the rows left over, and every row when b is shorter than a
+ * block, take the row loop.
+ */
+static void mul_basecase_limbs(const uint32_t *a, int an, const uint32_t *b, int bn, uint32_t *r)
+{
+	int i = 0;
+	for(; bn >= LIMBS_BLOCK && i + LIMBS_BLOCK <= an; i += LIMBS_BLOCK)
+	{
+		// a[0 .. i + LIMBS_BLOCK) × b has i + LIMBS_BLOCK + bn limbs, so the carry is one limb
+		r[i + bn + LIMBS_BLOCK - 1] = addmul_block(a + i, b, bn, r + i);
+	}
+	for(; i < an; i++)
+	{
+		if(a[i] != 0)
+		{
+			r[i + bn] = addmul_row(a[i], b, bn, r + i);
+		}
+	}
+}
+
+/*
+ * Column squaring: r[0 .. 2n) = a² for n < LIMBS_KARATSUBA. The cross products a[i]·a[j], i < j, are
+ * formed once and summed per column in 64-bit words without any carry: a column holds fewer than
+ * LIMBS_KARATSUBA / 2 of them, below 16 · 10^18 < 2^64. One pass then doubles each column, adds its
+ * half of the diagonal square and resolves the carries.
+ */
+static void sqr_basecase_limbs(const uint32_t *a, int n, uint32_t *r)
+{
+	uint64_t columns[2 * LIMBS_KARATSUBA] = { 0 };
+	for(int i = 0; i < n; i++)
+	{
+		for(int j = i + 1; j < n; j++)
+		{
+			columns[i + j] += (uint64_t)a[i] * a[j];
+		}
+	}
+
+	uint64_t carry = 0;
+	for(int k = 0; k < 2 * n; k++)
+	{
+		// 2·column may not fit in 64 bits: double its two parts below and above LIMB_BASE separately
+		uint64_t square = (uint64_t)a[k / 2] * a[k / 2];
+		uint64_t t = 2 * (columns[k] % LIMB_BASE) + carry + ((k % 2 == 0) ? square % LIMB_BASE : square / LIMB_BASE);
+		r[k] = t % LIMB_BASE;
+		carry = t / LIMB_BASE + 2 * (columns[k] / LIMB_BASE);
+	}
+}
+
+/* r[0 .. an+bn) = a × b (r zeroed by the caller); returns FAILURE on allocation failure */
+static int mul_limbs(const uint32_t *a, int an, const uint32_t *b, int bn, uint32_t *r)
+{
+	if(an < bn)
+	{
+		const uint32_t *t = a; a = b; b = t;
+		int tn = an; an = bn; bn = tn;
+	}
+	int squaring = (a == b && an == bn);
+	if(bn < LIMBS_KARATSUBA)
+	{
+		if(squaring)
+			sqr_basecase_limbs(a, an, r);
+		else
+			mul_basecase_limbs(a, an, b, bn, r);
+		return SUCCESS;
+	}
+
+	int h = (an + 1) / 2;
+	if(bn <= h)
+	{
+		// Unbalanced: multiply b by a in chunks of bn limbs
+		uint32_t *part = limbs_buffer(2 * bn);
+		if(part == NULL)
+		{
+			return FAILURE;
+		}
+		for(int off = 0; off < an; off += bn)
+		{
+			int len = (an - off < bn) ? an - off : bn;
+			memset(part, 0, 2 * bn * sizeof(uint32_t));
+			if(mul_limbs(a + off, len, b, bn, part) == FAILURE)
+			{
+				apc_free(part);
+				return FAILURE;
+			}
+			add_into(r + off, an + bn - off, part, len + bn);
+		}
+		apc_free(part);
+		return SUCCESS;
+	}
+
+	// a = a1·B^h + a0, b = b1·B^h + b0
+	int an1 = an - h, bn1 = bn - h;
+	uint32_t *sa = limbs_buffer(h + 1), *sb = squaring ? sa : limbs_buffer(h + 1);
+	uint32_t *z1 = limbs_buffer(2 * h + 2), *z2 = limbs_buffer(an1 + bn1);
+	int status = FAILURE;
+	if(sa == NULL || sb == NULL || z1 == NULL || z2 == NULL)
+	{
+		goto done;
+	}
+
+	memcpy(sa, a, h * sizeof(uint32_t));
+	sa[h] = add_into(sa, h, a + h, an1);
+	if(!squaring)
+	{
+		memcpy(sb, b, h * sizeof(uint32_t));
+		sb[h] = add_into(sb, h, b + h, bn1);
+	}
+
+	// z0 goes straight into the low half of r, z2 into a temporary; a square stays a square in all three
+	if(mul_limbs(a, h, b, h, r) == FAILURE ||
+	   mul_limbs(a + h, an1, b + h, bn1, z2) == FAILURE ||
+	   mul_limbs(sa, h + 1, sb, h + 1, z1) == FAILURE)
+	{
+		goto done;
+	}
+
+	// z1 = (a0 + a1)(b0 + b1) - z0 - z2
+	sub_from(z1, 2 * h + 2, r, 2 * h);
+	sub_from(z1, 2 * h + 2, z2, an1 + bn1);
+
+	memcpy(r + 2 * h, z2, (an1 + bn1) * sizeof(uint32_t));
+	add_into(r + h, an + bn - h, z1, (2 * h + 2 < an + bn - h) ? 2 * h + 2 : an + bn - h);
+	status = SUCCESS;
+
+done:
+	apc_free(sa);
+	if(!squaring)
+		apc_free(sb);
+	apc_free(z1);
+	apc_free(z2);
+	return status;
+}
+
+/* ------------------------------------ arithmetic ------------------------------------ */
+
+int limbs_add(const Limbs *a, const Limbs *b, Limbs *r)
+{
+	if(a->n < b->n)
+	{
+		const Limbs *t = a; a = b; b = t;
+	}
+	uint32_t *d = limbs_buffer(a->n + 1);
+	if(d == NULL)
+	{
+		return FAILURE;
+	}
+	if(a->n > 0)
+	{
+		memcpy(d, a->d, a->n * sizeof(uint32_t));
+	}
+	d[a->n] = add_into(d, a->n, b->d, b->n);
+	limbs_assign(r, d, a->n + 1);
+	return SUCCESS;
+}
+
+int limbs_sub(const Limbs *a, const Limbs *b, Limbs *r)
+{
+	uint32_t *d = limbs_buffer(a->n);
+	if(d == NULL)
+	{
+		return FAILURE;
+	}
+	if(a->n > 0)
+	{
+		memcpy(d, a->d, a->n * sizeof(uint32_t));
+	}
+	sub_from(d, a->n, b->d, b->n);
+	limbs_assign(r, d, a->n);
+	return SUCCESS;
+}
+
+int limbs_mul(const Limbs *a, const Limbs *b, Limbs *r)
+{
+	if(a->n == 0 || b->n == 0)
+	{
+		limbs_assign(r, limbs_buffer(1), 0);
+		return (r->d != NULL) ? SUCCESS : FAILURE;
+	}
+
+	uint32_t *d = limbs_buffer(a->n + b->n);
+	if(d == NULL || mul_limbs(a->d, a->n, b->d, b->n, d) == FAILURE)
+	{
+		apc_free(d);
+		return FAILURE;
+	}
+	limbs_assign(r, d, a->n + b->n);
+	return SUCCESS;
+}
+
+int limbs_lincomb(const Limbs *a, uint32_t p, const Limbs *b, uint32_t q, Limbs *r)
+{
+	int n = (a->n > b->n) ? a->n : b->n;
+	uint32_t *d = limbs_buffer(n + 2);
+	if(d == NULL)
+	{
+		return FAILURE;
+	}
+
+	uint64_t carry = 0;
+	for(int i = 0; i < n + 2; i++)
+	{
+		// a[i]·p and b[i]·q are below 2^62 each, the sum and carry stay below 2^64
+		uint64_t t = carry;
+		t += (i < a->n) ? (uint64_t)a->d[i] * p : 0;
+		t += (i < b->n) ? (uint64_t)b->d[i] * q : 0;
+		d[i] = t % LIMB_BASE;
+		carry = t / LIMB_BASE;
+	}
+	limbs_assign(r, d, n + 2);
+	return SUCCESS;
+}
+
+/* q = a / d for a single-word divisor (q may be NULL or alias a); returns a % d */
+uint32_t limbs_divmod_small(const Limbs *a, uint32_t d, Limbs *q)
+{
+	uint32_t *w = NULL;
+	if(q && (w = limbs_buffer(a->n)) == NULL)
+	{
+		return 0;
+	}
+
+	uint64_t rem = 0;
+	for(int i = a->n - 1; i >= 0; i--)
+	{
+		uint64_t t = rem * LIMB_BASE + a->d[i];
+		if(w)
+		{
+			w[i] = t / d;
+		}
+		rem = t % d;
+	}
+	if(q)
+	{
+		limbs_assign(q, w, a->n);
+	}
+	return rem;
+}
+
+/*****************************************************************************************
+ * Function: limbs_divmod
+ * ----------------------
+ * Long division on limbs (Knuth, Algorithm D). Both operands are scaled so that the top
+ * divisor limb is at least LIMB_BASE / 2; each quotient limb is then estimated from the top
+ * two remainder limbs, corrected with the second divisor limb and fixed by at most one
+ * add-back. q or r may be NULL. Division by zero returns FAILURE.
+ *****************************************************************************************/
+
+int limbs_divmod(const Limbs *a, const Limbs *b, Limbs *q, Limbs *r)
+{
+	if(b->n == 0)
+	{
+		apc_printf("ERROR : Division by zero! \n");
+		return FAILURE;
+	}
+
+	int n = b->n, m = a->n - b->n;
+	if(m < 0)
+	{
+		if(r && limbs_copy(a, r) == FAILURE)
+			return FAILURE;
+		if(q && limbs_set_small(q, 0) == FAILURE)      // trimmed to n == 0
+			return FAILURE;
+		return SUCCESS;
+	}
+
+	uint32_t *u = limbs_buffer(a->n + 1), *v = limbs_buffer(n), *w = limbs_buffer(m + 1);
+	if(u == NULL || v == NULL || w == NULL)
+	{
+		apc_free(u);
+		apc_free(v);
+		apc_free(w);
+		return FAILURE;
+	}
+
+	// Normalize: u = a·f, v = b·f with v[n-1] >= LIMB_BASE / 2
+	uint64_t f = LIMB_BASE / ((uint64_t)b->d[n - 1] + 1), carry = 0;
+	for(int i = 0; i < a->n; i++)
+	{
+		uint64_t t = (uint64_t)a->d[i] * f + carry;
+		u[i] = t % LIMB_BASE;
+		carry = t / LIMB_BASE;
+	}
+	u[a->n] = carry;
+	carry = 0;
+	for(int i = 0; i < n; i++)
+	{
+		uint64_t t = (uint64_t)b->d[i] * f + carry;
+		v[i] = t % LIMB_BASE;
+		carry = t / LIMB_BASE;
+	}
+
+	for(int j = m; j >= 0; j--)
+	{
+		// Estimate from the top two limbs, refine with the second divisor limb
+		uint64_t top = (uint64_t)u[j + n] * LIMB_BASE + u[j + n - 1];
+		uint64_t qhat = top / v[n - 1], rhat = top % v[n - 1];
+		while(qhat >= LIMB_BASE ||
+		      (n >= 2 && qhat * v[n - 2] > rhat * LIMB_BASE + u[j + n - 2]))
+		{
+			qhat--;
+			rhat += v[n - 1];
+			if(rhat >= LIMB_BASE)
+			{
+				break;
+			}
+		}
+
+		// u[j .. j+n] -= qhat · v
+		int64_t borrow = 0;
+		uint64_t mulcarry = 0;
+		for(int i = 0; i <= n; i++)
+		{
+			uint64_t p = ((i < n) ? qhat * v[i] : 0) + mulcarry;
+			mulcarry = p / LIMB_BASE;
+			int64_t t = (int64_t)u[j + i] - (int64_t)(p % LIMB_BASE) - borrow;
+			borrow = 0;
+			if(t < 0)
+			{
+				t += LIMB_BASE;
+				borrow = 1;
+			}
+			u[j + i] = t;
+		}
+
+		// Over-estimated by one: add the divisor back
+		if(borrow)
+		{
+			qhat--;
+			u[j + n] += add_into(u + j, n, v, n);
+			u[j + n] -= LIMB_BASE * (u[j + n] >= LIMB_BASE);
+		}
+		w[j] = qhat;
+	}
+
+	// Undo the normalization of the remainder
+	uint64_t rem = 0;
+	for(int i = n - 1; i >= 0; i--)
+	{
+		uint64_t t = rem * LIMB_BASE + u[i];
+		u[i] = t / f;
+		rem = t % f;
+	}
+	apc_free(v);
+
+	if(q)
+		limbs_assign(q, w, m + 1);
+	else
+		apc_free(w);
+	if(r)
+		limbs_assign(r, u, n);
+	else
+		apc_free(u);
+	return SUCCESS;
+}
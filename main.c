@@ -7,12 +7,28 @@
 *                  This allows accurate computation of large values without overflow. 
 *                  
 *                  The APC supports addition (+), subtraction (-), multiplication (*), division (/), square (^), 
-*                  and modulus (%) operations. It handles positive and negative numbers and includes 
+*                  and modulus (%) operations, plus fused multiply-accumulate (addmul / submul). It handles positive and negative numbers and includes 
 *                  validation for invalid inputs or division/modulus by zero. 
 *                  
 *                  The project uses linked lists to execute arithmetic operations. 
 *                  It provides a command-line interface for user interaction, where inputs are taken as:
 *                      ./a.out <number1> <operator> <number2>
+*                      ./a.out <accumulator> <addmul|submul> <number1> <number2>
+*                      ./a.out <number> isqrt         ./a.out <number> iroot <n>
+*                      ./a.out --tune [thresholds file]
+*                      ./a.out --profile <arguments...>      (or APC_PROFILE=1: JSON counters on stderr)
+*                      ./a.out --no-small <arguments...>     (or APC_NO_SMALL=1: no 128-bit fast path)
+*                      ./a.out [--memory-limit MB] [--op-memory-limit MB] <arguments...>
+*                      ./a.out [--precision N] [--rounding MODE] <decimal1> <operator> <decimal2>
+*                      ./a.out [--rounds N] <number> isprime    ./a.out <number> nextprime    ./a.out <number> factor
+*                      ./a.out --out-of-core [--memory MB] <file1> <+|-|*|cmp> <file2> [<result file>]
+*                      ./a.out --serve <socket> [--threads N]    ./a.out --client <socket> <arguments...|->
+*                      ./a.out --modulus <divisor> <%|/> <dividend1> [<dividend2> ...]   (or "-": one dividend per stdin line)
+*                      ./a.out <base> powmod <exponent> <modulus>
+*                      ./a.out --batch <+|-|*|cmp> [file]      (one "a b" row per line, SIMD lanes)
+*                      ./a.out --aggregate <sum|product|min|max|sort> [file]   (integers separated by spaces, commas or lines)
+*                      ./a.out --lastdigits K <number1> <*|^> [number2]    (also --firstdigits K: leading digits and length)
+*                      ./a.out <n> !    ./a.out <n> binomial <k>    ./a.out <number1> prod <number2> [<number3> ...]
 *                       note : For shell interpretation, enclose * / ^ % in quotes.
 *                  
 *                  Example:
@@ -50,19 +66,471 @@
 
 int main(int argc, char *argv[])
 {
+    // Profiling counters: ./a.out --profile <args...> or APC_PROFILE=1 (JSON report on stderr);
+    // --no-small or APC_NO_SMALL=1 sends small integers through the lists too (small.c), in either order
+    profile_init();
+    small_init();
+    while (argc > 1 && (strcmp(argv[1], "--profile") == 0 || strcmp(argv[1], "--no-small") == 0))
+    {
+        if (strcmp(argv[1], "--profile") == 0)
+            apc_profile_enabled = 1;
+        else
+            apc_small_enabled = 0;
+        argv[1] = argv[0];
+        argv++;
+        argc--;
+    }
+
+    // Memory caps: --memory-limit MB (whole process), --op-memory-limit MB (one operation); or APC_MEMORY_LIMIT / APC_OP_MEMORY_LIMIT
+    memory_init();
+    while (argc > 2 && (strcmp(argv[1], "--memory-limit") == 0 || strcmp(argv[1], "--op-memory-limit") == 0))
+    {
+        long long limit = atoll(argv[2]);
+        if (limit < 0)
+        {
+            printf("ERROR : Memory limit must not be negative!\n");
+            return 0;
+        }
+        if (strcmp(argv[1], "--memory-limit") == 0)
+            memory_set_limits(limit, -1);
+        else
+            memory_set_limits(-1, limit);
+        argv[2] = argv[0];
+        argv += 2;
+        argc -= 2;
+    }
+    memory_begin_operation();
+
+    // Measure kernel crossover sizes on this host: ./a.out --tune [thresholds file]
+    if ((argc == 2 || argc == 3) && strcmp(argv[1], "--tune") == 0)
+    {
+        tune_thresholds((argc == 3) ? argv[2] : NULL);
+        return 0;
+    }
+
+    // Resident server on a Unix socket: ./a.out --serve <socket> [--threads N]
+    if ((argc == 3 || argc == 5) && strcmp(argv[1], "--serve") == 0)
+    {
+        int threads = 0;
+        if (argc == 5 && (strcmp(argv[3], "--threads") != 0 || (threads = atoi(argv[4])) < 1))
+        {
+            printf("ERROR : --threads needs a positive count\n");
+            return 0;
+        }
+        if (serve(argv[2], threads) == FAILURE)
+            printf("ERROR : Server Failed! \n");
+        return 0;
+    }
+
+    // Client stub of the server: ./a.out --client <socket> <arguments...> (or "-": one request per stdin line)
+    if (argc > 3 && strcmp(argv[1], "--client") == 0)
+    {
+        serve_client(argv[2], argc - 3, argv + 3);
+        return 0;
+    }
+
+    // Many dividends by one divisor: ./a.out --modulus <divisor> <%|/> <dividend...|->
+    if (argc > 1 && strcmp(argv[1], "--modulus") == 0)
+    {
+        if (argc < 5)
+        {
+            printf("ERROR : Invalid Number of Arguments!\n");
+            printf("USAGE : ./a.out --modulus <divisor> <%%|/> <dividend1> [<dividend2> ...] (or - for stdin)\n");
+            return 0;
+        }
+        if (modctx_batch(argv[2], argv[3], argc - 4, argv + 4) == FAILURE && !memory_exceeded())
+            printf("ERROR : Modulus Failed! \n");
+        return 0;
+    }
+
+    // Lane-parallel rows: ./a.out --batch <+|-|*|cmp> [file] (one "a b" pair per line, stdin without a file)
+    if ((argc == 3 || argc == 4) && strcmp(argv[1], "--batch") == 0)
+    {
+        if (batch_run(argv[2], (argc == 4) ? argv[3] : NULL) == FAILURE && !memory_exceeded())
+            printf("ERROR : Batch Failed! \n");
+        return 0;
+    }
+
+    // Whole-stream aggregates: ./a.out --aggregate <sum|product|min|max|sort> [file] (stdin without a file)
+    if ((argc == 3 || argc == 4) && strcmp(argv[1], "--aggregate") == 0)
+    {
+        if (aggregate_run(argv[2], (argc == 4) ? argv[3] : NULL) == FAILURE && !memory_exceeded())
+            printf("ERROR : Aggregate Failed! \n");
+        return 0;
+    }
+
+    // Short products: ./a.out --lastdigits|--firstdigits K <num1> <*|^> [<num2>]
+    if ((argc == 5 || argc == 6) && (strcmp(argv[1], "--lastdigits") == 0 || strcmp(argv[1], "--firstdigits") == 0))
+    {
+        // Input errors are reported by short_product_run itself, and so is a failed product
+        short_product_run(argv[1], argv[2], argc - 3, argv + 3);
+        return 0;
+    }
+
+    // Out-of-core mode: ./a.out --out-of-core [--memory MB] <file1> <operator> <file2> [<result file>]
+    if (argc > 1 && strcmp(argv[1], "--out-of-core") == 0)
+    {
+        long long memory = OOC_MEMORY_DEFAULT;
+        argv++;
+        argc--;
+        if (argc > 2 && strcmp(argv[1], "--memory") == 0)
+        {
+            memory = atoll(argv[2]);
+            argv += 2;
+            argc -= 2;
+        }
+        if (argc != 4 && argc != 5)
+        {
+            printf("ERROR : Invalid Number of Arguments!\n");
+            printf("USAGE : ./a.out --out-of-core [--memory MB] <file1> <+|-|*|cmp> <file2> [<result file>]\n");
+            return 0;
+        }
+        if (out_of_core_operation(argv[2], argv[1], argv[3], (argc == 5) ? argv[4] : NULL, memory) == FAILURE)
+        {
+            printf("ERROR : Operation Failed! \n");
+        }
+        printf("----------------------------------------\n");
+        printf("APC Calculator Execution Completed.\n");
+        return 0;
+    }
+
+    // Decimal options: --precision N (fractional digits of every result), --rounding MODE
+    int precision = DECIMAL_DEFAULT_PRECISION, fixed_precision = 0, rounding = ROUND_HALF_EVEN;
+    // Primality option: --rounds N (extra Miller-Rabin rounds with random bases)
+    while (argc > 2 && (strcmp(argv[1], "--precision") == 0 || strcmp(argv[1], "--rounding") == 0 ||
+                        strcmp(argv[1], "--rounds") == 0))
+    {
+        if (strcmp(argv[1], "--rounds") == 0)
+        {
+            apc_prime_rounds = atoi(argv[2]);
+            if (apc_prime_rounds < 0)
+            {
+                printf("ERROR : Rounds must not be negative!\n");
+                return 0;
+            }
+        }
+        else if (strcmp(argv[1], "--precision") == 0)
+        {
+            precision = atoi(argv[2]);
+            fixed_precision = 1;
+            if (precision < 0)
+            {
+                printf("ERROR : Precision must not be negative!\n");
+                return 0;
+            }
+        }
+        else if ((rounding = rounding_mode(argv[2])) == FAILURE)
+        {
+            printf("ERROR : Unknown rounding mode %s\n", argv[2]);
+            return 0;
+        }
+        argv[2] = argv[0];
+        argv += 2;
+        argc -= 2;
+    }
+
     // Validate command-line arguments (e.g., ./a.out <num1> <operator> <num2>)
+    PROFILE_BEGIN(PHASE_PARSE);
     if (validate_arguments(argc, argv) == FAILURE)
         return 0;
 
-    // Declare head and tail pointers for all operand and result lists
-    Dlist *head1 = NULL, *tail1 = NULL;
-    Dlist *head2 = NULL, *tail2 = NULL;
-    Dlist *headR = NULL, *tailR = NULL;;
+    // List operators: ./a.out <num1> prod <num2> [<num3> ...]
+    if (operator_arity(argv[2]) == ARITY_LIST)
+    {
+        int count = argc - 2;
+        Dlist **heads = apc_calloc(count, sizeof(Dlist *)), **tails = apc_calloc(count, sizeof(Dlist *));
+        Dlist *headR = NULL;
+        char *signs = apc_malloc(count);
+        const char **digits = apc_calloc(count, sizeof(char *));
+        if (heads == NULL || tails == NULL || signs == NULL || digits == NULL)
+        {
+            printf("ERROR: Failed to create lists for the operands.\n");
+            apc_free(heads);
+            apc_free(tails);
+            apc_free(signs);
+            apc_free(digits);
+            return 0;
+        }
+
+        // Repeated operands (prod X X X) share one list
+        for (int i = 0; i < count; i++)
+        {
+            signs[i] = remove_sign(argv[(i == 0) ? 1 : i + 2], &digits[i]);
+            if (operand_list(heads, tails, digits, i) == FAILURE)
+            {
+                printf("ERROR: Failed to create list for operand %d.\n", i + 1);
+                free_lists(heads, i + 1);
+                apc_free(heads);
+                apc_free(tails);
+                apc_free(signs);
+                apc_free(digits);
+                return 0;
+            }
+            if (apc_profile_enabled)
+                profile_operand(heads[i]);
+        }
+        PROFILE_END(PHASE_PARSE);
+
+        printf("Operation       : %s\n", argv[2]);
+        for (int i = 0; i < count; i++)
+        {
+            printf("Operand %-2d      : %c", i + 1, signs[i]);
+            print_list(heads[i]);
+        }
+        printf("----------------------------------------\n");
+
+        PROFILE_BEGIN(PHASE_COMPUTE);
+        if (perform_list_operation(argv[2], count, signs, heads, &headR) == FAILURE)
+        {
+            printf("ERROR : Operation Failed! \n");
+        }
+        PROFILE_END(PHASE_COMPUTE);
+        printf("----------------------------------------\n");
+        printf("APC Calculator Execution Completed.\n");
+        if (apc_profile_enabled)
+        {
+            profile_result(headR);
+            profile_report(argv[2]);
+        }
+        free_lists(heads, count);
+        free_lists(&headR, 1);
+        apc_free(heads);
+        apc_free(tails);
+        apc_free(signs);
+        apc_free(digits);
+        return 0;
+    }
+
+    // Unary operators: ./a.out <num> <operator>
+    if (argc == 3)
+    {
+        Dlist *head1 = NULL, *tail1 = NULL;
+        Dlist *headR = NULL, *tailR = NULL;
+
+        const char *digits1;
+        char sign1 = remove_sign(argv[1], &digits1);
+        PROFILE_END(PHASE_PARSE);
+
+        if (string_to_list(&head1, &tail1, (char *)digits1) == FAILURE)
+        {
+            printf("ERROR: Failed to create list for operand 1.\n");
+            return 0;
+        }
+        remove_leading_zeros(&head1);
+        if (apc_profile_enabled)
+            profile_operand(head1);
+
+        printf("Operand 1       : %c", sign1);
+        print_list(head1);
+        printf("Operation       : %s\n", argv[2]);
+
+        printf("----------------------------------------\n");
+
+        PROFILE_BEGIN(PHASE_COMPUTE);
+        if (perform_unary_operation(argv[2], sign1, &head1, &tail1, &headR, &tailR) == FAILURE)
+        {
+            printf("ERROR : Operation Failed! \n");
+        }
+        PROFILE_END(PHASE_COMPUTE);
+        printf("----------------------------------------\n");
+        printf("APC Calculator Execution Completed.\n");
+        if (apc_profile_enabled)
+        {
+            profile_result(headR);
+            profile_report(argv[2]);
+        }
+        delete_list(&head1, &tail1);
+        delete_list(&headR, &tailR);
+        return 0;
+    }
+
+    // Fused multiply-accumulate: ./a.out <acc> <addmul|submul> <num1> <num2>, and ./a.out <base> powmod <exponent> <modulus>
+    if (argc == 5)
+    {
+        Dlist *headA = NULL, *tailA = NULL;
+        Dlist *head1 = NULL, *tail1 = NULL;
+        Dlist *head2 = NULL, *tail2 = NULL;
+
+        const char *digitsA, *digits1, *digits2;
+        char signA = remove_sign(argv[1], &digitsA);
+        char sign1 = remove_sign(argv[3], &digits1);
+        char sign2 = remove_sign(argv[4], &digits2);
+        PROFILE_END(PHASE_PARSE);
+
+        // The accumulator is written in place (perform_fused_operation makes it private); the factors may share
+        if (string_to_list(&headA, &tailA, (char *)digitsA) == FAILURE ||
+            string_to_list(&head1, &tail1, (char *)digits1) == FAILURE)
+        {
+            printf("ERROR: Failed to create lists for the operands.\n");
+            delete_list(&headA, &tailA);
+            return 0;
+        }
+        remove_leading_zeros(&headA);
+        remove_leading_zeros(&head1);
+        if (strcmp(digits1, digits2) == 0 && (head2 = list_share(head1)) != NULL)
+        {
+            tail2 = tail1;
+        }
+        else if (string_to_list(&head2, &tail2, (char *)digits2) == FAILURE)
+        {
+            printf("ERROR: Failed to create lists for the operands.\n");
+            delete_list(&headA, &tailA);
+            delete_list(&head1, &tail1);
+            return 0;
+        }
+        remove_leading_zeros(&head2);
+        if (apc_profile_enabled)
+        {
+            profile_operand(headA);
+            profile_operand(head1);
+            profile_operand(head2);
+        }
+
+        int power = (strcmp(argv[2], "powmod") == 0);
+        printf("%s: %c", power ? "Base            " : "Accumulator     ", signA);
+        print_list(headA);
+        printf("Operation       : %s\n", argv[2]);
+        printf("%s: %c", power ? "Exponent        " : "Operand 1       ", sign1);
+        print_list(head1);
+        printf("%s: %c", power ? "Modulus         " : "Operand 2       ", sign2);
+        print_list(head2);
+
+        printf("----------------------------------------\n");
+
+        PROFILE_BEGIN(PHASE_COMPUTE);
+        if (perform_fused_operation(argv[2], signA, sign1, sign2, &headA, &tailA, &head1, &tail1, &head2, &tail2) == FAILURE)
+        {
+            printf("ERROR : Operation Failed! \n");
+        }
+        PROFILE_END(PHASE_COMPUTE);
+        printf("----------------------------------------\n");
+        printf("APC Calculator Execution Completed.\n");
+        if (apc_profile_enabled)
+        {
+            profile_result(headA);
+            profile_report(argv[2]);
+        }
+        list_release(&headA, &tailA);
+        list_release(&head2, &tail2);
+        list_release(&head1, &tail1);
+        return 0;
+    }
+
+    // Exact rational operands: ./a.out 1/3 + 1/6
+    if (argc == 4 && (is_rational(argv[1]) || is_rational(argv[3])))
+    {
+        Rational r1, r2;
+        if (string_to_rational(argv[1], &r1) == FAILURE)
+        {
+            printf("ERROR: Failed to create rational operands.\n");
+            return 0;
+        }
+        if (string_to_rational(argv[3], &r2) == FAILURE)
+        {
+            printf("ERROR: Failed to create rational operands.\n");
+            rational_free(&r1);
+            return 0;
+        }
+        PROFILE_END(PHASE_PARSE);
+
+        printf("Operand 1       : ");
+        print_rational(&r1);
+        printf("Operation       : %s\n", argv[2]);
+        printf("Operand 2       : ");
+        print_rational(&r2);
+        printf("----------------------------------------\n");
+
+        PROFILE_BEGIN(PHASE_COMPUTE);
+        if (perform_rational_operation(argv[2], &r1, &r2) == FAILURE)
+        {
+            printf("ERROR : Operation Failed! \n");
+        }
+        PROFILE_END(PHASE_COMPUTE);
+        rational_free(&r1);
+        rational_free(&r2);
+        printf("----------------------------------------\n");
+        printf("APC Calculator Execution Completed.\n");
+        if (apc_profile_enabled)
+            profile_report(argv[2]);
+        return 0;
+    }
+
+    // Fixed-point decimal operands: ./a.out [--precision N] [--rounding MODE] 12.50 / 3
+    if (argc == 4 && (fixed_precision || is_decimal(argv[1]) || is_decimal(argv[3])))
+    {
+        Decimal d1, d2;
+        if (string_to_decimal(argv[1], &d1) == FAILURE)
+        {
+            printf("ERROR: Failed to create decimal operands.\n");
+            return 0;
+        }
+        if (string_to_decimal(argv[3], &d2) == FAILURE)
+        {
+            printf("ERROR: Failed to create decimal operands.\n");
+            decimal_free(&d1);
+            return 0;
+        }
+        PROFILE_END(PHASE_PARSE);
+
+        printf("Operand 1       : ");
+        print_decimal(&d1);
+        printf("Operation       : %s\n", argv[2]);
+        printf("Operand 2       : ");
+        print_decimal(&d2);
+        printf("----------------------------------------\n");
+
+        PROFILE_BEGIN(PHASE_COMPUTE);
+        if (perform_decimal_operation(argv[2], &d1, &d2, precision, fixed_precision, rounding) == FAILURE)
+        {
+            printf("ERROR : Operation Failed! \n");
+        }
+        PROFILE_END(PHASE_COMPUTE);
+        decimal_free(&d1);
+        decimal_free(&d2);
+        printf("----------------------------------------\n");
+        printf("APC Calculator Execution Completed.\n");
+        if (apc_profile_enabled)
+            profile_report(argv[2]);
+        return 0;
+    }
 
     // Extract sign and digit portions from input strings
     const char *digits1 , *digits2;
     char sign1 = remove_sign(argv[1], &digits1);
     char sign2 = remove_sign(argv[3], &digits2);
+    PROFILE_END(PHASE_PARSE);
+
+    // Operands of up to 38 digits: native 128-bit arithmetic without building lists (overflow falls through)
+    PROFILE_BEGIN(PHASE_COMPUTE);
+    int small = small_operation(argv[2], sign1, digits1, sign2, digits2, 1);
+    PROFILE_END(PHASE_COMPUTE);
+    if (small == SUCCESS)
+    {
+        printf("----------------------------------------\n");
+        printf("APC Calculator Execution Completed.\n");
+        if (apc_profile_enabled)
+        {
+            profile_operand_digits(strlen(digits1));
+            profile_operand_digits(strlen(digits2));
+            profile_report(argv[2]);
+        }
+        return 0;
+    }
+
+    // Declare head and tail pointers for all operand and result lists
+    Dlist *head1 = NULL, *tail1 = NULL;
+    Dlist *head2 = NULL, *tail2 = NULL;
+    Dlist *headR = NULL, *tailR = NULL;;
+
+    // Refuse up front when the operand and result lists alone would not fit the memory cap
+    size_t len1 = strlen(digits1), len2 = strlen(digits2);
+    size_t lenR = (strcmp(argv[2], "*") == 0) ? len1 + len2 : (strcmp(argv[2], "^") == 0) ? 2 * len1 : ((len1 > len2) ? len1 : len2) + 1;
+    int same = (strcmp(digits1, digits2) == 0);
+    if (memory_admit((len1 + (same ? 0 : len2) + lenR) * sizeof(Dlist)) == FAILURE)
+    {
+        printf("ERROR : Operation Failed! \n");
+        return 0;
+    }
 
     // ---------- Convert strings (digits only) to lists ----------
     if (string_to_list(&head1, &tail1, (char *)digits1) == FAILURE)
@@ -71,13 +539,24 @@ int main(int argc, char *argv[])
         return 0;
     }
 
-    if (string_to_list(&head2, &tail2, (char *)digits2) == FAILURE)
+    // X * X, X % X, ...: the second operand is another reference to the first list
+    remove_leading_zeros(&head1);
+    if (same && (head2 = list_share(head1)) != NULL)
+    {
+        tail2 = tail1;
+    }
+    else if (string_to_list(&head2, &tail2, (char *)digits2) == FAILURE)
     {
         printf("ERROR: Failed to create list for operand 2.\n");
+        delete_list(&head1, &tail1);
         return 0;
     }
-    remove_leading_zeros(&head1);
     remove_leading_zeros(&head2);
+    if (apc_profile_enabled)
+    {
+        profile_operand(head1);
+        profile_operand(head2);
+    }
 
 
     // ---------- Display input operands ----------
@@ -92,12 +571,22 @@ int main(int argc, char *argv[])
     /* ---------------- Perform the requested arithmetic operation ----------------
        argv[2] contains the operator symbol: "+", "-", "*", "/", "^", "%".
        perform_operation() calls the appropriate function based on the operator and operand signs. */
+    PROFILE_BEGIN(PHASE_COMPUTE);
     if (perform_operation(argv[2], sign1, sign2, &head1, &tail1, &head2, &tail2, &headR, &tailR, digits1, digits2) == FAILURE)
     {
         printf("ERROR : Operation Failed! \n");
     }
+    PROFILE_END(PHASE_COMPUTE);
     printf("----------------------------------------\n");
     printf("APC Calculator Execution Completed.\n");
+    if (apc_profile_enabled)
+    {
+        profile_result(headR);
+        profile_report(argv[2]);
+    }
+    list_release(&head2, &tail2);
+    list_release(&head1, &tail1);
+    delete_list(&headR, &tailR);
     return 0;
 }
 
@@ -0,0 +1,333 @@
+/*******************************************************************************************************************************************************************
+ * Memory accounting
+ * -----------------
+ *  Every allocation of the calculator goes through apc_malloc / apc_calloc / apc_realloc / apc_free, which
+ *  keep the number of bytes in use, the peak of the process and the peak of the current operation.
+ *
+ *  Two optional caps, in MB (0 = unlimited):
+ *     process   : --memory-limit MB or APC_MEMORY_LIMIT      → bytes in use by the whole process
+ *     operation : --op-memory-limit MB or APC_OP_MEMORY_LIMIT → bytes allocated by the calling thread since
+ *                 memory_begin_operation() (each --serve worker runs one operation at a time)
+ *
+ *  An allocation that would cross a cap is refused like a failed malloc (NULL), so the kernels unwind through
+ *  their usual FAILURE paths and free what they built; the first refusal of an operation prints
+ *
+ *     ERROR : Memory limit exceeded (<cap> limit <L> MB, <U> MB in use, <R> bytes requested)
+ *
+ *  The sizes are the allocator's usable sizes (malloc_usable_size), so node overhead is counted as well. Helper
+ *  threads working for one operation (convert.c) pass their memory_operation_used to memory_charge on the
+ *  operation's thread when they finish.
+ *  Counters are updated atomically; the peaks are reported in the --profile JSON ("memory").
+ *
+ *  Node arenas: a --serve connection allocates its list nodes from an arena (arena_create / arena_use) instead
+ *  of one malloc per digit. Nodes come from chunks of ARENA_CHUNK_NODES, freed nodes go back to the arena's free
+ *  list for the next request, and the chunks are released together when the connection closes. Chunks count
+ *  against the process cap when they are added; the nodes handed out count against the operation cap.
+*******************************************************************************************************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <malloc.h>
+#include "apc.h"
+
+#define MB (1024.0 * 1024.0)
+
+/* Nodes per arena chunk */
+#define ARENA_CHUNK_NODES 4096
+
+static size_t in_use;               // bytes currently allocated
+static size_t peak;                 // largest in_use of the process
+static size_t process_limit;        // caps in bytes, 0 = unlimited
+static size_t operation_limit;
+
+/* Current operation of this thread */
+static __thread long long operation_used;   // bytes allocated minus freed since it began
+static __thread long long operation_peak;   // largest operation_used
+static __thread int exceeded;               // a request was refused
+
+/* Cap in bytes from an environment variable holding MB (0 if unset) */
+static size_t env_limit(const char *name)
+{
+	const char *env = getenv(name);
+	long long mb = (env && *env) ? atoll(env) : 0;
+	return (mb > 0) ? (size_t)mb * 1024 * 1024 : 0;
+}
+
+/* Raise *max to value if it is larger */
+static void raise_to(size_t *max, size_t value)
+{
+	size_t old = __atomic_load_n(max, __ATOMIC_RELAXED);
+	while(value > old && !__atomic_compare_exchange_n(max, &old, value, 1, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+		;
+}
+
+/* May the process grow by process_bytes and the operation by operation_bytes? Prints the error once per operation when not. */
+static int admit(size_t process_bytes, size_t operation_bytes)
+{
+	if(process_limit == 0 && operation_limit == 0)
+	{
+		return 1;
+	}
+
+	size_t used = __atomic_load_n(&in_use, __ATOMIC_RELAXED);
+	const char *cap = NULL;
+	size_t limit = 0;
+	size_t bytes = process_bytes;
+	if(process_limit && used + process_bytes > process_limit)
+	{
+		cap = "process";
+		limit = process_limit;
+	}
+	else if(operation_limit && operation_used + (long long)operation_bytes > (long long)operation_limit)
+	{
+		cap = "operation";
+		limit = operation_limit;
+		used = operation_used;
+		bytes = operation_bytes;
+	}
+	if(cap == NULL)
+	{
+		return 1;
+	}
+
+	if(!exceeded)
+	{
+		exceeded = 1;
+		apc_printf("ERROR : Memory limit exceeded (%s limit %.0f MB, %.1f MB in use, %zu bytes requested)\n",
+		       cap, limit / MB, used / MB, bytes);
+	}
+	return 0;
+}
+
+/* Bytes in use by the process and by the operation of this thread change by the deltas */
+static void account(long long process_delta, long long operation_delta)
+{
+	if(process_delta)
+	{
+		size_t now = __atomic_add_fetch(&in_use, (size_t)process_delta, __ATOMIC_RELAXED);
+		if(process_delta > 0)
+			raise_to(&peak, now);
+	}
+	operation_used += operation_delta;
+	if(operation_used > operation_peak)
+		operation_peak = operation_used;
+}
+
+/* Read APC_MEMORY_LIMIT and APC_OP_MEMORY_LIMIT (MB) */
+void memory_init(void)
+{
+	process_limit = env_limit("APC_MEMORY_LIMIT");
+	operation_limit = env_limit("APC_OP_MEMORY_LIMIT");
+}
+
+/* Set the caps in MB (0 = unlimited; negative keeps the current cap) */
+void memory_set_limits(long long process_mb, long long operation_mb)
+{
+	if(process_mb >= 0)
+		process_limit = (size_t)process_mb * 1024 * 1024;
+	if(operation_mb >= 0)
+		operation_limit = (size_t)operation_mb * 1024 * 1024;
+}
+
+/* Start a new operation on this thread: its cap and peak count from zero */
+void memory_begin_operation(void)
+{
+	operation_used = 0;
+	operation_peak = 0;
+	exceeded = 0;
+}
+
+/*****************************************************************************************
+ * Function: memory_admit
+ * ----------------------
+ * Check an estimate before starting work: FAILURE (with the limit error) if `bytes`
+ * more would cross a cap, so an oversized request is refused before it allocates.
+ *****************************************************************************************/
+
+int memory_admit(size_t bytes)
+{
+	return admit(bytes, bytes) ? SUCCESS : FAILURE;
+}
+
+/* Bytes that may still be allocated under both caps (SIZE_MAX if unlimited) */
+size_t memory_available(void)
+{
+	size_t used = __atomic_load_n(&in_use, __ATOMIC_RELAXED), available = SIZE_MAX;
+	if(process_limit)
+		available = (used < process_limit) ? process_limit - used : 0;
+	if(operation_limit)
+	{
+		size_t left = (operation_used < (long long)operation_limit) ? operation_limit - operation_used : 0;
+		if(left < available)
+			available = left;
+	}
+	return available;
+}
+
+size_t memory_in_use(void)          { return __atomic_load_n(&in_use, __ATOMIC_RELAXED); }
+size_t memory_peak(void)            { return __atomic_load_n(&peak, __ATOMIC_RELAXED); }
+size_t memory_operation_peak(void)  { return operation_peak; }
+int memory_exceeded(void)           { return exceeded; }
+
+/* Bytes allocated minus freed by this thread's operation; a helper thread reports it for memory_charge */
+long long memory_operation_used(void) { return operation_used; }
+
+/* Count bytes allocated by helper threads for this thread's operation (convert.c) */
+void memory_charge(long long bytes)
+{
+	account(0, bytes);
+}
+
+
+/* ------------------> Allocation wrappers <------------------- */
+
+void *apc_malloc(size_t size)
+{
+	if(!admit(size, size))
+		return NULL;
+	void *p = malloc(size);
+	if(p)
+	{
+		size_t usable = malloc_usable_size(p);
+		account(usable, usable);
+	}
+	return p;
+}
+
+void *apc_calloc(size_t count, size_t size)
+{
+	if(size && count > SIZE_MAX / size)
+		return NULL;
+	if(!admit(count * size, count * size))
+		return NULL;
+	void *p = calloc(count, size);
+	if(p)
+	{
+		size_t usable = malloc_usable_size(p);
+		account(usable, usable);
+	}
+	return p;
+}
+
+/* On failure the old block is left allocated, as with realloc */
+void *apc_realloc(void *ptr, size_t size)
+{
+	size_t old = malloc_usable_size(ptr);
+	if(size > old && !admit(size - old, size - old))
+		return NULL;
+	void *p = realloc(ptr, size);
+	if(p)
+	{
+		long long delta = (long long)malloc_usable_size(p) - (long long)old;
+		account(delta, delta);
+	}
+	return p;
+}
+
+void apc_free(void *ptr)
+{
+	if(ptr)
+	{
+		long long usable = malloc_usable_size(ptr);
+		account(-usable, -usable);
+		free(ptr);
+	}
+}
+
+
+/* ------------------> Node arenas <------------------- */
+
+struct node_arena
+{
+	Dlist **chunks;         // every chunk, freed by arena_destroy
+	int chunk_count;
+	Dlist *free_nodes;      // freed nodes, linked through `next`
+	Dlist *bump;            // unused part of the newest chunk
+	int bump_left;
+};
+
+/* Arena of the calling thread; NULL → nodes come straight from apc_malloc */
+static __thread NodeArena *current_arena;
+
+NodeArena *arena_create(void)
+{
+	return apc_calloc(1, sizeof(NodeArena));
+}
+
+void arena_destroy(NodeArena *arena)
+{
+	if(arena == NULL)
+		return;
+	if(current_arena == arena)
+		current_arena = NULL;
+	for(int i = 0; i < arena->chunk_count; i++)
+	{
+		free(arena->chunks[i]);
+		account(-(long long)(ARENA_CHUNK_NODES * sizeof(Dlist)), 0);
+	}
+	apc_free(arena->chunks);
+	apc_free(arena);
+}
+
+/* Allocate and free this thread's list nodes from `arena` (NULL: back to apc_malloc) */
+void arena_use(NodeArena *arena)
+{
+	current_arena = arena;
+}
+
+int arena_active(void)
+{
+	return current_arena != NULL;
+}
+
+Dlist *node_alloc(void)
+{
+	NodeArena *arena = current_arena;
+	if(arena == NULL)
+		return apc_malloc(sizeof(Dlist));
+	if(!admit(0, sizeof(Dlist)))
+		return NULL;
+
+	Dlist *node = arena->free_nodes;
+	if(node)
+	{
+		arena->free_nodes = node->next;
+	}
+	else
+	{
+		if(arena->bump_left == 0)
+		{
+			// New chunk: charged to the process only, its nodes are charged as they are handed out
+			size_t bytes = ARENA_CHUNK_NODES * sizeof(Dlist);
+			Dlist **chunks = apc_realloc(arena->chunks, (arena->chunk_count + 1) * sizeof(Dlist *));
+			if(chunks == NULL)
+				return NULL;
+			arena->chunks = chunks;
+			Dlist *chunk = admit(bytes, 0) ? malloc(bytes) : NULL;
+			if(chunk == NULL)
+				return NULL;
+			account(bytes, 0);
+			arena->chunks[arena->chunk_count++] = chunk;
+			arena->bump = chunk;
+			arena->bump_left = ARENA_CHUNK_NODES;
+		}
+		arena->bump_left--;
+		node = arena->bump++;
+	}
+	account(0, sizeof(Dlist));
+	return node;
+}
+
+void node_free(Dlist *node)
+{
+	NodeArena *arena = current_arena;
+	if(arena == NULL)
+	{
+		apc_free(node);
+		return;
+	}
+	node->next = arena->free_nodes;
+	arena->free_nodes = node;
+	account(0, -(long long)sizeof(Dlist));
+}
@@ -0,0 +1,379 @@
+/*******************************************************************************************************************************************************************
+ * Modulus context
+ * ---------------
+ *  Reducing many dividends by the same divisor m pays for the expensive part of a division once. A ModContext
+ *  keeps m as limbs together with its Barrett reciprocal
+ *
+ *     mu = ⌊B^(2k) / m⌋        B = 10^9 (LIMB_BASE), k = number of limbs of m
+ *
+ *  and then any x < B^(2k) is divided with two multiplications and at most two corrections:
+ *
+ *     q̂ = ⌊⌊x / B^(k-1)⌋ · mu / B^(k+1)⌋       (q̂ ≤ ⌊x / m⌋ ≤ q̂ + 2)
+ *     r = x − q̂·m,  then while r ≥ m: r −= m, q̂ += 1
+ *
+ *  A longer dividend is consumed from the top, first up to 2k limbs and then k limbs at a time, with the running
+ *  remainder in front of each block; every block adds k quotient limbs. Below MODCTX_BARRETT limbs the Knuth
+ *  division of limbs_divmod is faster than two products and is used with the stored m instead.
+ *
+ *  Barrett rather than Montgomery: it gives the quotient as well as the remainder, works for any divisor (not
+ *  only odd ones), and needs no conversion of the operands into and out of a special form.
+ *
+ *     modctx_init / modctx_free   : build / release the context of a divisor
+ *     modctx_divmod               : q = a / m, r = a % m on limbs
+ *     modctx_divmod_list          : the same on digit lists, for perform_operation
+ *     modctx_lookup               : contexts of recent divisors, kept per thread by the --serve workers
+ *     modctx_batch                : ./a.out --modulus <divisor> <%|/> <dividend...|->
+*******************************************************************************************************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "apc.h"
+
+/* Divisors of this many limbs and more use the Barrett reciprocal */
+#define MODCTX_BARRETT 8
+
+/* Divisors remembered by each --serve worker */
+#define MODCTX_CACHE 4
+
+int modctx_init(ModContext *ctx, const Limbs *m)
+{
+	ctx->m = (Limbs){ NULL, 0 };
+	ctx->mu = (Limbs){ NULL, 0 };
+	ctx->k = m->n;
+	if(m->n == 0)
+	{
+		apc_printf("ERROR : Modulus context of zero!\n");
+		return FAILURE;
+	}
+	if(limbs_copy(m, &ctx->m) == FAILURE)
+	{
+		return FAILURE;
+	}
+	if(ctx->k < MODCTX_BARRETT)
+	{
+		return SUCCESS;
+	}
+
+	// mu = ⌊B^(2k) / m⌋, at most k + 1 limbs
+	Limbs power = { apc_calloc(2 * ctx->k + 1, sizeof(uint32_t)), 2 * ctx->k + 1 };
+	if(power.d == NULL)
+	{
+		modctx_free(ctx);
+		return FAILURE;
+	}
+	power.d[2 * ctx->k] = 1;
+	int status = limbs_divmod(&power, &ctx->m, &ctx->mu, NULL);
+	limbs_free(&power);
+	if(status == FAILURE)
+	{
+		modctx_free(ctx);
+	}
+	return status;
+}
+
+void modctx_free(ModContext *ctx)
+{
+	limbs_free(&ctx->m);
+	limbs_free(&ctx->mu);
+	ctx->k = 0;
+}
+
+/* q = x / m, r = x % m for x < B^(2k) (trimmed, not aliasing q or r) */
+static int barrett_step(const ModContext *ctx, const Limbs *x, Limbs *q, Limbs *r)
+{
+	int k = ctx->k;
+	Limbs t = { NULL, 0 };
+	Limbs one = { (uint32_t[]){ 1 }, 1 };
+
+	// q̂ from the top limbs of x and the reciprocal
+	Limbs top = { x->d + (k - 1), x->n - (k - 1) };
+	int status = SUCCESS;
+	if(top.n <= 0)
+	{
+		status = limbs_set_small(q, 0);
+	}
+	else if((status = limbs_mul(&top, &ctx->mu, &t)) == SUCCESS)
+	{
+		Limbs high = { t.d + k + 1, (t.n > k + 1) ? t.n - (k + 1) : 0 };
+		status = limbs_copy(&high, q);
+	}
+
+	// r = x − q̂·m is below 3m
+	if(status == SUCCESS && (status = limbs_mul(q, &ctx->m, &t)) == SUCCESS)
+	{
+		status = limbs_sub(x, &t, r);
+	}
+	while(status == SUCCESS && limbs_cmp(r, &ctx->m) != LESS)
+	{
+		if((status = limbs_sub(r, &ctx->m, r)) == SUCCESS)
+		{
+			status = limbs_add(q, &one, q);
+		}
+	}
+	limbs_free(&t);
+	return status;
+}
+
+/*****************************************************************************************
+ * Function: modctx_divmod
+ * -----------------------
+ * q = a / m and r = a % m for the divisor of the context (either may be NULL, and
+ * either may alias a). a must be trimmed.
+ *****************************************************************************************/
+
+int modctx_divmod(const ModContext *ctx, const Limbs *a, Limbs *q, Limbs *r)
+{
+	int k = ctx->k, n = a->n;
+	if(k < MODCTX_BARRETT)
+	{
+		return limbs_divmod(a, &ctx->m, q, r);
+	}
+
+	// Blocks below the first step: the first takes the top f limbs (k < f ≤ 2k, or all of a)
+	int blocks = (n > 2 * k) ? (n - k - 1) / k : 0;
+	int f = n - blocks * k;
+
+	uint32_t *w = NULL;
+	if(q != NULL && (w = apc_calloc(n + 1, sizeof(uint32_t))) == NULL)
+	{
+		return FAILURE;
+	}
+	Limbs qi = { NULL, 0 }, rem = { NULL, 0 }, x = { NULL, 0 };
+	Limbs first = { a->d + blocks * k, f };
+	int status = barrett_step(ctx, &first, &qi, &rem);
+	if(status == SUCCESS && w != NULL && qi.n > 0)
+	{
+		memcpy(w + blocks * k, qi.d, qi.n * sizeof(uint32_t));
+	}
+
+	// x = rem · B^k + next block; its quotient is below B^k
+	for(int b = blocks - 1; b >= 0 && status == SUCCESS; b--)
+	{
+		uint32_t *d = apc_calloc(k + rem.n + 1, sizeof(uint32_t));
+		if(d == NULL)
+		{
+			status = FAILURE;
+			break;
+		}
+		memcpy(d, a->d + b * k, k * sizeof(uint32_t));
+		if(rem.n > 0)
+		{
+			memcpy(d + k, rem.d, rem.n * sizeof(uint32_t));
+		}
+		limbs_free(&x);
+		x = (Limbs){ d, k + rem.n };
+		limbs_trim(&x);
+		status = barrett_step(ctx, &x, &qi, &rem);
+		if(status == SUCCESS && w != NULL && qi.n > 0)
+		{
+			memcpy(w + b * k, qi.d, qi.n * sizeof(uint32_t));
+		}
+	}
+	limbs_free(&x);
+	limbs_free(&qi);
+
+	if(status == SUCCESS && q != NULL)
+	{
+		limbs_free(q);
+		*q = (Limbs){ w, n + 1 };
+		limbs_trim(q);
+		w = NULL;
+	}
+	if(status == SUCCESS && r != NULL)
+	{
+		limbs_free(r);
+		*r = rem;
+		rem = (Limbs){ NULL, 0 };
+	}
+	apc_free(w);
+	limbs_free(&rem);
+	return status;
+}
+
+/*****************************************************************************************
+ * Function: modctx_divmod_list
+ * ----------------------------
+ * headR = head / m (quotient != 0) or head % m, as a digit list.
+ *****************************************************************************************/
+
+int modctx_divmod_list(const ModContext *ctx, Dlist *head, int quotient, Dlist **headR, Dlist **tailR)
+{
+	Limbs a = { NULL, 0 };
+	if(limbs_from_list(head, &a) == FAILURE)
+	{
+		return FAILURE;
+	}
+	int status = modctx_divmod(ctx, &a, quotient ? &a : NULL, quotient ? NULL : &a);
+	if(status == SUCCESS)
+	{
+		status = limbs_to_list(&a, headR, tailR);
+	}
+	limbs_free(&a);
+	return status;
+}
+
+
+/* ------------------> Per-thread contexts of recent divisors <------------------- */
+
+static __thread ModContext cache[MODCTX_CACHE];
+static __thread long long cache_used[MODCTX_CACHE];     // last use, 0 = empty slot
+static __thread long long cache_clock;
+static __thread int cache_enabled;
+
+/* Keep the contexts of the last MODCTX_CACHE divisors on this thread (the --serve workers) */
+void modctx_cache_enable(void)
+{
+	cache_enabled = 1;
+}
+
+/*****************************************************************************************
+ * Function: modctx_lookup
+ * -----------------------
+ * Context for the divisor `head` from this thread's cache, built in the least recently
+ * used slot on a miss. NULL when caching is off (one-shot runs) or on failure.
+ *****************************************************************************************/
+
+const ModContext *modctx_lookup(Dlist *head)
+{
+	if(!cache_enabled)
+	{
+		return NULL;
+	}
+
+	Limbs m = { NULL, 0 };
+	if(limbs_from_list(head, &m) == FAILURE || m.n == 0)
+	{
+		limbs_free(&m);
+		return NULL;
+	}
+	int slot = 0;
+	for(int i = 0; i < MODCTX_CACHE; i++)
+	{
+		if(cache_used[i] && limbs_cmp(&cache[i].m, &m) == EQUAL)
+		{
+			limbs_free(&m);
+			cache_used[i] = ++cache_clock;
+			return &cache[i];
+		}
+		if(cache_used[i] < cache_used[slot])
+		{
+			slot = i;
+		}
+	}
+
+	if(cache_used[slot])
+	{
+		modctx_free(&cache[slot]);
+		cache_used[slot] = 0;
+	}
+	int status = modctx_init(&cache[slot], &m);
+	limbs_free(&m);
+	if(status == FAILURE)
+	{
+		return NULL;
+	}
+	cache_used[slot] = ++cache_clock;
+	return &cache[slot];
+}
+
+
+/* ------------------> ./a.out --modulus <divisor> <%|/> <dividend...|-> <------------------- */
+
+/* Reduce one dividend string and print its result */
+static int reduce_one(const ModContext *ctx, char divisor_sign, int quotient, const char *s, Limbs *x)
+{
+	if(check_sign(s) == FAILURE || strpbrk(s, "./") != NULL)
+	{
+		apc_printf("ERROR : Invalid dividend '%s'\n", s);
+		return SUCCESS;
+	}
+	const char *digits;
+	char sign = remove_sign(s, &digits);
+	if(limbs_from_string(digits, x) == FAILURE ||
+	   modctx_divmod(ctx, x, quotient ? x : NULL, quotient ? NULL : x) == FAILURE)
+	{
+		return FAILURE;
+	}
+	// Truncating division: the quotient takes the product of the signs, the remainder the dividend's sign
+	if(quotient && divisor_sign == '-')
+	{
+		sign = (sign == '-') ? '+' : '-';
+	}
+	limbs_print_result(sign, x);
+	return SUCCESS;
+}
+
+/*****************************************************************************************
+ * Function: modctx_batch
+ * ----------------------
+ * Build the context of `divisor` once and print dividend % divisor (or / divisor) for
+ * every dividend, one result line each; "-" reads the dividends from stdin, one per line.
+ *****************************************************************************************/
+
+int modctx_batch(const char *divisor, const char *op, int count, char *dividends[])
+{
+	if(strcmp(op, "%") != 0 && strcmp(op, "/") != 0)
+	{
+		printf("ERROR : --modulus supports %% and / only\n");
+		return FAILURE;
+	}
+	if(check_sign(divisor) == FAILURE || strpbrk(divisor, "./") != NULL)
+	{
+		printf("ERROR : Invalid divisor '%s'\n", divisor);
+		return FAILURE;
+	}
+
+	const char *digits;
+	char divisor_sign = remove_sign(divisor, &digits);
+	Limbs m = { NULL, 0 }, x = { NULL, 0 };
+	if(limbs_from_string(digits, &m) == FAILURE)
+	{
+		return FAILURE;
+	}
+	if(m.n == 0)
+	{
+		printf("Result          : Cannot divide by Zero!\n");
+		limbs_free(&m);
+		return SUCCESS;
+	}
+
+	ModContext ctx;
+	int status = modctx_init(&ctx, &m);
+	limbs_free(&m);
+	if(status == FAILURE)
+	{
+		return FAILURE;
+	}
+
+	int quotient = (strcmp(op, "/") == 0);
+	if(count == 1 && strcmp(dividends[0], "-") == 0)
+	{
+		char *line = NULL;
+		size_t size = 0;
+		ssize_t length;
+		while(status == SUCCESS && (length = getline(&line, &size, stdin)) != -1)
+		{
+			while(length > 0 && (line[length - 1] == '\n' || line[length - 1] == '\r'))
+			{
+				line[--length] = '\0';
+			}
+			if(length > 0)
+			{
+				status = reduce_one(&ctx, divisor_sign, quotient, line, &x);
+			}
+		}
+		free(line);
+	}
+	else
+	{
+		for(int i = 0; i < count && status == SUCCESS; i++)
+		{
+			status = reduce_one(&ctx, divisor_sign, quotient, dividends[i], &x);
+		}
+	}
+
+	limbs_free(&x);
+	modctx_free(&ctx);
+	return status;
+}
@@ -12,6 +12,10 @@
  *     head2, tail2 → divisor
  *     headR        → result list that will store the remainder
  *
+ *  Kernels (picked from the registry by divisor length):
+ *     mod_subtract   → long division by repeated list subtraction
+ *     mod_schoolbook → remainder of divmod_digits() (estimated quotient digits)
+ *
  *  Returns:
  *     SUCCESS if remainder is successfully computed
  *     FAILURE if divisor is zero or input lists are invalid
@@ -26,83 +30,31 @@ int modulus(Dlist **head1, Dlist **tail1, Dlist **head2, Dlist **tail2, Dlist **
 	// Validate input lists
 	if(*head1 == NULL || *head2 == NULL)
 	{
-		printf("ERROR : One or Both input Lists are Empty! \n");
+		apc_printf("ERROR : One or Both input Lists are Empty! \n");
 		return FAILURE;
 	}
 
-    // Remove garbage leading zeros from both operands 
-	remove_leading_zeros(head1);
-	remove_leading_zeros(head2);
-
-    // Compare dividend and divisor 
-    int compare = compare_numbers(*head1, *head2);
+	const kernel_t *kernel = select_kernel("mod", find_length(*head2));
+	return kernel->binary(head1, tail1, head2, tail2, headR);
+}
 
-    // Case 1: dividend < divisor → remainder is dividend itself 
-	if(compare == LESS)
+int mod_schoolbook(Dlist **head1, Dlist **tail1, Dlist **head2, Dlist **tail2, Dlist **headR)
+{
+	if(*head1 == NULL || *head2 == NULL)
 	{
-        Dlist *temp = *head1;
-        // Copy entire dividend into result 
-        while(temp)
-        {
-            insert_at_end(headR, tail1, temp->data);
-            temp = temp->next;
-        }
-		return SUCCESS;
+		apc_printf("ERROR : One or Both input Lists are Empty! \n");
+		return FAILURE;
 	}
+	return divmod_schoolbook(*head1, *head2, NULL, headR);
+}
 
-    // Make a working copy of dividend (since we need to modify it) 
-    Dlist *current_head = NULL, *current_tail = NULL;
-    Dlist *ptr = *head1;
-
-    while(ptr)
-    {
-        insert_at_end(&current_head, &current_tail, ptr->data);
-        ptr = ptr->next;
-    }
-
-    // This will accumulate the running remainder 
-    Dlist *rem_head = NULL;
-	Dlist *rem_tail = NULL;
-    ptr = current_head;
-
-    // Long-division style remainder extraction 
-    while(ptr)
-    {
-        // Step 1: Bring down next digit into remainder 
-        insert_at_end(&rem_head, &rem_tail, ptr->data);
-        // Remove zeros that appear at the front 
-        remove_leading_zeros(&rem_head);
-    
-        // Step 2: While remainder >= divisor, subtract divisor 
-        while (compare_numbers(rem_head, *head2) != LESS)
-		{
-			Dlist *temp = NULL;
-
-            // rem_head = rem_head - divisor 
-			subtraction(&rem_head, &rem_tail, head2, tail2, &temp);
-            
-            // Clean up old remainder list 
-			delete_list(&rem_head, &rem_tail);
-
-            // Replace remainder with newly computed one 
-			rem_head = temp;
-			rem_tail = rem_head;
-
-            // Move tail to last node 
-			while(rem_tail && rem_tail->next)
-			{
-				rem_tail = rem_tail->next;
-			}
-		}
-
-        // Move to next digit of dividend 
-        ptr = ptr->next;
-    }
-
-    // Remove any final leading zeros like 0003 → 3 
-    remove_leading_zeros(&rem_head);
-	// Store final remainder in result pointer 
-    *headR = rem_head;
-
-    return SUCCESS;
-}
\ No newline at end of file
+int mod_subtract(Dlist **head1, Dlist **tail1, Dlist **head2, Dlist **tail2, Dlist **headR)
+{
+	// Validate input lists
+	if(*head1 == NULL || *head2 == NULL)
+	{
+		apc_printf("ERROR : One or Both input Lists are Empty! \n");
+		return FAILURE;
+	}
+	return divmod_subtract(*head1, *head2, *tail2, NULL, headR);
+}
@@ -10,11 +10,15 @@
  *     Result: 5 <-> 5 <-> 3 <-> 5  (represents 5535)
  *
  *  Algorithm:
- *     - Perform digit-by-digit multiplication similar to manual long multiplication.
- *     - For each digit in the second number (starting from least significant),
- *       multiply it by all digits of the first number.
- *     - Generate partial results, shift appropriately (append zeros),
- *       and add to cumulative result.
+ *     multiplication() picks a kernel from the registry by the longer operand length:
+ *     - mul_basecase  : column multiplication (below)
+ *     - mul_karatsuba : Karatsuba recursion (karatsuba.c)
+ *
+ *  mul_basecase:
+ *     - The product is a multiply-accumulate into an empty (zero) result: R = 0 + A × B.
+ *     - addmul() sums every digit-by-digit product into its column first and then
+ *       resolves all carries in one pass, so no partial product list is ever built
+ *       and the running result is never re-added or re-walked.
  *
  *  Parameters:
  *     head1, tail1 → pointers to first and last node of first number
@@ -35,94 +39,40 @@ int multiplication(Dlist **head1, Dlist **tail1, Dlist **head2, Dlist **tail2, D
     // Validate input lists (both numbers must exist)
 	if(*head1 == NULL || *head2 == NULL)
 	{
-		printf("ERROR : One or Both input Lists are Empty! \n");
+		apc_printf("ERROR : One or Both input Lists are Empty! \n");
 		return FAILURE;
 	}
 
-    // Final result list
-    Dlist *result_head = NULL, *result_tail = NULL;
+    int len1 = find_length(*head1);
+    int len2 = find_length(*head2);
 
-    // Start multiplying from LSB of second number
-	Dlist *t2 = *tail2;
-	int shift = 0;  // How many zeroes to append (place value)
+    const kernel_t *kernel = select_kernel("mul", (len1 > len2) ? len1 : len2);
+    return kernel->binary(head1, tail1, head2, tail2, headR);
+}
 
-	while(t2 != NULL)
+int mul_basecase(Dlist **head1, Dlist **tail1, Dlist **head2, Dlist **tail2, Dlist **headR)
+{
+    // Validate input lists (both numbers must exist)
+	if(*head1 == NULL || *head2 == NULL)
 	{
-        // Partial product list for each digit of num2
-		Dlist *partial_head = NULL, *partial_tail = NULL;
-		int carry = 0;
-
-		// Start from LSB of first number
-		Dlist *t1 = *tail1;
-
-        // Multiply one digit of num2 with entire num1
-		while(t1 != NULL)
-		{
-			int product = (t1->data * t2->data) + carry;    // multiply + carry
-			carry = product / 10;                          // next carry
-			product = product % 10;                        // single digit result
-
-            // Insert at front because we are traversing digits right→left
-			insert_at_begin(&partial_head, &partial_tail, product);
-
-			t1 = t1->prev;   // move to next more significant digit
-		}
-
-        // If leftover carry exists, add it at the beginning
-		if(carry)
-		{
-			insert_at_begin(&partial_head, &partial_tail, carry);
-		}
-
-        // Append zeros at the end to match place value of current digit in num2
-		for(int i = 0; i < shift; i++)
-		{
-			insert_at_end(&partial_head, &partial_tail, 0);
-		}
-
-        // First partial product → directly copy to result
-		if(result_head == NULL)
-		{
-			Dlist *temp = partial_head;
-			while(temp)
-			{
-				insert_at_end(&result_head, &result_tail, temp->data);
-				temp = temp->next;
-			}
-		}
-        else
-		{
-            // Add partial product to cumulative result
-			Dlist *new_head = NULL , *new_tail = NULL;
-
-			addition(&result_head, &result_tail, &partial_head, &partial_tail, &new_head);
-
-            // Delete old result and replace with updated one
-			delete_list(&result_head, &result_tail);
-			result_head = new_head;
-
-            // Move to tail of the updated result
-			Dlist *temp = result_head;
-			while(temp && temp->next)
-			{
-				temp = temp->next;
-			}
-			result_tail = temp;
-		}
+		apc_printf("ERROR : One or Both input Lists are Empty! \n");
+		return FAILURE;
+	}
 
-        // Clear partial list after use
-		delete_list(&partial_head, &partial_tail);
+    // Final result list, starts empty (zero)
+    Dlist *result_head = NULL, *result_tail = NULL;
 
-        // Next digit of num2 gets one more trailing zero
-		shift++;
+    // Accumulate A × B directly into the result
+    if(addmul(&result_head, &result_tail, head1, tail1, head2, tail2) == FAILURE)
+    {
+        delete_list(&result_head, &result_tail);
+        return FAILURE;
+    }
 
-        // Move to next more significant digit of num2
-        t2 = t2->prev; 
-	}
+    // Column count is len1 + len2; drop the unused top column if any
+    remove_leading_zeros(&result_head);
 
     // Store final result list
 	*headR = result_head;
 	return SUCCESS;
 }
-
-
@@ -2,15 +2,18 @@
 /********************************************************************************************************************************************************************
  * Function: perform_operation
  * ---------------------------
- *  Performs arithmetic operations (+, -, *, /, ^) on two large numbers
- *  represented as doubly linked lists.
+ *  Performs the binary operations (+, -, *, /, %, ^, iroot, binomial, cmp, gcd, xgcd,
+ *  invmod) on two large numbers represented as doubly linked lists.
  *
  *  Each number has a sign ('+' or '-') and digits stored in separate lists.
  *
  *  Handles all combinations of signs and operations, and prints the final result.
+ *  Operands of up to 38 digits are computed in native 128-bit arithmetic first
+ *  (small_operation), unless that path is off (--no-small).
  *
  *  Parameters:
- *     op        → Operator symbol: "+", "-", "*", "/", "^"
+ *     op        → Operator: "+", "-", "*", "/", "%", "^", "iroot", "binomial", "cmp",
+ *                   "gcd", "xgcd" or "invmod"
  *     sign1     → Sign of first number ('+' or '-')
  *     sign2     → Sign of second number ('+' or '-')
  *     head1, tail1 → Head and tail of first number's linked list
@@ -19,8 +22,8 @@
  *     digits1, digits2 → Input digit strings (used to check for zero cases)
  *
  *  Returns:
- *     SUCCESS (0) after performing and printing the result.
- *     FAILURE is not used here but can be extended if an operation fails.
+ *     SUCCESS (0) after printing the result (or a message such as "Cannot divide by Zero!"),
+ *     FAILURE (-1) if a kernel fails (memory allocation, a memory cap) or op is unknown.
 *******************************************************************************************************************************************************************/
 
 
@@ -36,6 +39,13 @@ int perform_operation(const char *op,
                       Dlist **headR, Dlist **tailR, 
                       const char *digits1, const char *digits2)
 {
+    // Operands of up to 38 digits: native 128-bit arithmetic, the lists are not touched (small.c)
+    if(small_operation(op, sign1, digits1, sign2, digits2, 0) == SUCCESS)
+        return SUCCESS;
+
+    // Kernel crossover sizes tuned for this host (./a.out --tune), if present
+    load_thresholds(NULL);
+
     // Step 1: Compare the magnitudes of the two numbers
     int compare = compare_numbers(*head1 , *head2);
     char result_sign = '+'; // default sign of result
@@ -48,7 +58,8 @@ int perform_operation(const char *op,
         {
             if (strcmp(op, "+") == 0)      // +a + +b
             {
-                addition(head1, tail1, head2, tail2, headR);
+                if(addition(head1, tail1, head2, tail2, headR) == FAILURE)
+                    return FAILURE;
                 result_sign = '+';
             }
             else if(strcmp(op, "-") == 0)  // +a - +b 
@@ -56,11 +67,13 @@ int perform_operation(const char *op,
                 // If both numbers are equal, result is zero
                 if(compare == EQUAL)
                 {
-                    printf("Result          : 0\n");
+                    apc_printf("Result          : 0\n");
+                    PROFILE_RESULT_DIGITS(1);
                     return SUCCESS;
                 }
 
-                subtraction(head1, tail1, head2, tail2, headR);
+                if(subtraction(head1, tail1, head2, tail2, headR) == FAILURE)
+                    return FAILURE;
                 result_sign = (compare == GREATER) ? '+' : '-';
             }        
         }
@@ -70,18 +83,21 @@ int perform_operation(const char *op,
         {
             if (strcmp(op, "+") == 0)      // -a + -b 
             {
-                addition(head1, tail1, head2, tail2, headR);
+                if(addition(head1, tail1, head2, tail2, headR) == FAILURE)
+                    return FAILURE;
                 result_sign = '-';
             }
             else if(strcmp(op, "-") == 0)  // -a - -b 
             {
                 if(compare == EQUAL)
                 {
-                    printf("Result          : 0\n");
+                    apc_printf("Result          : 0\n");
+                    PROFILE_RESULT_DIGITS(1);
                     return SUCCESS;
                 }
 
-                subtraction(head1, tail1, head2, tail2, headR);
+                if(subtraction(head1, tail1, head2, tail2, headR) == FAILURE)
+                    return FAILURE;
                 // Result sign depends on which absolute value is larger
                 result_sign = (compare == GREATER) ? '-' : '+';
             }  
@@ -94,16 +110,19 @@ int perform_operation(const char *op,
             {
                 if(compare == EQUAL)
                 {
-                    printf("Result          : 0\n");
+                    apc_printf("Result          : 0\n");
+                    PROFILE_RESULT_DIGITS(1);
                     return SUCCESS;
                 }
 
-                subtraction(head1, tail1, head2, tail2, headR);
+                if(subtraction(head1, tail1, head2, tail2, headR) == FAILURE)
+                    return FAILURE;
                 result_sign = (compare == GREATER) ? '+' : '-';
             }
             else if(strcmp(op, "-") == 0)  // +a - -b 
             {
-                addition(head1, tail1, head2, tail2, headR);
+                if(addition(head1, tail1, head2, tail2, headR) == FAILURE)
+                    return FAILURE;
                 result_sign = '+';
             }  
         }
@@ -115,23 +134,25 @@ int perform_operation(const char *op,
             {
                 if(compare == EQUAL)
                 {
-                    printf("Result          : 0\n");
+                    apc_printf("Result          : 0\n");
+                    PROFILE_RESULT_DIGITS(1);
                     return SUCCESS;
                 }
 
-                subtraction(head1, tail1, head2, tail2, headR);
+                if(subtraction(head1, tail1, head2, tail2, headR) == FAILURE)
+                    return FAILURE;
                 result_sign = (compare == GREATER) ? '-' : '+';
             }
             else if(strcmp(op, "-") == 0)  // -a - +b 
             {
-                addition(head1, tail1, head2, tail2, headR);
+                if(addition(head1, tail1, head2, tail2, headR) == FAILURE)
+                    return FAILURE;
                 result_sign = '-';
             }  
         }
 
         // Print the final result for + and - operations
-        printf("Result          : %c", result_sign);
-        remove_leading_zeros(headR);
+        apc_printf("Result          : %c", result_sign);
         print_list(*headR);
         return SUCCESS;
     }
@@ -142,12 +163,14 @@ int perform_operation(const char *op,
         // Check for zero multiplication cases
         if((strcmp(digits1, "0") == 0) || (strcmp(digits2, "0") == 0))
         {
-            printf("Result          : 0\n");
+            apc_printf("Result          : 0\n");
+            PROFILE_RESULT_DIGITS(1);
             return SUCCESS;
         }
 
         // Perform multiplication
-        multiplication(head1, tail1, head2, tail2, headR);
+        if(multiplication(head1, tail1, head2, tail2, headR) == FAILURE)
+            return FAILURE;
 
         // Determine result sign based on input signs
         if((sign1 == '-' && sign2 == '+') || (sign1 == '+' && sign2 == '-'))
@@ -155,16 +178,14 @@ int perform_operation(const char *op,
         else
             result_sign = '+';
 
-        // Clean result (remove unnecessary zeros)
-        remove_leading_zeros(headR);
-
         // Check if the final list represents zero
         if(result_is_zero(*headR) == SUCCESS)
         {
-            printf("Result          : 0\n");
+            apc_printf("Result          : 0\n");
+            PROFILE_RESULT_DIGITS(1);
             return SUCCESS;
         }
-        printf("Result          : %c", result_sign);
+        apc_printf("Result          : %c", result_sign);
         print_list(*headR);
         return SUCCESS;
     }
@@ -175,15 +196,16 @@ int perform_operation(const char *op,
         // Case: 0 raised to anything is 0
         if(strcmp(digits1, "0") == 0)
         {
-            printf("Result          : 0\n");
+            apc_printf("Result          : 0\n");
+            PROFILE_RESULT_DIGITS(1);
             return SUCCESS;
         }
         else
         {
             // The provided 'square()' function handles only squaring (a^2)
-            square(head1 ,tail1 ,headR);
-            printf("Result          : +");
-            remove_leading_zeros(headR);
+            if(square(head1 ,tail1 ,headR) == FAILURE)
+                return FAILURE;
+            apc_printf("Result          : +");
             print_list(*headR);
             return SUCCESS;
         }
@@ -195,21 +217,29 @@ int perform_operation(const char *op,
         // Case: 0 ÷ anything = 0
         if(strcmp(digits1, "0") == 0)
         {
-            printf("Result          : 0\n");
+            apc_printf("Result          : 0\n");
+            PROFILE_RESULT_DIGITS(1);
             return SUCCESS;
         }
 
         // Case: Division by zero is invalid
         else if(strcmp(digits2, "0") == 0)
         {
-            printf("Result          : Cannot divide by Zero!\n");
+            apc_printf("Result          : Cannot divide by Zero!\n");
             return SUCCESS;
         }
 
         else
         {
-            // Perform division
-            division(head1, tail1, head2, tail2, headR);
+            // Perform division (a --serve worker reuses the reciprocal of a recent divisor)
+            const ModContext *ctx = modctx_lookup(*head2);
+            if(ctx != NULL)
+            {
+                if(modctx_divmod_list(ctx, *head1, 1, headR, tailR) == FAILURE)
+                    return FAILURE;
+            }
+            else if(division(head1, tail1, head2, tail2, headR) == FAILURE)
+                return FAILURE;
 
             // Determine result sign (negative if signs differ)
             if((sign1 == '-' && sign2 == '+') || (sign1 == '+' && sign2 == '-'))
@@ -217,16 +247,14 @@ int perform_operation(const char *op,
             else
                 result_sign = '+';   
 
-            // Clean result (remove unnecessary zeros)
-            remove_leading_zeros(headR);
-
             // Check if the final list represents zero
             if(result_is_zero(*headR) == SUCCESS)
             {
-                printf("Result          : 0\n");
+                apc_printf("Result          : 0\n");
+                PROFILE_RESULT_DIGITS(1);
                 return SUCCESS;
             }
-            printf("Result          : %c", result_sign);
+            apc_printf("Result          : %c", result_sign);
             print_list(*headR);
             return SUCCESS;
         
@@ -239,35 +267,441 @@ int perform_operation(const char *op,
         // Case: 0 ÷ anything = 0
         if(strcmp(digits1, "0") == 0)
         {
-            printf("Result          : 0\n");
+            apc_printf("Result          : 0\n");
+            PROFILE_RESULT_DIGITS(1);
             return SUCCESS;
         }
 
         // Case: Division by zero is invalid
         else if(strcmp(digits2, "0") == 0)
         {
-            printf("Result          : Cannot perform modulus by Zero!\n");
+            apc_printf("Result          : Cannot perform modulus by Zero!\n");
             return SUCCESS;
         }
 
         else
         {
-            // Perform division
-            modulus(head1, tail1, head2, tail2, headR);
+            // Perform modulus (a --serve worker reuses the reciprocal of a recent divisor)
+            const ModContext *ctx = modctx_lookup(*head2);
+            if(ctx != NULL)
+            {
+                if(modctx_divmod_list(ctx, *head1, 0, headR, tailR) == FAILURE)
+                    return FAILURE;
+            }
+            else if(modulus(head1, tail1, head2, tail2, headR) == FAILURE)
+                return FAILURE;
 
             result_sign = sign1;
-            // Clean result (remove unnecessary zeros)
-            remove_leading_zeros(headR);
-
             // Check if the final list represents zero
             if(result_is_zero(*headR) == SUCCESS)
             {
-                printf("Result          : 0\n");
+                apc_printf("Result          : 0\n");
+                PROFILE_RESULT_DIGITS(1);
                 return SUCCESS;
             }
-            printf("Result          : %c", result_sign);
+            apc_printf("Result          : %c", result_sign);
             print_list(*headR);
             return SUCCESS;
         }
     }
-}
\ No newline at end of file
+
+    /* =========================== INTEGER K-TH ROOT =========================== */
+    else if(strcmp(op, "iroot") == 0)
+    {
+        long long k;
+        if(sign2 == '-' || list_to_long(*head2, &k) == FAILURE || k < 1 || k > 1000000)
+        {
+            apc_printf("Result          : Root degree must be between 1 and 1000000!\n");
+            return SUCCESS;
+        }
+
+        // Even roots of negative numbers are not real
+        if(sign1 == '-' && k % 2 == 0 && result_is_zero(*head1) == FAILURE)
+        {
+            apc_printf("Result          : Even root of a negative number!\n");
+            return SUCCESS;
+        }
+
+        if(iroot(head1, tail1, k, headR) == FAILURE)
+            return FAILURE;
+
+        // Odd root keeps the sign (truncated toward zero)
+        if(result_is_zero(*headR) == SUCCESS)
+        {
+            apc_printf("Result          : 0\n");
+            PROFILE_RESULT_DIGITS(1);
+            return SUCCESS;
+        }
+        apc_printf("Result          : %c", sign1);
+        print_list(*headR);
+        return SUCCESS;
+    }
+
+    /* =========================== BINOMIAL COEFFICIENT =========================== */
+    else if(strcmp(op, "binomial") == 0)
+    {
+        long long n, k;
+        if(sign1 == '-' || list_to_long(*head1, &n) == FAILURE || n > FACTORIAL_MAX)
+        {
+            apc_printf("Result          : n must be between 0 and %d!\n", FACTORIAL_MAX);
+            return SUCCESS;
+        }
+
+        // C(n, k) = 0 outside 0 <= k <= n
+        if(list_to_long(*head2, &k) == FAILURE || k > n)
+            k = n + 1;
+        if(sign2 == '-' && k != 0)
+            k = -1;
+
+        if(binomial(n, k, headR) == FAILURE)
+            return FAILURE;
+        apc_printf("Result          : %s", (result_is_zero(*headR) == SUCCESS) ? "" : "+");
+        print_list(*headR);
+        return SUCCESS;
+    }
+
+    /* =========================== COMPARISON =========================== */
+    else if(strcmp(op, "cmp") == 0)
+    {
+        // Zero has no sign; otherwise the signs decide before the magnitudes
+        int zero1 = (result_is_zero(*head1) == SUCCESS), zero2 = (result_is_zero(*head2) == SUCCESS);
+        char s1 = zero1 ? '+' : sign1, s2 = zero2 ? '+' : sign2;
+        int result;
+
+        if(s1 != s2)
+            result = (s1 == '+') ? GREATER : LESS;
+        else
+            result = (s1 == '+') ? compare : -compare;
+        apc_printf("Result          : %d\n", result);
+        return SUCCESS;
+    }
+
+    /* =========================== GCD / EXTENDED GCD / MODULAR INVERSE =========================== */
+    else if(strcmp(op, "gcd") == 0)
+    {
+        // gcd of the magnitudes, always non-negative
+        if(gcd(head1, tail1, head2, tail2, headR) == FAILURE)
+            return FAILURE;
+        // Non-negative: + like every other non-zero result
+        apc_printf("Result          : %s", (result_is_zero(*headR) == SUCCESS) ? "" : "+");
+        print_list(*headR);
+        return SUCCESS;
+    }
+    else if(strcmp(op, "xgcd") == 0)
+    {
+        Dlist *headS = NULL, *headT = NULL;
+        char sign_s, sign_t;
+
+        if(xgcd(*head1, *head2, headR, &headS, &sign_s, &headT, &sign_t) == FAILURE)
+            return FAILURE;
+
+        // a·s + b·t = g for the magnitudes; a negative operand flips its coefficient
+        if(sign1 == '-' && result_is_zero(headS) == FAILURE)
+            sign_s = (sign_s == '+') ? '-' : '+';
+        if(sign2 == '-' && result_is_zero(headT) == FAILURE)
+            sign_t = (sign_t == '+') ? '-' : '+';
+
+        apc_printf("Result          : %s", (result_is_zero(*headR) == SUCCESS) ? "" : "+");
+        print_list(*headR);
+        apc_printf("Coefficient s   : %c", sign_s);
+        print_list(headS);
+        apc_printf("Coefficient t   : %c", sign_t);
+        print_list(headT);
+        Dlist *tail = NULL;
+        delete_list(&headS, &tail);
+        delete_list(&headT, &tail);
+        return SUCCESS;
+    }
+    else if(strcmp(op, "invmod") == 0)
+    {
+        if(result_is_zero(*head2) == SUCCESS)
+        {
+            apc_printf("Result          : Modulus must be non-zero!\n");
+            return SUCCESS;
+        }
+        if(invmod(head1, tail1, head2, tail2, headR) == FAILURE)
+            return FAILURE;
+        if(*headR == NULL)
+        {
+            apc_printf("Result          : No inverse (gcd != 1)\n");
+            return SUCCESS;
+        }
+
+        // (-a)^-1 = m - a^-1 (mod m); the sign of the modulus does not matter
+        if(sign1 == '-' && result_is_zero(*headR) == FAILURE)
+        {
+            Dlist *inverse = *headR, *inverse_tail = list_tail(inverse);
+            *headR = NULL;
+            if(list_writable(head2, tail2) == FAILURE)
+                return FAILURE;
+            remove_leading_zeros(head2);
+            *tail2 = list_tail(*head2);
+            int status = subtraction(head2, tail2, &inverse, &inverse_tail, headR);
+            delete_list(&inverse, &inverse_tail);
+            if(status == FAILURE)
+                return FAILURE;
+            remove_leading_zeros(headR);
+        }
+        // Non-negative: + like every other non-zero result
+        apc_printf("Result          : %s", (result_is_zero(*headR) == SUCCESS) ? "" : "+");
+        print_list(*headR);
+        return SUCCESS;
+    }
+
+    // Unknown operator (rejected earlier by validate_arguments)
+    return FAILURE;
+}
+
+
+/********************************************************************************************************************************************************************
+ * Function: perform_unary_operation
+ * ---------------------------------
+ *  Performs operators that take a single operand and prints the result:
+ *     isqrt     → integer square root (largest r with r² <= N)
+ *     isprime   → prime / probable prime / composite (negative N, 0 and 1 are composite)
+ *     nextprime → smallest prime greater than N
+ *     factor    → prime factorization, -1 first for negative N
+ *     !         → factorial (prime-swing, product trees)
+ *
+ *  Parameters:
+ *     op            → Operator name
+ *     sign1         → Sign of the operand ('+' or '-')
+ *     head1, tail1  → Operand list
+ *     headR, tailR  → Result list
+ *
+ *  Returns:
+ *     SUCCESS (0) after printing the result, FAILURE (-1) if a kernel fails.
+*******************************************************************************************************************************************************************/
+
+int perform_unary_operation(const char *op, char sign1, Dlist **head1, Dlist **tail1, Dlist **headR, Dlist **tailR)
+{
+    /* =========================== INTEGER SQUARE ROOT =========================== */
+    if(strcmp(op, "isqrt") == 0)
+    {
+        if(sign1 == '-' && result_is_zero(*head1) == FAILURE)
+        {
+            apc_printf("Result          : Square root of a negative number!\n");
+            return SUCCESS;
+        }
+        if(isqrt(head1, tail1, headR) == FAILURE)
+            return FAILURE;
+
+        if(result_is_zero(*headR) == SUCCESS)
+        {
+            apc_printf("Result          : 0\n");
+            PROFILE_RESULT_DIGITS(1);
+            return SUCCESS;
+        }
+        apc_printf("Result          : +");
+        print_list(*headR);
+        return SUCCESS;
+    }
+
+    /* =========================== PRIMALITY =========================== */
+    if(strcmp(op, "isprime") == 0)
+    {
+        // Primes are positive: like 0 and 1, a negative number is reported as composite
+        if(sign1 == '-')
+        {
+            apc_printf("Result          : composite\n");
+            return SUCCESS;
+        }
+        int result = isprime(head1, tail1);
+        if(result == FAILURE)
+            return FAILURE;
+        apc_printf("Result          : %s\n", (result == 2) ? "prime" : (result == 1) ? "probable prime" : "composite");
+        return SUCCESS;
+    }
+
+    /* =========================== NEXT PRIME =========================== */
+    if(strcmp(op, "nextprime") == 0)
+    {
+        // Every prime exceeds a negative number: the answer is 2
+        if(sign1 == '-')
+        {
+            list_release(head1, tail1);
+            if(insert_at_end(head1, tail1, 0) == FAILURE)
+                return FAILURE;
+        }
+        if(nextprime(head1, tail1, headR) == FAILURE)
+            return FAILURE;
+        apc_printf("Result          : +");
+        print_list(*headR);
+        return SUCCESS;
+    }
+
+    /* =========================== FACTORIAL =========================== */
+    if(strcmp(op, "!") == 0)
+    {
+        long long n;
+        if((sign1 == '-' && result_is_zero(*head1) == FAILURE) || list_to_long(*head1, &n) == FAILURE || n > FACTORIAL_MAX)
+        {
+            apc_printf("Result          : n must be between 0 and %d!\n", FACTORIAL_MAX);
+            return SUCCESS;
+        }
+        if(factorial(n, headR) == FAILURE)
+            return FAILURE;
+        apc_printf("Result          : +");
+        print_list(*headR);
+        return SUCCESS;
+    }
+
+    /* =========================== FACTORIZATION =========================== */
+    if(strcmp(op, "factor") == 0)
+    {
+        apc_printf("Result          : ");
+        // 0, 1 and -1 have no prime factors
+        if((*head1)->next == NULL && (*head1)->data <= 1)
+        {
+            apc_printf("%s%d\n", (sign1 == '-' && (*head1)->data) ? "-" : "", (*head1)->data);
+            return SUCCESS;
+        }
+        if(sign1 == '-')
+            apc_printf("-1 * ");
+        return factor(head1, tail1);
+    }
+
+    // Unknown operator (rejected earlier by validate_arguments)
+    return FAILURE;
+}
+
+/********************************************************************************************************************************************************************
+ * Function: perform_list_operation
+ * --------------------------------
+ *  Performs operators that combine every operand on the command line and prints the result:
+ *     prod → num1 × num2 × ... through a balanced product tree
+ *
+ *  Parameters:
+ *     op     → Operator name
+ *     count  → Number of operands
+ *     signs  → Sign of each operand ('+' or '-')
+ *     heads  → Operand lists
+ *     headR  → Result list
+ *
+ *  Returns:
+ *     SUCCESS (0) after printing the result, FAILURE (-1) if a kernel fails.
+*******************************************************************************************************************************************************************/
+
+int perform_list_operation(const char *op, int count, const char *signs, Dlist **heads, Dlist **headR)
+{
+    /* =========================== PRODUCT =========================== */
+    if(strcmp(op, "prod") == 0)
+    {
+        if(product_list(heads, count, headR) == FAILURE)
+            return FAILURE;
+        if(result_is_zero(*headR) == SUCCESS)
+        {
+            apc_printf("Result          : 0\n");
+            PROFILE_RESULT_DIGITS(1);
+            return SUCCESS;
+        }
+
+        // Negative if an odd number of factors is negative
+        int negative = 0;
+        for(int i = 0; i < count; i++)
+            negative ^= (signs[i] == '-');
+        apc_printf("Result          : %c", negative ? '-' : '+');
+        print_list(*headR);
+        return SUCCESS;
+    }
+
+    // Unknown operator (rejected earlier by validate_arguments)
+    return FAILURE;
+}
+
+/********************************************************************************************************************************************************************
+ * Function: perform_fused_operation
+ * ---------------------------------
+ *  Performs the three-operand operations on signed operands:
+ *     addmul → R = R + (A × B)
+ *     submul → R = R - (A × B)
+ *     powmod → R = R^A mod B (in [0, B); A must not be negative, B must be positive)
+ *
+ *  For addmul / submul the sign of the product term decides whether its magnitude is
+ *  added to or subtracted from R; the magnitude kernels addmul() / submul() update R in
+ *  place. powmod replaces R with the power (fixed.c).
+ *
+ *  Parameters:
+ *     op            → "addmul", "submul" or "powmod"
+ *     signR         → Sign of the accumulator, or of the base for powmod ('+' or '-')
+ *     sign1, sign2  → Signs of the two other operands
+ *     headR, tailR  → Accumulator or base list (updated in place with the result)
+ *     head1, tail1  → First factor, or the exponent
+ *     head2, tail2  → Second factor, or the modulus
+ *
+ *  Returns:
+ *     SUCCESS (0) after performing and printing the result, FAILURE (-1) if a kernel fails.
+*******************************************************************************************************************************************************************/
+
+int perform_fused_operation(const char *op,
+                            char signR, char sign1, char sign2,
+                            Dlist **headR, Dlist **tailR,
+                            Dlist **head1, Dlist **tail1,
+                            Dlist **head2, Dlist **tail2)
+{
+    // R is updated in place: it must not be shared with a factor
+    if(list_writable(headR, tailR) == FAILURE)
+        return FAILURE;
+
+    // Modular power: R = R^A mod B (fixed.c)
+    if(strcmp(op, "powmod") == 0)
+    {
+        if(sign1 == '-' && result_is_zero(*head1) == FAILURE)
+        {
+            apc_printf("Result          : Exponent must not be negative!\n");
+            return SUCCESS;
+        }
+        if(sign2 == '-' || result_is_zero(*head2) == SUCCESS)
+        {
+            apc_printf("Result          : Modulus must be positive!\n");
+            return SUCCESS;
+        }
+        if(powmod(headR, tailR, signR, *head1, *head2) == FAILURE)
+            return FAILURE;
+        if(result_is_zero(*headR) == SUCCESS)
+        {
+            apc_printf("Result          : 0\n");
+            PROFILE_RESULT_DIGITS(1);
+            return SUCCESS;
+        }
+        apc_printf("Result          : +");
+        print_list(*headR);
+        return SUCCESS;
+    }
+
+    // Sign of the term being accumulated: sign(A × B), flipped for submul
+    char term_sign = (sign1 == sign2) ? '+' : '-';
+    if(strcmp(op, "submul") == 0)
+    {
+        term_sign = (term_sign == '+') ? '-' : '+';
+    }
+
+    char result_sign = signR;
+
+    if(term_sign == signR)
+    {
+        // Same direction: magnitudes add up, sign of R is kept
+        if(addmul(headR, tailR, head1, tail1, head2, tail2) == FAILURE)
+            return FAILURE;
+    }
+    else
+    {
+        // Opposite direction: |R| - |A × B|, sign flips if the product was larger
+        int borrow = 0;
+        if(submul(headR, tailR, head1, tail1, head2, tail2, &borrow) == FAILURE)
+            return FAILURE;
+        if(borrow)
+            result_sign = term_sign;
+    }
+
+    // Check if the final list represents zero
+    if(result_is_zero(*headR) == SUCCESS)
+    {
+        apc_printf("Result          : 0\n");
+        PROFILE_RESULT_DIGITS(1);
+        return SUCCESS;
+    }
+    apc_printf("Result          : %c", result_sign);
+    print_list(*headR);
+    return SUCCESS;
+}
@@ -0,0 +1,709 @@
+/*******************************************************************************************************************************************************************
+ * Function: OUT-OF-CORE ARITHMETIC
+ * --------------------------------
+ *  +, -, * and cmp on numbers that are too large to hold as digit lists (or in RAM at all).
+ *
+ *  Usage:
+ *     ./a.out --out-of-core [--memory MB] <file1> <operator> <file2> [<result file>]
+ *
+ *  Each operand file holds one decimal number ([+|-]digits, surrounding whitespace ignored). Operands and
+ *  intermediates live in unlinked temporary files under $TMPDIR (default /tmp) as little-endian base-10^9
+ *  limbs, and every pass streams over them OOC_CHUNK limbs at a time, so resident memory does not grow
+ *  with the operand size:
+ *     - parsing reads the text backwards in blocks of 9·OOC_CHUNK digits, printing writes it forwards;
+ *     - add / sub / compare walk the limb files chunk by chunk (from the bottom, resp. the top);
+ *     - multiplication is a blocked NTT. For a transform length N the operands are cut into blocks of
+ *       L = (N - 6) / 6 limbs (3L base-1000 digits), every block is transformed once under two NTT primes
+ *       (998244353 and 469762049) and its transform is stored on disk. Output block k is Σ A_i·B_(k-i):
+ *       the products are summed in the transform domain, so each output block needs one inverse transform,
+ *       then the CRT, carry propagation and a carried add into a window of 2L + 2 limbs, whose lowest L
+ *       limbs are final and written out.
+ *       The transform length N is the largest power of two (at most 2^23) whose working set of about
+ *       40·N bytes fits in --memory (default OOC_MEMORY_DEFAULT MB). Disk traffic grows with
+ *       (size / L)^2, so a larger budget means fewer, larger blocks.
+ *
+ *  A convolution coefficient is at most min(len)·999^2 < 998244353·469762049 for operands below about
+ *  10^11 digits, so two primes reconstruct it exactly.
+ *
+ *  Returns:
+ *     SUCCESS (0) if the result is computed
+ *     FAILURE (-1) on an unreadable operand, an unknown operator, an I/O error or allocation failure
+*******************************************************************************************************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "apc.h"
+
+/* Limbs per streamed chunk (4 MB) */
+#define OOC_CHUNK    (1 << 20)
+
+/* Largest transform: 2^23 divides p - 1 for both primes */
+#define NTT_MAX_LOG  23
+
+static const uint32_t ntt_primes[2] = { 998244353u, 469762049u };   // both have primitive root 3
+
+/* Number stored in a temporary file: n limbs (base 10^9, little-endian), n == 0 is zero */
+typedef struct
+{
+	int fd;
+	long long n;
+	char sign;
+}OocNumber;
+
+/* ------------------------------------------- file-backed buffers ------------------------------------------- */
+
+/* New, empty, already unlinked temporary file */
+static int ooc_create(OocNumber *x)
+{
+	const char *dir = getenv("TMPDIR");
+	char path[4096];
+	snprintf(path, sizeof(path), "%s/apc-ooc-XXXXXX", (dir && *dir) ? dir : "/tmp");
+
+	x->fd = mkstemp(path);
+	x->n = 0;
+	x->sign = '+';
+	if(x->fd < 0)
+	{
+		apc_printf("ERROR : Cannot create a temporary file in %s\n", (dir && *dir) ? dir : "/tmp");
+		return FAILURE;
+	}
+	unlink(path);
+	return SUCCESS;
+}
+
+static void ooc_close(OocNumber *x)
+{
+	if(x->fd >= 0)
+	{
+		close(x->fd);
+	}
+	x->fd = -1;
+}
+
+/* buf = limbs [at, at + count); limbs at or beyond x->n read as zero */
+static int ooc_read(const OocNumber *x, long long at, long long count, uint32_t *buf)
+{
+	long long stored = (at >= x->n) ? 0 : ((x->n - at < count) ? x->n - at : count);
+	char *p = (char *)buf;
+	long long left = stored * (long long)sizeof(uint32_t), offset = at * (long long)sizeof(uint32_t);
+
+	while(left > 0)
+	{
+		ssize_t got = pread(x->fd, p, left, offset);
+		if(got <= 0)
+		{
+			apc_printf("ERROR : Read from temporary file failed!\n");
+			return FAILURE;
+		}
+		p += got;
+		offset += got;
+		left -= got;
+	}
+	memset(buf + stored, 0, (count - stored) * sizeof(uint32_t));
+	return SUCCESS;
+}
+
+/* limbs [at, at + count) = buf */
+static int ooc_write(OocNumber *x, long long at, long long count, const uint32_t *buf)
+{
+	const char *p = (const char *)buf;
+	long long left = count * (long long)sizeof(uint32_t), offset = at * (long long)sizeof(uint32_t);
+
+	while(left > 0)
+	{
+		ssize_t put = pwrite(x->fd, p, left, offset);
+		if(put <= 0)
+		{
+			apc_printf("ERROR : Write to temporary file failed (disk full?)\n");
+			return FAILURE;
+		}
+		p += put;
+		offset += put;
+		left -= put;
+	}
+	return SUCCESS;
+}
+
+/* Drop zero limbs from the top of x, reading downwards one chunk at a time */
+static int ooc_trim(OocNumber *x, uint32_t *buf)
+{
+	while(x->n > 0)
+	{
+		long long lo = (x->n > OOC_CHUNK) ? x->n - OOC_CHUNK : 0;
+		if(ooc_read(x, lo, x->n - lo, buf) == FAILURE)
+		{
+			return FAILURE;
+		}
+		for(long long i = x->n - 1; i >= lo; i--)
+		{
+			if(buf[i - lo] != 0)
+			{
+				x->n = i + 1;
+				return SUCCESS;
+			}
+		}
+		x->n = lo;
+	}
+	return SUCCESS;
+}
+
+/* ------------------------------------------- text conversion ------------------------------------------- */
+
+static int is_space(char c)
+{
+	return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+/* Parse a decimal file into x */
+static int ooc_parse(const char *path, OocNumber *x)
+{
+	int fd = open(path, O_RDONLY);
+	struct stat st;
+	if(fd < 0 || fstat(fd, &st) < 0)
+	{
+		apc_printf("ERROR : Cannot read operand file %s\n", path);
+		if(fd >= 0)
+			close(fd);
+		return FAILURE;
+	}
+
+	// Trim whitespace at both ends, then take the sign
+	long long start = 0, end = st.st_size;
+	char c;
+	while(start < end && pread(fd, &c, 1, start) == 1 && is_space(c))
+		start++;
+	while(end > start && pread(fd, &c, 1, end - 1) == 1 && is_space(c))
+		end--;
+	char sign = '+';
+	if(start < end && pread(fd, &c, 1, start) == 1 && (c == '+' || c == '-'))
+	{
+		sign = c;
+		start++;
+	}
+	if(start >= end)
+	{
+		apc_printf("ERROR : Operand file %s holds no digits\n", path);
+		close(fd);
+		return FAILURE;
+	}
+
+	char *text = apc_malloc(9LL * OOC_CHUNK);
+	uint32_t *limbs = apc_malloc(OOC_CHUNK * sizeof(uint32_t));
+	int status = FAILURE;
+	if(text == NULL || limbs == NULL || ooc_create(x) == FAILURE)
+	{
+		goto done;
+	}
+	x->sign = sign;
+
+	// Blocks of 9·OOC_CHUNK digits from the end: every block but the first is a whole number of limbs
+	long long pos = end, out = 0, top = -1;
+	while(pos > start)
+	{
+		long long take = (pos - start < 9LL * OOC_CHUNK) ? pos - start : 9LL * OOC_CHUNK;
+		if(pread(fd, text, take, pos - take) != take)
+		{
+			apc_printf("ERROR : Cannot read operand file %s\n", path);
+			goto done;
+		}
+
+		int count = 0;
+		for(long long e = take; e > 0; e -= 9)
+		{
+			uint32_t value = 0;
+			for(long long i = (e > 9) ? e - 9 : 0; i < e; i++)
+			{
+				if(text[i] < '0' || text[i] > '9')
+				{
+					apc_printf("ERROR : Operand file %s holds a non-digit character\n", path);
+					goto done;
+				}
+				value = value * 10 + (text[i] - '0');
+			}
+			if(value != 0)
+				top = out + count;
+			limbs[count++] = value;
+		}
+		if(ooc_write(x, out, count, limbs) == FAILURE)
+		{
+			goto done;
+		}
+		out += count;
+		pos -= take;
+	}
+	x->n = top + 1;
+	status = SUCCESS;
+
+done:
+	if(status == FAILURE)
+		ooc_close(x);
+	apc_free(text);
+	apc_free(limbs);
+	close(fd);
+	return status;
+}
+
+/* Number of decimal digits of x */
+static long long ooc_digits(const OocNumber *x)
+{
+	if(x->n == 0)
+	{
+		return 1;
+	}
+	uint32_t top;
+	if(ooc_read(x, x->n - 1, 1, &top) == FAILURE)
+	{
+		return 0;
+	}
+	long long digits = 9 * (x->n - 1);
+	for(; top > 0; top /= 10)
+	{
+		digits++;
+	}
+	return digits;
+}
+
+/* Write x as decimal text to path, most significant chunk first */
+static int ooc_print(const OocNumber *x, const char *path)
+{
+	FILE *f = fopen(path, "w");
+	uint32_t *limbs = apc_malloc(OOC_CHUNK * sizeof(uint32_t));
+	char *text = apc_malloc(9LL * OOC_CHUNK + 1);
+	int status = SUCCESS;
+
+	if(f == NULL || limbs == NULL || text == NULL)
+	{
+		apc_printf("ERROR : Cannot write result file %s\n", path);
+		status = FAILURE;
+	}
+	else if(x->n == 0)
+	{
+		fputs("0\n", f);
+	}
+	else
+	{
+		if(x->sign == '-')
+			fputc('-', f);
+		for(long long hi = x->n; hi > 0 && status == SUCCESS; )
+		{
+			long long lo = (hi > OOC_CHUNK) ? hi - OOC_CHUNK : 0;
+			status = ooc_read(x, lo, hi - lo, limbs);
+
+			long long len = 0;
+			for(long long i = hi - 1; i >= lo && status == SUCCESS; i--)
+			{
+				if(i == x->n - 1)
+				{
+					len += sprintf(text + len, "%u", limbs[i - lo]);  // top limb without padding
+					continue;
+				}
+				for(int d = 8; d >= 0; d--, limbs[i - lo] /= 10)
+				{
+					text[len + d] = '0' + limbs[i - lo] % 10;
+				}
+				len += 9;
+			}
+			if(status == SUCCESS && fwrite(text, 1, len, f) != (size_t)len)
+			{
+				apc_printf("ERROR : Cannot write result file %s\n", path);
+				status = FAILURE;
+			}
+			hi = lo;
+		}
+		fputc('\n', f);
+	}
+
+	if(f != NULL && fclose(f) != 0 && status == SUCCESS)
+	{
+		apc_printf("ERROR : Cannot write result file %s\n", path);
+		status = FAILURE;
+	}
+	apc_free(limbs);
+	apc_free(text);
+	return status;
+}
+
+/* ------------------------------------------- streamed add / sub / compare ------------------------------------------- */
+
+/* |a| vs |b|: GREATER, EQUAL or LESS (FAILURE on a read error is reported as EQUAL after the message) */
+static int ooc_compare(const OocNumber *a, const OocNumber *b, uint32_t *ba, uint32_t *bb)
+{
+	if(a->n != b->n)
+	{
+		return (a->n > b->n) ? GREATER : LESS;
+	}
+	for(long long hi = a->n; hi > 0; )
+	{
+		long long lo = (hi > OOC_CHUNK) ? hi - OOC_CHUNK : 0;
+		if(ooc_read(a, lo, hi - lo, ba) == FAILURE || ooc_read(b, lo, hi - lo, bb) == FAILURE)
+		{
+			return EQUAL;
+		}
+		for(long long i = hi - lo - 1; i >= 0; i--)
+		{
+			if(ba[i] != bb[i])
+			{
+				return (ba[i] > bb[i]) ? GREATER : LESS;
+			}
+		}
+		hi = lo;
+	}
+	return EQUAL;
+}
+
+/* r = |a| + |b| (subtract == 0) or |a| - |b| with |a| >= |b| (subtract == 1) */
+static int ooc_add(const OocNumber *a, const OocNumber *b, OocNumber *r, int subtract, uint32_t *ba, uint32_t *bb)
+{
+	long long n = ((a->n > b->n) ? a->n : b->n) + 1;
+	uint32_t carry = 0;
+
+	for(long long at = 0; at < n; at += OOC_CHUNK)
+	{
+		long long count = (n - at < OOC_CHUNK) ? n - at : OOC_CHUNK;
+		if(ooc_read(a, at, count, ba) == FAILURE || ooc_read(b, at, count, bb) == FAILURE)
+		{
+			return FAILURE;
+		}
+		for(long long i = 0; i < count; i++)
+		{
+			if(subtract)
+			{
+				int64_t t = (int64_t)ba[i] - bb[i] - carry;
+				carry = (t < 0);
+				ba[i] = t + (carry ? LIMB_BASE : 0);
+			}
+			else
+			{
+				uint32_t t = ba[i] + bb[i] + carry;
+				carry = (t >= LIMB_BASE);
+				ba[i] = t - (carry ? LIMB_BASE : 0);
+			}
+		}
+		if(ooc_write(r, at, count, ba) == FAILURE)
+		{
+			return FAILURE;
+		}
+	}
+	r->n = n;
+	return ooc_trim(r, ba);
+}
+
+/* ------------------------------------------- blocked NTT multiplication ------------------------------------------- */
+
+static uint32_t pow_mod(uint64_t base, uint64_t e, uint32_t p)
+{
+	uint64_t result = 1;
+	for(base %= p; e; e >>= 1, base = base * base % p)
+	{
+		if(e & 1)
+			result = result * base % p;
+	}
+	return result;
+}
+
+/* In-place number-theoretic transform of length 2^log_n modulo p (inverse includes the 1/n scaling) */
+static void ntt(uint32_t *a, int log_n, uint32_t p, int inverse)
+{
+	uint32_t n = 1u << log_n;
+
+	for(uint32_t i = 1, j = 0; i < n; i++)
+	{
+		uint32_t bit = n >> 1;
+		for(; j & bit; bit >>= 1)
+			j ^= bit;
+		j ^= bit;
+		if(i < j)
+		{
+			uint32_t t = a[i]; a[i] = a[j]; a[j] = t;
+		}
+	}
+
+	for(uint32_t len = 2; len <= n; len <<= 1)
+	{
+		uint64_t w = pow_mod(3, (p - 1) / len, p);
+		if(inverse)
+			w = pow_mod(w, p - 2, p);
+		for(uint32_t i = 0; i < n; i += len)
+		{
+			uint64_t wk = 1;
+			for(uint32_t j = 0; j < len / 2; j++, wk = wk * w % p)
+			{
+				uint32_t u = a[i + j], v = a[i + j + len / 2] * wk % p;
+				a[i + j] = (u + v >= p) ? u + v - p : u + v;
+				a[i + j + len / 2] = (u >= v) ? u - v : u + p - v;
+			}
+		}
+	}
+
+	if(inverse)
+	{
+		uint64_t scale = pow_mod(n, p - 2, p);
+		for(uint32_t i = 0; i < n; i++)
+			a[i] = a[i] * scale % p;
+	}
+}
+
+/* Transform every L-limb block of x (as 3L base-1000 digits) under both primes into t: block i, prime q at (2i + q)·N */
+static int transform_blocks(const OocNumber *x, long long blocks, long long L, int log_n, OocNumber *t, uint32_t *limbs, uint32_t *res[2])
+{
+	long long N = 1LL << log_n;
+
+	t->n = 2 * blocks * N;
+	for(long long i = 0; i < blocks; i++)
+	{
+		if(ooc_read(x, i * L, L, limbs) == FAILURE)
+		{
+			return FAILURE;
+		}
+		memset(res[0], 0, N * sizeof(uint32_t));
+		for(long long j = 0; j < L; j++)
+		{
+			res[0][3 * j]     = limbs[j] % 1000;
+			res[0][3 * j + 1] = limbs[j] / 1000 % 1000;
+			res[0][3 * j + 2] = limbs[j] / 1000000;
+		}
+		memcpy(res[1], res[0], N * sizeof(uint32_t));
+		for(int q = 0; q < 2; q++)
+		{
+			ntt(res[q], log_n, ntt_primes[q], 0);
+			if(ooc_write(t, (2 * i + q) * N, N, res[q]) == FAILURE)
+			{
+				return FAILURE;
+			}
+		}
+	}
+	return SUCCESS;
+}
+
+/* r = |a| × |b| with a working set of about `memory` bytes (buf: OOC_CHUNK limbs) */
+static int ooc_mul(const OocNumber *a, const OocNumber *b, OocNumber *r, long long memory, uint32_t *buf)
+{
+	if(a->n == 0 || b->n == 0)
+	{
+		r->n = 0;
+		return SUCCESS;
+	}
+
+	// Working set: 6 residue arrays (4N bytes each) and one coefficient array (8N bytes)
+	int log_n = 4;
+	while(log_n < NTT_MAX_LOG && (40LL << (log_n + 1)) <= memory)
+	{
+		log_n++;
+	}
+	// A block product has 6L base-1000 digits; the sum over up to 10^18 products needs 6 more
+	long long N = 1LL << log_n, L = (N - 6) / 6;
+	long long blocks_a = (a->n + L - 1) / L, blocks_b = (b->n + L - 1) / L;
+
+	OocNumber ta = { -1, 0, '+' }, tb = { -1, 0, '+' };
+	uint32_t *x[2] = { NULL, NULL }, *y[2] = { NULL, NULL }, *acc[2] = { NULL, NULL };
+	uint64_t *coef = apc_malloc(N * sizeof(uint64_t));
+	uint32_t *window = apc_calloc(2 * L + 2, sizeof(uint32_t));
+	int status = FAILURE;
+
+	for(int q = 0; q < 2; q++)
+	{
+		x[q] = apc_malloc(N * sizeof(uint32_t));
+		y[q] = apc_malloc(N * sizeof(uint32_t));
+		acc[q] = apc_malloc(N * sizeof(uint32_t));
+		if(x[q] == NULL || y[q] == NULL || acc[q] == NULL)
+			goto done;
+	}
+	if(coef == NULL || window == NULL || ooc_create(&ta) == FAILURE || ooc_create(&tb) == FAILURE ||
+	   transform_blocks(a, blocks_a, L, log_n, &ta, window, x) == FAILURE ||
+	   transform_blocks(b, blocks_b, L, log_n, &tb, window, x) == FAILURE)
+	{
+		goto done;
+	}
+	memset(window, 0, (2 * L + 2) * sizeof(uint32_t));
+
+	// CRT: c = r0 + p0·((r1 - r0)·p0^-1 mod p1)
+	uint64_t p0 = ntt_primes[0], p1 = ntt_primes[1];
+	uint64_t p0_inv = pow_mod(p0 % p1, p1 - 2, p1);
+
+	for(long long k = 0; k < blocks_a + blocks_b - 1; k++)
+	{
+		// Σ A_i·B_(k-i), summed in the transform domain
+		memset(acc[0], 0, N * sizeof(uint32_t));
+		memset(acc[1], 0, N * sizeof(uint32_t));
+		for(long long i = (k >= blocks_b) ? k - blocks_b + 1 : 0; i <= k && i < blocks_a; i++)
+		{
+			for(int q = 0; q < 2; q++)
+			{
+				uint32_t p = ntt_primes[q];
+				if(ooc_read(&ta, (2 * i + q) * N, N, x[q]) == FAILURE ||
+				   ooc_read(&tb, (2 * (k - i) + q) * N, N, y[q]) == FAILURE)
+				{
+					goto done;
+				}
+				for(long long t = 0; t < N; t++)
+				{
+					acc[q][t] = (acc[q][t] + (uint64_t)x[q][t] * y[q][t]) % p;
+				}
+			}
+		}
+		ntt(acc[0], log_n, ntt_primes[0], 1);
+		ntt(acc[1], log_n, ntt_primes[1], 1);
+
+		// Exact coefficients, then base-1000 digits
+		uint64_t carry = 0;
+		for(long long t = 0; t < N; t++)
+		{
+			uint64_t h = (acc[1][t] + p1 - acc[0][t] % p1) % p1 * p0_inv % p1;
+			uint64_t v = acc[0][t] + p0 * h + carry;
+			coef[t] = v % 1000;
+			carry = v / 1000;
+		}
+
+		// Add the 2L + 2 limbs of this output block into the window over limbs [kL, kL + 2L + 2)
+		uint32_t c = 0;
+		for(long long j = 0; j < 2 * L + 2; j++)
+		{
+			uint32_t limb = coef[3 * j] + 1000 * coef[3 * j + 1] + 1000000 * coef[3 * j + 2];
+			uint32_t t = window[j] + limb + c;
+			c = (t >= LIMB_BASE);
+			window[j] = t - (c ? LIMB_BASE : 0);
+		}
+
+		// Later blocks start at (k + 1)L: the lowest L limbs are final
+		if(ooc_write(r, k * L, L, window) == FAILURE)
+		{
+			goto done;
+		}
+		memmove(window, window + L, (L + 2) * sizeof(uint32_t));
+		memset(window + L + 2, 0, L * sizeof(uint32_t));
+	}
+	if(ooc_write(r, (blocks_a + blocks_b - 1) * L, L + 2, window) == FAILURE)
+	{
+		goto done;
+	}
+	r->n = a->n + b->n;
+	status = ooc_trim(r, buf);
+
+done:
+	for(int q = 0; q < 2; q++)
+	{
+		apc_free(x[q]);
+		apc_free(y[q]);
+		apc_free(acc[q]);
+	}
+	apc_free(coef);
+	apc_free(window);
+	ooc_close(&ta);
+	ooc_close(&tb);
+	return status;
+}
+
+/*****************************************************************************************
+ * Function: out_of_core_operation
+ * -------------------------------
+ * Performs <file1> op <file2> for op in + - * cmp, writes the result to path_r (if given)
+ * and prints a summary. memory_mb bounds the multiplication working set (lowered to what
+ * the memory caps still allow, see memory.c).
+ *****************************************************************************************/
+
+int out_of_core_operation(const char *op, const char *path1, const char *path2, const char *path_r, long long memory_mb)
+{
+	int mul = (strcmp(op, "*") == 0), cmp = (strcmp(op, "cmp") == 0);
+	if(!mul && !cmp && strcmp(op, "+") != 0 && strcmp(op, "-") != 0)
+	{
+		apc_printf("ERROR : Out-of-core mode supports only +, -, * and cmp\n");
+		return FAILURE;
+	}
+	if(!cmp && path_r == NULL)
+	{
+		apc_printf("ERROR : Out-of-core %s needs a result file\n", op);
+		return FAILURE;
+	}
+	if(memory_mb < 1)
+	{
+		apc_printf("ERROR : Memory budget must be at least 1 MB\n");
+		return FAILURE;
+	}
+
+	OocNumber a = { -1, 0, '+' }, b = { -1, 0, '+' }, r = { -1, 0, '+' };
+	uint32_t *ba = apc_malloc(OOC_CHUNK * sizeof(uint32_t)), *bb = apc_malloc(OOC_CHUNK * sizeof(uint32_t));
+	int status = FAILURE;
+
+	if(ba == NULL || bb == NULL || ooc_parse(path1, &a) == FAILURE || ooc_parse(path2, &b) == FAILURE)
+	{
+		goto done;
+	}
+	apc_printf("Operand 1       : %s (%c, %lld digits)\n", path1, a.sign, ooc_digits(&a));
+	apc_printf("Operation       : %s\n", op);
+	apc_printf("Operand 2       : %s (%c, %lld digits)\n", path2, b.sign, ooc_digits(&b));
+	apc_printf("----------------------------------------\n");
+
+	// Zero has no sign
+	if(a.n == 0)
+		a.sign = '+';
+	if(b.n == 0)
+		b.sign = '+';
+	int compare = ooc_compare(&a, &b, ba, bb);
+
+	if(cmp)
+	{
+		int result;
+		if(a.sign != b.sign)
+			result = (a.sign == '+') ? GREATER : LESS;
+		else
+			result = (a.sign == '+') ? compare : -compare;
+		apc_printf("Result          : %d\n", result);
+		status = SUCCESS;
+		goto done;
+	}
+
+	if(ooc_create(&r) == FAILURE)
+	{
+		goto done;
+	}
+	if(mul)
+	{
+		// The working set also has to fit under the process / operation memory caps
+		long long budget = memory_mb << 20;
+		if(memory_available() < (size_t)budget)
+			budget = memory_available();
+		status = ooc_mul(&a, &b, &r, budget, ba);
+		r.sign = (a.sign == b.sign) ? '+' : '-';
+	}
+	else
+	{
+		// a - b = a + (-b): equal signs add magnitudes, otherwise the larger magnitude keeps its sign
+		char sign2 = (strcmp(op, "-") == 0) ? ((b.sign == '+') ? '-' : '+') : b.sign;
+		if(a.sign == sign2)
+		{
+			status = ooc_add(&a, &b, &r, 0, ba, bb);
+			r.sign = a.sign;
+		}
+		else if(compare != LESS)
+		{
+			status = ooc_add(&a, &b, &r, 1, ba, bb);
+			r.sign = a.sign;
+		}
+		else
+		{
+			status = ooc_add(&b, &a, &r, 1, ba, bb);
+			r.sign = sign2;
+		}
+	}
+
+	if(status == SUCCESS)
+	{
+		status = ooc_print(&r, path_r);
+	}
+	if(status == SUCCESS)
+	{
+		apc_printf("Result          : %s (%c, %lld digits)\n", path_r, (r.n == 0) ? '+' : r.sign, ooc_digits(&r));
+	}
+
+done:
+	ooc_close(&a);
+	ooc_close(&b);
+	ooc_close(&r);
+	apc_free(ba);
+	apc_free(bb);
+	return status;
+}
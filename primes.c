@@ -0,0 +1,1256 @@
+/*******************************************************************************************************************************************************************
+ * Function: ISPRIME / NEXTPRIME / FACTOR
+ * --------------------------------------
+ *  Primality testing, next prime and integer factorization.
+ *
+ *  Example:
+ *     isprime(1000003)         = prime
+ *     nextprime(1000000)       = 1000003
+ *     factor(600851475143)     = 71 * 839 * 1471 * 6857
+ *
+ *  All arithmetic runs on base-10^9 limbs (limbs.c). Modular products are one limb multiplication and one
+ *  long division by the modulus; numbers below 10^18 take a machine-word path with 128-bit products instead.
+ *
+ *  isprime   : trial division by the primes below 1000, then Baillie-PSW: a strong Miller-Rabin test to base 2
+ *              and a strong Lucas test with Selfridge's parameters (D = 5, -7, 9, ... with Jacobi(D/n) = -1,
+ *              P = 1, Q = (1 - D)/4). `--rounds N` adds N Miller-Rabin rounds with random bases. Below 10^18
+ *              Miller-Rabin with the first twelve prime bases is deterministic.
+ *  nextprime : odd candidates above n are sieved by keeping their residues modulo the small primes (one
+ *              addition per prime and step), and only survivors are tested with isprime.
+ *  factor    : trial division by the primes below SIEVE_LIMIT, then each cofactor is split until it is prime:
+ *              Pollard's rho (Brent's cycle finding, RHO_BATCH differences multiplied per gcd), then the
+ *              elliptic curve method (Montgomery curves with Suyama's parametrisation, stage 1 with the
+ *              Montgomery ladder up to B1, baby-step giant-step stage 2 up to 100·B1). A cofactor that
+ *              survives the whole ECM schedule is reported as composite.
+ *
+ *  Returns:
+ *     SUCCESS (0) if the result is computed
+ *     FAILURE (-1) if the input list is empty or memory allocation fails
+*******************************************************************************************************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include "apc.h"
+
+/* Trial division bound of factor(); cofactors below its square are prime */
+#define SIEVE_LIMIT    65536
+
+/* Primes below this bound are used for the quick checks of isprime and nextprime */
+#define SMALL_PRIME_BOUND 1000
+
+/* Pollard rho: iterations per attempt, differences multiplied before each gcd */
+#define RHO_ITERATIONS 100000
+#define RHO_BATCH      64
+
+/* ECM stage 2 giant step 2·ECM_D, baby steps are the j < ECM_D coprime to ECM_D */
+#define ECM_D          210
+
+/* Extra Miller-Rabin rounds with random bases (--rounds N) */
+int apc_prime_rounds = 0;
+
+/* ECM schedule: stage 1 bound and number of curves per level */
+static const struct
+{
+	uint64_t b1;
+	int curves;
+}ecm_schedule[] =
+{
+	{ 2000,  25 },
+	{ 11000, 90 },
+	{ 50000, 30 },
+};
+
+static uint32_t *primes;
+static int prime_count;
+
+static pthread_mutex_t sieve_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/* Sieve of Eratosthenes up to SIEVE_LIMIT, built on first use (once, also with --serve workers) */
+static int sieve_init(void)
+{
+	if(__atomic_load_n(&primes, __ATOMIC_ACQUIRE) != NULL)
+	{
+		return SUCCESS;
+	}
+
+	pthread_mutex_lock(&sieve_lock);
+	if(primes != NULL)
+	{
+		pthread_mutex_unlock(&sieve_lock);
+		return SUCCESS;
+	}
+	unsigned char *composite = apc_calloc(SIEVE_LIMIT, 1);
+	uint32_t *table = apc_malloc(SIEVE_LIMIT / 2 * sizeof(uint32_t));
+	if(composite == NULL || table == NULL)
+	{
+		apc_free(composite);
+		apc_free(table);
+		pthread_mutex_unlock(&sieve_lock);
+		return FAILURE;
+	}
+
+	for(uint32_t i = 2; i < SIEVE_LIMIT; i++)
+	{
+		if(composite[i])
+		{
+			continue;
+		}
+		table[prime_count++] = i;
+		for(uint32_t j = i * i; j < SIEVE_LIMIT; j += i)
+		{
+			composite[j] = 1;
+		}
+	}
+	apc_free(composite);
+	__atomic_store_n(&primes, table, __ATOMIC_RELEASE);
+	pthread_mutex_unlock(&sieve_lock);
+	return SUCCESS;
+}
+
+/* ------------------------------ machine-word path (< 10^18) ------------------------------ */
+
+static uint64_t mulmod64(uint64_t a, uint64_t b, uint64_t n)
+{
+	return (unsigned __int128)a * b % n;
+}
+
+static uint64_t powmod64(uint64_t base, uint64_t e, uint64_t n)
+{
+	uint64_t result = 1 % n;
+	base %= n;
+	for(; e; e >>= 1)
+	{
+		if(e & 1)
+		{
+			result = mulmod64(result, base, n);
+		}
+		base = mulmod64(base, base, n);
+	}
+	return result;
+}
+
+/* Deterministic Miller-Rabin: the first twelve primes as bases are exact below 3.3·10^24 */
+static int is_prime64(uint64_t n)
+{
+	static const uint64_t bases[] = { 2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37 };
+
+	if(n < 2)
+	{
+		return 0;
+	}
+	for(int i = 0; i < 12; i++)
+	{
+		if(n % bases[i] == 0)
+		{
+			return n == bases[i];
+		}
+	}
+
+	uint64_t d = n - 1;
+	int s = 0;
+	while((d & 1) == 0)
+	{
+		d >>= 1;
+		s++;
+	}
+
+	for(int i = 0; i < 12; i++)
+	{
+		uint64_t x = powmod64(bases[i], d, n);
+		if(x == 1 || x == n - 1)
+		{
+			continue;
+		}
+		int witness = 1;
+		for(int r = 1; r < s && witness; r++)
+		{
+			x = mulmod64(x, x, n);
+			witness = (x != n - 1);
+		}
+		if(witness)
+		{
+			return 0;
+		}
+	}
+	return 1;
+}
+
+static uint64_t gcd64(uint64_t a, uint64_t b)
+{
+	while(b)
+	{
+		uint64_t t = a % b;
+		a = b;
+		b = t;
+	}
+	return a;
+}
+
+/* Brent's rho on a machine word: a non-trivial factor of composite n, or 0 */
+static uint64_t rho64(uint64_t n)
+{
+	if(n % 2 == 0)
+	{
+		return 2;
+	}
+
+	for(uint64_t c = 1; c < 64; c++)
+	{
+		uint64_t y = 2, x = 2, ys = 2, q = 1, g = 1;
+		for(uint64_t r = 1; g == 1 && r < (1ULL << 32); r <<= 1)
+		{
+			x = y;
+			for(uint64_t i = 0; i < r; i++)
+			{
+				y = (mulmod64(y, y, n) + c) % n;
+			}
+			for(uint64_t k = 0; k < r && g == 1; k += RHO_BATCH)
+			{
+				ys = y;
+				for(uint64_t i = 0; i < RHO_BATCH && i < r - k; i++)
+				{
+					y = (mulmod64(y, y, n) + c) % n;
+					q = mulmod64(q, (x > y) ? x - y : y - x, n);
+				}
+				g = gcd64(q, n);
+			}
+		}
+
+		// The batch overshot: replay it one difference at a time
+		if(g == n)
+		{
+			do
+			{
+				ys = (mulmod64(ys, ys, n) + c) % n;
+				g = gcd64((x > ys) ? x - ys : ys - x, n);
+			}while(g == 1);
+		}
+		if(g != n)
+		{
+			return g;
+		}
+	}
+	return 0;
+}
+
+/* ---------------------------------- modular limb arithmetic ---------------------------------- */
+
+/* r = a · b mod n */
+static int mod_mul(const Limbs *a, const Limbs *b, const Limbs *n, Limbs *r)
+{
+	if(limbs_mul(a, b, r) == FAILURE)
+	{
+		return FAILURE;
+	}
+	return limbs_divmod(r, n, NULL, r);
+}
+
+/* r = a + b mod n (a, b < n) */
+static int mod_add(const Limbs *a, const Limbs *b, const Limbs *n, Limbs *r)
+{
+	if(limbs_add(a, b, r) == FAILURE)
+	{
+		return FAILURE;
+	}
+	return (limbs_cmp(r, n) == LESS) ? SUCCESS : limbs_sub(r, n, r);
+}
+
+/* r = a - b mod n (a, b < n) */
+static int mod_sub(const Limbs *a, const Limbs *b, const Limbs *n, Limbs *r)
+{
+	if(limbs_cmp(a, b) != LESS)
+	{
+		return limbs_sub(a, b, r);
+	}
+	Limbs t = { NULL, 0 };
+	int status = (limbs_add(a, n, &t) == SUCCESS) ? limbs_sub(&t, b, r) : FAILURE;
+	limbs_free(&t);
+	return status;
+}
+
+/* A small signed integer modulo n */
+static int mod_small(long long value, const Limbs *n, Limbs *r)
+{
+	Limbs t = { NULL, 0 };
+	if(limbs_set_u64(&t, (value < 0) ? -value : value) == FAILURE || limbs_divmod(&t, n, NULL, &t) == FAILURE)
+	{
+		limbs_free(&t);
+		return FAILURE;
+	}
+	int status = SUCCESS;
+	if(value < 0 && t.n > 0)
+	{
+		status = limbs_sub(n, &t, r);
+	}
+	else
+	{
+		status = limbs_copy(&t, r);
+	}
+	limbs_free(&t);
+	return status;
+}
+
+/* r = x / 2 mod odd n */
+static int mod_half(const Limbs *x, const Limbs *n, Limbs *r)
+{
+	if(x->n > 0 && (x->d[0] & 1))
+	{
+		if(limbs_add(x, n, r) == FAILURE)
+			return FAILURE;
+		x = r;
+	}
+	limbs_divmod_small(x, 2, r);
+	return SUCCESS;
+}
+
+/* Binary digits of e, least significant first (caller frees); returns the count, FAILURE on error */
+static int limbs_bits(const Limbs *e, unsigned char **bits)
+{
+	Limbs t = { NULL, 0 };
+	*bits = apc_malloc(e->n * 30 + 30);
+	if(*bits == NULL || limbs_copy(e, &t) == FAILURE)
+	{
+		apc_free(*bits);
+		return FAILURE;
+	}
+
+	// Peel 30 bits per pass
+	int count = 0;
+	while(t.n > 0)
+	{
+		uint32_t chunk = limbs_divmod_small(&t, 1u << 30, &t);
+		for(int i = 0; i < 30; i++)
+		{
+			(*bits)[count++] = (chunk >> i) & 1;
+		}
+	}
+	while(count > 0 && (*bits)[count - 1] == 0)
+	{
+		count--;
+	}
+	limbs_free(&t);
+	return count;
+}
+
+/* r = base^e mod n, square-and-multiply from the top bit (any n >= 2; fixed_powmod is faster for odd n up to 4096 bits) */
+int limbs_powmod(const Limbs *base, const Limbs *e, const Limbs *n, Limbs *r)
+{
+	unsigned char *bits;
+	int count = limbs_bits(e, &bits);
+	if(count == FAILURE)
+	{
+		return FAILURE;
+	}
+
+	Limbs x = { NULL, 0 };
+	int status = limbs_set_small(&x, 1);
+	for(int i = count - 1; i >= 0 && status == SUCCESS; i--)
+	{
+		status = mod_mul(&x, &x, n, &x);
+		if(status == SUCCESS && bits[i])
+		{
+			status = mod_mul(&x, base, n, &x);
+		}
+	}
+	apc_free(bits);
+
+	if(status == SUCCESS)
+	{
+		limbs_free(r);
+		*r = x;
+	}
+	else
+	{
+		limbs_free(&x);
+	}
+	return status;
+}
+
+/* ------------------------------------- primality tests ------------------------------------- */
+
+/* Strong probable-prime test of odd n > 3 to base a; n1 = n - 1 = d·2^s. Returns 1, 0 or FAILURE. */
+static int miller_rabin(const Limbs *n, const Limbs *n1, const Limbs *d, int s, const Limbs *a)
+{
+	// n is odd: Montgomery in a fixed width when it fits (fixed.c)
+	Limbs x = { NULL, 0 };
+	int status = fixed_bits(n) ? fixed_powmod(a, d, n, &x) : limbs_powmod(a, d, n, &x);
+	if(status == FAILURE)
+	{
+		return FAILURE;
+	}
+
+	int result = 0;
+	if((x.n == 1 && x.d[0] == 1) || limbs_cmp(&x, n1) == EQUAL)
+	{
+		result = 1;
+	}
+	for(int r = 1; r < s && !result; r++)
+	{
+		if(mod_mul(&x, &x, n, &x) == FAILURE)
+		{
+			result = FAILURE;
+			break;
+		}
+		if(limbs_cmp(&x, n1) == EQUAL)
+		{
+			result = 1;
+		}
+	}
+	limbs_free(&x);
+	return result;
+}
+
+/* Jacobi symbol (a / m) for odd m > 0 */
+static int jacobi_small(long long a, long long m)
+{
+	int result = 1;
+	a %= m;
+	if(a < 0)
+	{
+		a += m;
+	}
+	while(a != 0)
+	{
+		while(a % 2 == 0)
+		{
+			a /= 2;
+			if(m % 8 == 3 || m % 8 == 5)
+			{
+				result = -result;
+			}
+		}
+		long long t = a; a = m; m = t;
+		if(a % 4 == 3 && m % 4 == 3)
+		{
+			result = -result;
+		}
+		a %= m;
+	}
+	return (m == 1) ? result : 0;
+}
+
+/* Jacobi symbol (D / n) for small odd D and large odd n, by quadratic reciprocity */
+static int jacobi_big(long long D, const Limbs *n)
+{
+	long long a = (D < 0) ? -D : D;
+	int n_mod4 = n->d[0] % 4;                               // 10^9 is divisible by 4
+	int result = jacobi_small(limbs_divmod_small(n, a, NULL), a);
+
+	if(a % 4 == 3 && n_mod4 == 3)
+	{
+		result = -result;
+	}
+	if(D < 0 && n_mod4 == 3)
+	{
+		result = -result;                                   // (-1 / n)
+	}
+	return result;
+}
+
+static int is_perfect_square(const Limbs *n)
+{
+	Dlist *head = NULL, *tail = NULL, *root = NULL, *root_tail = NULL;
+	Limbs r = { NULL, 0 }, sq = { NULL, 0 };
+	int result = 0;
+
+	if(limbs_to_list(n, &head, &tail) == SUCCESS && isqrt(&head, &tail, &root) == SUCCESS &&
+	   limbs_from_list(root, &r) == SUCCESS && limbs_mul(&r, &r, &sq) == SUCCESS)
+	{
+		result = (limbs_cmp(&sq, n) == EQUAL);
+	}
+	root_tail = list_tail(root);
+	delete_list(&head, &tail);
+	delete_list(&root, &root_tail);
+	limbs_free(&r);
+	limbs_free(&sq);
+	return result;
+}
+
+/*****************************************************************************************
+ * Function: strong_lucas
+ * ----------------------
+ * Strong Lucas probable-prime test with Selfridge's parameters. With n + 1 = d·2^s,
+ * U_d and V_d are computed from the top bit of d with the doubling formulas
+ *     U_2k = U_k·V_k,  V_2k = V_k^2 - 2Q^k
+ * and, for a set bit (P = 1),
+ *     U_k+1 = (U_k + V_k) / 2,  V_k+1 = (D·U_k + V_k) / 2.
+ * n passes if U_d = 0 or V_(d·2^r) = 0 for some 0 <= r < s. Returns 1, 0 or FAILURE.
+ *****************************************************************************************/
+
+static int strong_lucas(const Limbs *n)
+{
+	// Selfridge: first D in 5, -7, 9, -11, ... with (D / n) = -1
+	long long D = 5;
+	for(int tries = 0; ; tries++)
+	{
+		int j = jacobi_big(D, n);
+		if(j == -1)
+		{
+			break;
+		}
+		if(j == 0 && limbs_divmod_small(n, (D < 0) ? -D : D, NULL) == 0)
+		{
+			return 0;                                       // |D| divides n (n is larger than |D|)
+		}
+		if(tries == 10 && is_perfect_square(n))
+		{
+			return 0;                                       // no such D exists for squares
+		}
+		D = (D > 0) ? -(D + 2) : -(D - 2);
+	}
+	long long Q = (1 - D) / 4;
+
+	Limbs one = { NULL, 0 }, d = { NULL, 0 }, Dm = { NULL, 0 }, Qm = { NULL, 0 };
+	Limbs U = { NULL, 0 }, V = { NULL, 0 }, Qk = { NULL, 0 }, t = { NULL, 0 }, t2 = { NULL, 0 };
+	unsigned char *bits = NULL;
+	int result = FAILURE, s = 0, count;
+
+	if(limbs_set_small(&one, 1) == FAILURE || limbs_add(n, &one, &d) == FAILURE ||
+	   mod_small(D, n, &Dm) == FAILURE || mod_small(Q, n, &Qm) == FAILURE)
+	{
+		goto done;
+	}
+	while(d.n > 0 && (d.d[0] & 1) == 0)
+	{
+		limbs_divmod_small(&d, 2, &d);
+		s++;
+	}
+	if((count = limbs_bits(&d, &bits)) == FAILURE ||
+	   limbs_set_small(&U, 1) == FAILURE || limbs_set_small(&V, 1) == FAILURE || limbs_copy(&Qm, &Qk) == FAILURE)
+	{
+		goto done;
+	}
+
+	for(int i = count - 2; i >= 0; i--)
+	{
+		// k → 2k
+		if(mod_mul(&U, &V, n, &U) == FAILURE || mod_mul(&V, &V, n, &V) == FAILURE ||
+		   mod_add(&Qk, &Qk, n, &t) == FAILURE || mod_sub(&V, &t, n, &V) == FAILURE ||
+		   mod_mul(&Qk, &Qk, n, &Qk) == FAILURE)
+		{
+			goto done;
+		}
+		// 2k → 2k + 1
+		if(bits[i])
+		{
+			if(mod_add(&U, &V, n, &t) == FAILURE || mod_mul(&Dm, &U, n, &t2) == FAILURE ||
+			   mod_add(&t2, &V, n, &t2) == FAILURE || mod_half(&t, n, &U) == FAILURE ||
+			   mod_half(&t2, n, &V) == FAILURE || mod_mul(&Qk, &Qm, n, &Qk) == FAILURE)
+			{
+				goto done;
+			}
+		}
+	}
+
+	result = (U.n == 0);
+	for(int r = 0; r < s && !result; r++)
+	{
+		if(V.n == 0)
+		{
+			result = 1;
+			break;
+		}
+		if(mod_mul(&V, &V, n, &V) == FAILURE || mod_add(&Qk, &Qk, n, &t) == FAILURE ||
+		   mod_sub(&V, &t, n, &V) == FAILURE || mod_mul(&Qk, &Qk, n, &Qk) == FAILURE)
+		{
+			result = FAILURE;
+			break;
+		}
+	}
+
+done:
+	apc_free(bits);
+	limbs_free(&one);
+	limbs_free(&d);
+	limbs_free(&Dm);
+	limbs_free(&Qm);
+	limbs_free(&U);
+	limbs_free(&V);
+	limbs_free(&Qk);
+	limbs_free(&t);
+	limbs_free(&t2);
+	return result;
+}
+
+/* Random a in [2, n - 2] for n > 4 */
+static int random_base(const Limbs *n, Limbs *a)
+{
+	Limbs range = { NULL, 0 }, three = { NULL, 0 }, two = { NULL, 0 };
+	int status = FAILURE;
+	uint32_t *d = apc_calloc(n->n, sizeof(uint32_t));
+
+	if(d != NULL && limbs_set_small(&three, 3) == SUCCESS && limbs_set_small(&two, 2) == SUCCESS &&
+	   limbs_sub(n, &three, &range) == SUCCESS)
+	{
+		for(int i = 0; i < n->n; i++)
+		{
+			d[i] = ((uint32_t)rand() * 65536u + rand()) % LIMB_BASE;
+		}
+		limbs_free(a);
+		a->d = d;
+		a->n = n->n;
+		limbs_trim(a);
+		d = NULL;
+		if(limbs_divmod(a, &range, NULL, a) == SUCCESS && limbs_add(a, &two, a) == SUCCESS)
+		{
+			status = SUCCESS;
+		}
+	}
+	apc_free(d);
+	limbs_free(&range);
+	limbs_free(&three);
+	limbs_free(&two);
+	return status;
+}
+
+/*****************************************************************************************
+ * Function: primality
+ * -------------------
+ * 2 if n is certainly prime, 1 if it is a probable prime (passed Baillie-PSW and the
+ * extra Miller-Rabin rounds), 0 if composite (or below 2), FAILURE on allocation failure.
+ *****************************************************************************************/
+
+static int primality(const Limbs *n)
+{
+	if(n->n <= 2)
+	{
+		return is_prime64(limbs_to_u64(n)) ? 2 : 0;
+	}
+	if(sieve_init() == FAILURE)
+	{
+		return FAILURE;
+	}
+	for(int i = 0; i < prime_count && primes[i] < SMALL_PRIME_BOUND; i++)
+	{
+		if(limbs_divmod_small(n, primes[i], NULL) == 0)
+		{
+			return 0;
+		}
+	}
+
+	// n - 1 = d·2^s
+	Limbs one = { NULL, 0 }, two = { NULL, 0 }, n1 = { NULL, 0 }, d = { NULL, 0 }, a = { NULL, 0 };
+	int result = FAILURE, s = 0;
+	if(limbs_set_small(&one, 1) == SUCCESS && limbs_set_small(&two, 2) == SUCCESS &&
+	   limbs_sub(n, &one, &n1) == SUCCESS && limbs_copy(&n1, &d) == SUCCESS)
+	{
+		while((d.d[0] & 1) == 0)
+		{
+			limbs_divmod_small(&d, 2, &d);
+			s++;
+		}
+
+		result = miller_rabin(n, &n1, &d, s, &two);
+		if(result == 1)
+		{
+			result = strong_lucas(n);
+		}
+		for(int i = 0; i < apc_prime_rounds && result == 1; i++)
+		{
+			result = (random_base(n, &a) == SUCCESS) ? miller_rabin(n, &n1, &d, s, &a) : FAILURE;
+		}
+	}
+	limbs_free(&one);
+	limbs_free(&two);
+	limbs_free(&n1);
+	limbs_free(&d);
+	limbs_free(&a);
+	return result;
+}
+
+/* ---------------------------------------- factoring ---------------------------------------- */
+
+/* Brent's rho on limbs: a non-trivial factor of composite n in f, returns 1 if found, 0 if not */
+static int rho_limbs(const Limbs *n, Limbs *f)
+{
+	Limbs x = { NULL, 0 }, y = { NULL, 0 }, ys = { NULL, 0 }, q = { NULL, 0 }, c = { NULL, 0 }, diff = { NULL, 0 };
+	int found = 0;
+
+	for(uint32_t constant = 1; constant <= 2 && !found; constant++)
+	{
+		long iterations = 0;
+		int error = (limbs_set_small(&y, 2) == FAILURE || limbs_set_small(&q, 1) == FAILURE ||
+		             limbs_set_small(&c, constant) == FAILURE || limbs_set_small(f, 1) == FAILURE);
+
+		for(long r = 1; !error && f->n == 1 && f->d[0] == 1 && iterations < RHO_ITERATIONS; r <<= 1)
+		{
+			error = (limbs_copy(&y, &x) == FAILURE);
+			for(long i = 0; i < r && !error; i++, iterations++)
+			{
+				error = (mod_mul(&y, &y, n, &y) == FAILURE || mod_add(&y, &c, n, &y) == FAILURE);
+			}
+			for(long k = 0; k < r && !error && f->n == 1 && f->d[0] == 1; k += RHO_BATCH)
+			{
+				error = (limbs_copy(&y, &ys) == FAILURE);
+				for(long i = 0; i < RHO_BATCH && i < r - k && !error; i++, iterations++)
+				{
+					error = (mod_mul(&y, &y, n, &y) == FAILURE || mod_add(&y, &c, n, &y) == FAILURE ||
+					         mod_sub(&x, &y, n, &diff) == FAILURE || mod_mul(&q, &diff, n, &q) == FAILURE);
+				}
+				error = error || (limbs_gcd(&q, n, f) == FAILURE);
+			}
+		}
+
+		// The batch overshot to n: replay it one difference at a time
+		if(!error && limbs_cmp(f, n) == EQUAL)
+		{
+			do
+			{
+				error = (mod_mul(&ys, &ys, n, &ys) == FAILURE || mod_add(&ys, &c, n, &ys) == FAILURE ||
+				         mod_sub(&x, &ys, n, &diff) == FAILURE || limbs_gcd(&diff, n, f) == FAILURE);
+			}while(!error && f->n == 1 && f->d[0] == 1);
+		}
+		found = !error && !(f->n == 1 && f->d[0] == 1) && limbs_cmp(f, n) != EQUAL;
+	}
+
+	limbs_free(&x);
+	limbs_free(&y);
+	limbs_free(&ys);
+	limbs_free(&q);
+	limbs_free(&c);
+	limbs_free(&diff);
+	return found;
+}
+
+/* Point (X : Z) on a Montgomery curve, and the curve constant (A + 2) / 4 = an / ad */
+typedef struct
+{
+	Limbs x, z;
+}Point;
+
+typedef struct
+{
+	const Limbs *n;
+	Limbs an, ad;
+}Curve;
+
+static void point_free(Point *p)
+{
+	limbs_free(&p->x);
+	limbs_free(&p->z);
+}
+
+static int point_copy(const Point *src, Point *dst)
+{
+	return (limbs_copy(&src->x, &dst->x) == SUCCESS && limbs_copy(&src->z, &dst->z) == SUCCESS) ? SUCCESS : FAILURE;
+}
+
+/* r = 2p:  X = ad·(X+Z)^2·(X-Z)^2,  Z = 4XZ·(ad·(X-Z)^2 + an·4XZ) */
+static int point_double(const Curve *E, const Point *p, Point *r)
+{
+	Limbs s = { NULL, 0 }, d = { NULL, 0 }, t = { NULL, 0 }, e = { NULL, 0 };
+	const Limbs *n = E->n;
+	int status = FAILURE;
+
+	if(mod_add(&p->x, &p->z, n, &s) == SUCCESS && mod_sub(&p->x, &p->z, n, &d) == SUCCESS &&
+	   mod_mul(&s, &s, n, &s) == SUCCESS && mod_mul(&d, &d, n, &d) == SUCCESS &&
+	   mod_sub(&s, &d, n, &t) == SUCCESS && mod_mul(&E->ad, &d, n, &e) == SUCCESS &&
+	   mod_mul(&s, &e, n, &r->x) == SUCCESS && mod_mul(&E->an, &t, n, &d) == SUCCESS &&
+	   mod_add(&e, &d, n, &e) == SUCCESS && mod_mul(&t, &e, n, &r->z) == SUCCESS)
+	{
+		status = SUCCESS;
+	}
+	limbs_free(&s);
+	limbs_free(&d);
+	limbs_free(&t);
+	limbs_free(&e);
+	return status;
+}
+
+/* r = p + q given diff = p - q:  X = Zd·(u + v)^2,  Z = Xd·(u - v)^2 */
+static int point_add(const Curve *E, const Point *p, const Point *q, const Point *diff, Point *r)
+{
+	Limbs a = { NULL, 0 }, b = { NULL, 0 }, u = { NULL, 0 }, v = { NULL, 0 };
+	const Limbs *n = E->n;
+	int status = FAILURE;
+
+	if(mod_sub(&p->x, &p->z, n, &a) == SUCCESS && mod_add(&q->x, &q->z, n, &b) == SUCCESS &&
+	   mod_mul(&a, &b, n, &u) == SUCCESS && mod_add(&p->x, &p->z, n, &a) == SUCCESS &&
+	   mod_sub(&q->x, &q->z, n, &b) == SUCCESS && mod_mul(&a, &b, n, &v) == SUCCESS &&
+	   mod_add(&u, &v, n, &a) == SUCCESS && mod_sub(&u, &v, n, &b) == SUCCESS &&
+	   mod_mul(&a, &a, n, &a) == SUCCESS && mod_mul(&b, &b, n, &b) == SUCCESS)
+	{
+		// diff may alias r
+		Limbs x = { NULL, 0 }, z = { NULL, 0 };
+		if(mod_mul(&diff->z, &a, n, &x) == SUCCESS && mod_mul(&diff->x, &b, n, &z) == SUCCESS)
+		{
+			limbs_free(&r->x);
+			limbs_free(&r->z);
+			r->x = x;
+			r->z = z;
+			status = SUCCESS;
+		}
+		else
+		{
+			limbs_free(&x);
+			limbs_free(&z);
+		}
+	}
+	limbs_free(&a);
+	limbs_free(&b);
+	limbs_free(&u);
+	limbs_free(&v);
+	return status;
+}
+
+/* r = k·p by the Montgomery ladder (k >= 1); r must not alias p */
+static int point_multiply(const Curve *E, uint64_t k, const Point *p, Point *r)
+{
+	Point r1 = { { NULL, 0 }, { NULL, 0 } };
+	int status = point_copy(p, r);
+	if(status == SUCCESS && k > 1)
+	{
+		status = point_double(E, p, &r1);
+	}
+
+	int top = 63;
+	while(top > 0 && !((k >> top) & 1))
+	{
+		top--;
+	}
+	for(int i = top - 1; i >= 0 && status == SUCCESS; i--)
+	{
+		// Invariant: r1 - r = p
+		if((k >> i) & 1)
+		{
+			status = point_add(E, &r1, r, p, r);
+			if(status == SUCCESS)
+				status = point_double(E, &r1, &r1);
+		}
+		else
+		{
+			status = point_add(E, &r1, r, p, &r1);
+			if(status == SUCCESS)
+				status = point_double(E, r, r);
+		}
+	}
+	point_free(&r1);
+	return status;
+}
+
+/*****************************************************************************************
+ * Function: ecm_curve
+ * -------------------
+ * One ECM curve with Suyama's parameter sigma: u = sigma^2 - 5, v = 4·sigma, start point
+ * (u^3 : v^3), (A + 2) / 4 = (v - u)^3·(3u + v) / (16·u^3·v). Stage 1 multiplies the point by
+ * every prime power up to b1; stage 2 covers the primes up to 100·b1 as 2·ECM_D·m ± j with
+ * the products of X_m·Z_j - X_j·Z_m. Returns 1 and the factor in f if one was found.
+ *****************************************************************************************/
+
+static int ecm_curve(const Limbs *n, uint32_t sigma, uint64_t b1, Limbs *f)
+{
+	Curve E = { n, { NULL, 0 }, { NULL, 0 } };
+	Point P = { { NULL, 0 }, { NULL, 0 } }, Q = { { NULL, 0 }, { NULL, 0 } };
+	Point baby[ECM_D / 2], T = { { NULL, 0 }, { NULL, 0 } }, R = { { NULL, 0 }, { NULL, 0 } }, Rn = { { NULL, 0 }, { NULL, 0 } };
+	Limbs u = { NULL, 0 }, v = { NULL, 0 }, t = { NULL, 0 }, w = { NULL, 0 }, g = { NULL, 0 };
+	int found = FAILURE;
+	memset(baby, 0, sizeof(baby));
+
+	// Curve and start point
+	if(mod_small((long long)sigma * sigma - 5, n, &u) == FAILURE || mod_small(4LL * sigma, n, &v) == FAILURE ||
+	   mod_mul(&u, &u, n, &t) == FAILURE || mod_mul(&t, &u, n, &P.x) == FAILURE ||
+	   mod_mul(&v, &v, n, &t) == FAILURE || mod_mul(&t, &v, n, &P.z) == FAILURE ||
+	   mod_sub(&v, &u, n, &t) == FAILURE || mod_mul(&t, &t, n, &w) == FAILURE || mod_mul(&w, &t, n, &w) == FAILURE ||
+	   mod_add(&u, &u, n, &t) == FAILURE || mod_add(&t, &u, n, &t) == FAILURE || mod_add(&t, &v, n, &t) == FAILURE ||
+	   mod_mul(&w, &t, n, &E.an) == FAILURE || mod_small(16, n, &t) == FAILURE ||
+	   mod_mul(&t, &P.x, n, &t) == FAILURE || mod_mul(&t, &v, n, &E.ad) == FAILURE)
+	{
+		goto done;
+	}
+
+	// Stage 1: Q = (product of all prime powers <= b1)·P
+	for(int i = 0; i < prime_count && primes[i] <= b1; i++)
+	{
+		uint64_t q = primes[i];
+		while(q * primes[i] <= b1)
+		{
+			q *= primes[i];
+		}
+		if(point_multiply(&E, q, &P, &Q) == FAILURE)
+			goto done;
+		point_free(&P);
+		P = Q;
+		memset(&Q, 0, sizeof(Q));
+	}
+	if(limbs_gcd(&P.z, n, &g) == FAILURE)
+	{
+		goto done;
+	}
+	found = !(g.n == 1 && g.d[0] == 1) && limbs_cmp(&g, n) != EQUAL;
+	if(found || limbs_cmp(&g, n) == EQUAL)
+	{
+		goto done;
+	}
+
+	// Stage 2: baby steps j·P for odd j < ECM_D (baby[j / 2]), giant steps (2·ECM_D·m)·P
+	if(point_copy(&P, &baby[0]) == FAILURE || point_double(&E, &P, &T) == FAILURE ||
+	   point_add(&E, &T, &baby[0], &baby[0], &baby[1]) == FAILURE)
+	{
+		goto done;
+	}
+	for(int j = 2; j < ECM_D / 2; j++)
+	{
+		if(point_add(&E, &baby[j - 1], &T, &baby[j - 2], &baby[j]) == FAILURE)
+			goto done;
+	}
+
+	uint64_t m = b1 / (2 * ECM_D);
+	point_free(&T);
+	if(point_multiply(&E, 2 * ECM_D, &P, &T) == FAILURE || point_multiply(&E, 2 * ECM_D * m, &P, &R) == FAILURE ||
+	   point_multiply(&E, 2 * ECM_D * (m + 1), &P, &Rn) == FAILURE || limbs_set_small(&g, 1) == FAILURE)
+	{
+		goto done;
+	}
+
+	for(; m <= 100 * b1 / (2 * ECM_D); m++)
+	{
+		for(int j = 1; j < ECM_D; j += 2)
+		{
+			if(j % 3 == 0 || j % 5 == 0 || j % 7 == 0)
+			{
+				continue;
+			}
+			const Point *S = &baby[j / 2];
+			if(mod_mul(&R.x, &S->z, n, &t) == FAILURE || mod_mul(&S->x, &R.z, n, &w) == FAILURE ||
+			   mod_sub(&t, &w, n, &t) == FAILURE || mod_mul(&g, &t, n, &g) == FAILURE)
+			{
+				goto done;
+			}
+		}
+
+		// R(m+2) = R(m+1) + T with difference R(m)
+		Point next = { { NULL, 0 }, { NULL, 0 } };
+		if(point_add(&E, &Rn, &T, &R, &next) == FAILURE)
+		{
+			point_free(&next);
+			goto done;
+		}
+		point_free(&R);
+		R = Rn;
+		Rn = next;
+	}
+
+	if(limbs_gcd(&g, n, &g) == FAILURE)
+	{
+		goto done;
+	}
+	found = !(g.n == 1 && g.d[0] == 1) && limbs_cmp(&g, n) != EQUAL;
+
+done:
+	if(found == 1)
+	{
+		limbs_free(f);
+		*f = g;
+		g.d = NULL;
+	}
+	limbs_free(&E.an);
+	limbs_free(&E.ad);
+	point_free(&P);
+	point_free(&Q);
+	point_free(&T);
+	point_free(&R);
+	point_free(&Rn);
+	for(int j = 0; j < ECM_D / 2; j++)
+	{
+		point_free(&baby[j]);
+	}
+	limbs_free(&u);
+	limbs_free(&v);
+	limbs_free(&t);
+	limbs_free(&w);
+	limbs_free(&g);
+	return found;
+}
+
+/* A non-trivial factor of composite n: 1 if found, 0 if the whole schedule failed, FAILURE on error */
+static int find_factor(const Limbs *n, Limbs *f)
+{
+	if(n->n <= 2)
+	{
+		uint64_t d = rho64(limbs_to_u64(n));
+		if(d == 0)
+			return 0;
+		return (limbs_set_u64(f, d) == SUCCESS) ? 1 : FAILURE;
+	}
+
+	int found = rho_limbs(n, f);
+	uint32_t sigma = 6;
+	for(size_t level = 0; level < sizeof(ecm_schedule) / sizeof(ecm_schedule[0]) && found == 0; level++)
+	{
+		for(int c = 0; c < ecm_schedule[level].curves && found == 0; c++)
+		{
+			found = ecm_curve(n, sigma++, ecm_schedule[level].b1, f);
+		}
+	}
+	return found;
+}
+
+/* Factor list: factors[i] with composite[i] set for cofactors that could not be split */
+typedef struct
+{
+	Limbs *factors;
+	int *composite;
+	int count, size;
+}Factors;
+
+static int factors_push(Factors *list, const Limbs *x, int composite)
+{
+	if(list->count == list->size)
+	{
+		int size = list->size ? 2 * list->size : 16;
+		Limbs *factors = apc_realloc(list->factors, size * sizeof(Limbs));
+		if(factors == NULL)
+			return FAILURE;
+		list->factors = factors;
+		int *flags = apc_realloc(list->composite, size * sizeof(int));
+		if(flags == NULL)
+			return FAILURE;
+		list->composite = flags;
+		list->size = size;
+	}
+	memset(&list->factors[list->count], 0, sizeof(Limbs));
+	list->composite[list->count] = composite;
+	return limbs_copy(x, &list->factors[list->count++]);
+}
+
+/* Split n > 1 (free of factors below SIEVE_LIMIT) into primes */
+static int split(const Limbs *n, Factors *list)
+{
+	Limbs bound = { NULL, 0 };
+	int small = (limbs_set_u64(&bound, (uint64_t)SIEVE_LIMIT * SIEVE_LIMIT) == SUCCESS && limbs_cmp(n, &bound) == LESS);
+	limbs_free(&bound);
+	if(small)
+	{
+		return factors_push(list, n, 0);
+	}
+
+	int prime = primality(n);
+	if(prime == FAILURE)
+	{
+		return FAILURE;
+	}
+	if(prime)
+	{
+		return factors_push(list, n, 0);
+	}
+
+	Limbs f = { NULL, 0 }, rest = { NULL, 0 };
+	int found = find_factor(n, &f), status = FAILURE;
+	if(found == 0)
+	{
+		status = factors_push(list, n, 1);
+	}
+	else if(found == 1 && limbs_divmod(n, &f, &rest, NULL) == SUCCESS)
+	{
+		status = split(&f, list);
+		if(status == SUCCESS)
+			status = split(&rest, list);
+	}
+	limbs_free(&f);
+	limbs_free(&rest);
+	return status;
+}
+
+/* Print the factors in increasing order as p^e * q * ... */
+static void print_factors(Factors *list)
+{
+	// Insertion sort: factor lists are short
+	for(int i = 1; i < list->count; i++)
+	{
+		for(int j = i; j > 0 && limbs_cmp(&list->factors[j - 1], &list->factors[j]) == GREATER; j--)
+		{
+			Limbs t = list->factors[j]; list->factors[j] = list->factors[j - 1]; list->factors[j - 1] = t;
+			int c = list->composite[j]; list->composite[j] = list->composite[j - 1]; list->composite[j - 1] = c;
+		}
+	}
+
+	for(int i = 0; i < list->count; )
+	{
+		int e = 1;
+		while(i + e < list->count && limbs_cmp(&list->factors[i], &list->factors[i + e]) == EQUAL)
+		{
+			e++;
+		}
+
+		Dlist *head = NULL, *tail = NULL;
+		if(limbs_to_list(&list->factors[i], &head, &tail) == SUCCESS)
+		{
+			for(Dlist *p = head; p; p = p->next)
+				apc_printf("%d", p->data);
+		}
+		delete_list(&head, &tail);
+		if(e > 1)
+			apc_printf("^%d", e);
+		if(list->composite[i])
+			apc_printf(" (composite)");
+		i += e;
+		apc_printf("%s", (i < list->count) ? " * " : "");
+	}
+	apc_printf("\n");
+}
+
+/* ------------------------------------- list entry points ------------------------------------- */
+
+/* Primality of |n|: 2 prime, 1 probable prime, 0 composite; FAILURE on error */
+int isprime(Dlist **head1, Dlist **tail1)
+{
+	if(*head1 == NULL)
+	{
+		apc_printf("ERROR : Input list is Empty! \n");
+		return FAILURE;
+	}
+
+	Limbs n = { NULL, 0 };
+	if(limbs_from_list(*head1, &n) == FAILURE)
+	{
+		return FAILURE;
+	}
+	int result = primality(&n);
+	limbs_free(&n);
+	return result;
+}
+
+/* headR = smallest prime > n (n a magnitude; the caller handles negative n) */
+int nextprime(Dlist **head1, Dlist **tail1, Dlist **headR)
+{
+	if(*head1 == NULL)
+	{
+		apc_printf("ERROR : Input list is Empty! \n");
+		return FAILURE;
+	}
+
+	Limbs m = { NULL, 0 }, step = { NULL, 0 };
+	uint32_t *residues = NULL;
+	int status = FAILURE, small_count = 0;
+
+	if(sieve_init() == FAILURE || limbs_from_list(*head1, &m) == FAILURE || limbs_set_small(&step, 1) == FAILURE ||
+	   limbs_add(&m, &step, &m) == FAILURE)
+	{
+		goto done;
+	}
+
+	// Small candidates: machine words
+	if(m.n <= 1)
+	{
+		uint64_t x = limbs_to_u64(&m);
+		while(!is_prime64(x))
+		{
+			x++;
+		}
+		status = limbs_set_u64(&m, x);
+		goto done;
+	}
+
+	// Odd candidates, sieved by their residues modulo the small primes
+	if((m.d[0] & 1) == 0 && limbs_add(&m, &step, &m) == FAILURE)
+	{
+		goto done;
+	}
+	while(small_count < prime_count && primes[small_count] < SMALL_PRIME_BOUND)
+	{
+		small_count++;
+	}
+	if((residues = apc_malloc(small_count * sizeof(uint32_t))) == NULL || limbs_set_small(&step, 2) == FAILURE)
+	{
+		goto done;
+	}
+	for(int i = 0; i < small_count; i++)
+	{
+		residues[i] = limbs_divmod_small(&m, primes[i], NULL);
+	}
+
+	while(1)
+	{
+		int candidate = 1;
+		for(int i = 1; i < small_count && candidate; i++)       // skip 2: candidates are odd
+		{
+			candidate = (residues[i] != 0);
+		}
+		if(candidate)
+		{
+			int prime = primality(&m);
+			if(prime == FAILURE)
+				goto done;
+			if(prime)
+				break;
+		}
+
+		if(limbs_add(&m, &step, &m) == FAILURE)
+			goto done;
+		for(int i = 1; i < small_count; i++)
+		{
+			residues[i] = (residues[i] + 2) % primes[i];
+		}
+	}
+	status = SUCCESS;
+
+done:
+	if(status == SUCCESS)
+	{
+		Dlist *tailR = NULL;
+		status = limbs_to_list(&m, headR, &tailR);
+	}
+	apc_free(residues);
+	limbs_free(&m);
+	limbs_free(&step);
+	return status;
+}
+
+/* Print the prime factorization of |n| (n >= 2) */
+int factor(Dlist **head1, Dlist **tail1)
+{
+	if(*head1 == NULL)
+	{
+		apc_printf("ERROR : Input list is Empty! \n");
+		return FAILURE;
+	}
+
+	Limbs n = { NULL, 0 }, p = { NULL, 0 };
+	Factors list = { NULL, NULL, 0, 0 };
+	int status = FAILURE;
+
+	if(sieve_init() == FAILURE || limbs_from_list(*head1, &n) == FAILURE)
+	{
+		goto done;
+	}
+
+	// Trial division by the sieve primes, stopping early once p^2 > n
+	for(int i = 0; i < prime_count; i++)
+	{
+		if(n.n <= 2 && (uint64_t)primes[i] * primes[i] > limbs_to_u64(&n))
+		{
+			break;
+		}
+		while(limbs_divmod_small(&n, primes[i], NULL) == 0)
+		{
+			if(limbs_divmod_small(&n, primes[i], &n), limbs_set_small(&p, primes[i]) == FAILURE ||
+			   factors_push(&list, &p, 0) == FAILURE)
+			{
+				goto done;
+			}
+		}
+	}
+
+	status = SUCCESS;
+	if(!(n.n == 1 && n.d[0] == 1))
+	{
+		status = split(&n, &list);
+	}
+	if(status == SUCCESS)
+	{
+		print_factors(&list);
+	}
+
+done:
+	for(int i = 0; i < list.count; i++)
+	{
+		limbs_free(&list.factors[i]);
+	}
+	apc_free(list.factors);
+	apc_free(list.composite);
+	limbs_free(&n);
+	limbs_free(&p);
+	return status;
+}
@@ -0,0 +1,220 @@
+/*******************************************************************************************************************************************************************
+ * Profiling counters
+ * ------------------
+ *  Optional hot-path instrumentation, switched on with `./a.out --profile ...` or APC_PROFILE=1.
+ *  When enabled, one JSON object is written to stderr at the end of the run with:
+ *
+ *     phases_ns : exclusive wall time per phase (parse, convert, compute, normalize, print);
+ *                 a phase entered inside another pauses the outer one, so the times add up
+ *     allocs    : number of allocations and bytes requested, and node frees, including those of the helper
+ *                 threads of parallel conversions (each thread counts its own and hands them to the caller)
+ *     threads   : the most threads one conversion ran on (1: every conversion stayed on this thread)
+ *     memory    : peak bytes in use by the process and by the operation, and bytes still in use (memory.c)
+ *     operands  : digit count of every operand (one node per digit), and of the printed result
+ *     kernels   : every kernel that ran, with call count and the largest operand size seen
+ *
+ *  When disabled every hook is a single test of `apc_profile_enabled` (see the PROFILE_* macros in apc.h).
+*******************************************************************************************************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "apc.h"
+
+#define PROFILE_MAX_KERNELS   16
+#define PROFILE_MAX_DEPTH     16
+#define PROFILE_MAX_OPERANDS  4
+
+int apc_profile_enabled = 0;
+
+static const char *phase_names[PHASE_COUNT] = { "parse", "convert", "compute", "normalize", "print" };
+
+static struct
+{
+    double phase_ns[PHASE_COUNT];
+    int stack[PROFILE_MAX_DEPTH];       // active phases, innermost last
+    int depth;
+    double since;                       // start of the current slice of the innermost phase
+
+    int convert_threads;
+
+    long operand_digits[PROFILE_MAX_OPERANDS];
+    int operand_count;
+    long result_digits;
+
+    struct
+    {
+        char name[24];
+        long calls;
+        long max_size;
+    }kernels[PROFILE_MAX_KERNELS];
+    int kernel_count;
+}prof;
+
+/* Allocation counters of the calling thread; a helper thread's are charged to the caller when it is joined */
+static __thread ProfileCounts counts;
+
+static double now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+/* Enable profiling if APC_PROFILE is set to a non-zero value */
+void profile_init(void)
+{
+    const char *env = getenv("APC_PROFILE");
+    if(env && *env && strcmp(env, "0") != 0)
+    {
+        apc_profile_enabled = 1;
+    }
+}
+
+/* Enter a phase: the time of the enclosing phase stops accumulating */
+void profile_begin(int phase)
+{
+    double now = now_ns();
+    if(prof.depth > 0)
+    {
+        prof.phase_ns[prof.stack[prof.depth - 1]] += now - prof.since;
+    }
+    if(prof.depth < PROFILE_MAX_DEPTH)
+    {
+        prof.stack[prof.depth++] = phase;
+    }
+    prof.since = now;
+}
+
+/* Leave the innermost phase and resume the enclosing one */
+void profile_end(int phase)
+{
+    double now = now_ns();
+    if(prof.depth > 0 && prof.stack[prof.depth - 1] == phase)
+    {
+        prof.phase_ns[phase] += now - prof.since;
+        prof.depth--;
+    }
+    prof.since = now;
+}
+
+void profile_alloc(long bytes)
+{
+    counts.allocs++;
+    counts.alloc_bytes += bytes;
+}
+
+void profile_free(long count)
+{
+    counts.frees += count;
+}
+
+ProfileCounts profile_thread_counts(void)
+{
+    return counts;
+}
+
+/* Add the counters of a finished helper thread to this thread's */
+void profile_charge(const ProfileCounts *helper)
+{
+    counts.allocs += helper->allocs;
+    counts.alloc_bytes += helper->alloc_bytes;
+    counts.frees += helper->frees;
+}
+
+void profile_threads(int threads)
+{
+    if(threads > prof.convert_threads)
+    {
+        prof.convert_threads = threads;
+    }
+}
+
+/* Record an operand (one digit per node) */
+void profile_operand(Dlist *head)
+{
+    if(prof.operand_count < PROFILE_MAX_OPERANDS)
+    {
+        prof.operand_digits[prof.operand_count++] = find_length(head);
+    }
+}
+
+/* Record an operand that was never turned into a list (small.c) */
+void profile_operand_digits(long digits)
+{
+    if(prof.operand_count < PROFILE_MAX_OPERANDS)
+    {
+        prof.operand_digits[prof.operand_count++] = digits;
+    }
+}
+
+/* Record the result list; a NULL list keeps the size recorded where the result was printed */
+void profile_result(Dlist *head)
+{
+    if(head)
+    {
+        prof.result_digits = find_length(skip_leading_zeros(head));
+    }
+}
+
+/* Record the size of a result printed without a list ("Result : 0", limb results) */
+void profile_result_digits(long digits)
+{
+    prof.result_digits = digits;
+}
+
+/* Record one call of kernel "family:name" on an operand of `size` digits */
+void profile_kernel(const char *family, const char *name, long size)
+{
+    char key[24];
+    snprintf(key, sizeof(key), "%s:%s", family, name);
+
+    for(int i = 0; i < prof.kernel_count; i++)
+    {
+        if(strcmp(prof.kernels[i].name, key) == 0)
+        {
+            prof.kernels[i].calls++;
+            if(size > prof.kernels[i].max_size)
+                prof.kernels[i].max_size = size;
+            return;
+        }
+    }
+    if(prof.kernel_count < PROFILE_MAX_KERNELS)
+    {
+        snprintf(prof.kernels[prof.kernel_count].name, sizeof(prof.kernels[0].name), "%s", key);
+        prof.kernels[prof.kernel_count].calls = 1;
+        prof.kernels[prof.kernel_count].max_size = size;
+        prof.kernel_count++;
+    }
+}
+
+/* Write the collected counters to stderr as a single JSON object */
+void profile_report(const char *op)
+{
+    fprintf(stderr, "{\"op\": \"%s\", \"phases_ns\": {", op ? op : "");
+    for(int i = 0; i < PHASE_COUNT; i++)
+    {
+        fprintf(stderr, "%s\"%s\": %.0f", i ? ", " : "", phase_names[i], prof.phase_ns[i]);
+    }
+    fprintf(stderr, "}, \"allocs\": {\"count\": %ld, \"bytes\": %ld, \"node_frees\": %ld}, ",
+            counts.allocs, counts.alloc_bytes, counts.frees);
+    fprintf(stderr, "\"threads\": {\"convert\": %d}, ", prof.convert_threads ? prof.convert_threads : 1);
+    fprintf(stderr, "\"memory\": {\"peak_bytes\": %zu, \"operation_peak_bytes\": %zu, \"in_use_bytes\": %zu}, ",
+            memory_peak(), memory_operation_peak(), memory_in_use());
+
+    fprintf(stderr, "\"operands\": [");
+    for(int i = 0; i < prof.operand_count; i++)
+    {
+        fprintf(stderr, "%s{\"digits\": %ld}", i ? ", " : "", prof.operand_digits[i]);
+    }
+    fprintf(stderr, "], \"result\": {\"digits\": %ld}, ", prof.result_digits);
+
+    fprintf(stderr, "\"kernels\": [");
+    for(int i = 0; i < prof.kernel_count; i++)
+    {
+        fprintf(stderr, "%s{\"kernel\": \"%s\", \"calls\": %ld, \"max_digits\": %ld}", i ? ", " : "",
+                prof.kernels[i].name, prof.kernels[i].calls, prof.kernels[i].max_size);
+    }
+    fprintf(stderr, "]}\n");
+}
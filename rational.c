@@ -0,0 +1,486 @@
+/*******************************************************************************************************************************************************************
+ * Rational numbers
+ * ----------------
+ *  A Rational is an exact fraction: value = sign × num / den with den > 0. Both parts are ordinary digit lists and
+ *  all arithmetic runs on the integer kernels:
+ *
+ *     +  -  : over the common denominator lcm(b, d): a/b ± c/d = (a·(d/g) ± c·(b/g)) / (b·(d/g)), g = gcd(b, d)
+ *     *     : cross-cancelled first, (a/g1)·(c/g2) / ((b/g2)·(d/g1)) with g1 = gcd(a, d), g2 = gcd(c, b), so the
+ *             products are built from the smallest possible factors and the result needs no further reduction
+ *     /     : multiplication by the reciprocal
+ *     cmp   : sign, then a·d against c·b
+ *
+ *  Reduction is lazy. `pending` counts the operations whose result may share a factor between num and den (a sum
+ *  over a common denominator g != 1, or an unreduced input); the full gcd(num, den) is only taken once
+ *  RATIONAL_REDUCE_BATCH such operations have accumulated, and before a value is printed. Sums of reduced operands
+ *  with coprime denominators and cross-cancelled products are already reduced and do not count.
+ *
+ *  CLI:  ./a.out 1/3 + 1/6          → +1/2
+ *        Rational mode is used when an operand contains '/'; integers and decimals ("0.25" = 1/4) mix freely.
+*******************************************************************************************************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include "apc.h"
+
+/* Unreduced operations tolerated before gcd(num, den) is taken */
+#define RATIONAL_REDUCE_BATCH 4
+
+/* Does the string contain a fraction bar? */
+int is_rational(const char *s)
+{
+	return strchr(s, '/') != NULL;
+}
+
+/* x × y as a new list (NULL on failure) */
+static Dlist *product(Dlist *x, Dlist *y)
+{
+	Dlist *x_tail = list_tail(x), *y_tail = list_tail(y), *headR = NULL;
+	if(multiplication(&x, &x_tail, &y, &y_tail, &headR) == FAILURE)
+	{
+		return NULL;
+	}
+	remove_leading_zeros(&headR);
+	return headR;
+}
+
+/* gcd(x, y) as a new list (NULL on failure) */
+static Dlist *common_divisor(Dlist *x, Dlist *y)
+{
+	Dlist *x_tail = list_tail(x), *y_tail = list_tail(y), *headR = NULL;
+	if(gcd(&x, &x_tail, &y, &y_tail, &headR) == FAILURE)
+	{
+		return NULL;
+	}
+	return headR;
+}
+
+static int is_one(Dlist *x)
+{
+	long long value;
+	return list_to_long(x, &value) == SUCCESS && value == 1;
+}
+
+/* x = x / g in place (g divides x exactly) */
+static int divide_exact(Dlist **head, Dlist **tail, Dlist *g)
+{
+	if(is_one(g))
+	{
+		return SUCCESS;
+	}
+
+	Dlist *q = NULL;
+	if(divmod_schoolbook(*head, g, &q, NULL) == FAILURE)
+	{
+		return FAILURE;
+	}
+	delete_list(head, tail);
+	*head = q;
+	*tail = list_tail(q);
+	return SUCCESS;
+}
+
+/* Store num / den in r; a zero numerator becomes 0/1 with sign '+' */
+static int set_fraction(Rational *r, char sign, Dlist *num, Dlist *den, int pending)
+{
+	remove_leading_zeros(&num);
+	remove_leading_zeros(&den);
+	r->num = num;
+	r->num_tail = list_tail(num);
+	r->den = den;
+	r->den_tail = list_tail(den);
+	r->sign = sign;
+	r->pending = pending;
+
+	if(result_is_zero(num) == SUCCESS)
+	{
+		r->sign = '+';
+		r->pending = 0;
+		delete_list(&r->den, &r->den_tail);
+		return insert_at_end(&r->den, &r->den_tail, 1);
+	}
+	if(pending >= RATIONAL_REDUCE_BATCH)
+	{
+		return rational_reduce(r);
+	}
+	return SUCCESS;
+}
+
+/* =========================================================================================
+ * Function: string_to_rational
+ * -----------------------------------------------------------------------------------------
+ *  Parses [+|-]digits[/digits] or [+|-]digits.digits into a Rational (not yet reduced).
+ *  Returns SUCCESS, or FAILURE on an invalid string, a zero denominator or allocation failure.
+ * ========================================================================================= */
+
+int string_to_rational(const char *str, Rational *r)
+{
+	const char *digits;
+	char sign = remove_sign(str, &digits);
+	Dlist *num = NULL, *num_tail = NULL, *den = NULL, *den_tail = NULL;
+	int in_den = 0, seen_point = 0, num_digits = 0, den_digits = 0;
+
+	memset(r, 0, sizeof(*r));
+	if(insert_at_end(&den, &den_tail, 1) == FAILURE)
+	{
+		return FAILURE;
+	}
+
+	for(const char *p = digits; *p; p++)
+	{
+		int status = SUCCESS;
+		if(*p == '/' && !in_den && !seen_point)
+		{
+			in_den = 1;
+			delete_list(&den, &den_tail);
+		}
+		else if(*p == '.' && !in_den && !seen_point)
+		{
+			seen_point = 1;
+		}
+		else if(!isdigit((unsigned char)*p))
+		{
+			apc_printf("ERROR : Invalid character '%c'\n", *p);
+			status = FAILURE;
+		}
+		else if(in_den)
+		{
+			status = insert_at_end(&den, &den_tail, *p - '0');
+			den_digits++;
+		}
+		else
+		{
+			// every fractional digit of a decimal multiplies the denominator by 10
+			status = insert_at_end(&num, &num_tail, *p - '0');
+			if(status == SUCCESS && seen_point)
+				status = insert_at_end(&den, &den_tail, 0);
+			num_digits++;
+		}
+
+		if(status == FAILURE)
+		{
+			delete_list(&num, &num_tail);
+			delete_list(&den, &den_tail);
+			return FAILURE;
+		}
+	}
+
+	if(num_digits == 0 || (in_den && den_digits == 0))
+	{
+		apc_printf("ERROR : Empty string input.\n");
+		delete_list(&num, &num_tail);
+		delete_list(&den, &den_tail);
+		return FAILURE;
+	}
+	if(result_is_zero(den) == SUCCESS)
+	{
+		apc_printf("ERROR : Denominator is zero! \n");
+		delete_list(&num, &num_tail);
+		delete_list(&den, &den_tail);
+		return FAILURE;
+	}
+	return set_fraction(r, sign, num, den, 1);
+}
+
+void rational_free(Rational *r)
+{
+	delete_list(&r->num, &r->num_tail);
+	delete_list(&r->den, &r->den_tail);
+}
+
+/* Print sign, numerator and, unless it is 1, "/denominator" */
+void print_rational(const Rational *r)
+{
+	if(result_is_zero(r->num) == SUCCESS)
+	{
+		apc_printf("0\n");
+		return;
+	}
+	apc_printf("%c", r->sign);
+	for(Dlist *p = r->num; p; p = p->next)
+	{
+		apc_printf("%d", p->data);
+	}
+	if(!is_one(r->den))
+	{
+		apc_printf("/");
+		for(Dlist *p = r->den; p; p = p->next)
+		{
+			apc_printf("%d", p->data);
+		}
+	}
+	apc_printf("\n");
+}
+
+/* =========================================================================================
+ * Function: rational_reduce
+ * -----------------------------------------------------------------------------------------
+ *  Divides num and den by gcd(num, den) and clears the pending count.
+ * ========================================================================================= */
+
+int rational_reduce(Rational *r)
+{
+	if(r->pending == 0)
+	{
+		return SUCCESS;
+	}
+
+	Dlist *g = common_divisor(r->num, r->den);
+	if(g == NULL)
+	{
+		return FAILURE;
+	}
+	Dlist *g_tail = list_tail(g);
+	int status = SUCCESS;
+	if(divide_exact(&r->num, &r->num_tail, g) == FAILURE || divide_exact(&r->den, &r->den_tail, g) == FAILURE)
+	{
+		status = FAILURE;
+	}
+	delete_list(&g, &g_tail);
+	r->pending = 0;
+	return status;
+}
+
+/* =========================================================================================
+ * Function: rational_add
+ * -----------------------------------------------------------------------------------------
+ *  r = a + b (or a - b when subtract is set) over the common denominator lcm(a.den, b.den).
+ *  a and b are consumed and must not be used afterwards except to free them.
+ * ========================================================================================= */
+
+int rational_add(Rational *a, Rational *b, Rational *r, int subtract)
+{
+	char sign_b = b->sign;
+	if(subtract && result_is_zero(b->num) == FAILURE)
+	{
+		sign_b = (sign_b == '+') ? '-' : '+';
+	}
+
+	// Multipliers bringing each numerator to the common denominator
+	Dlist *g = common_divisor(a->den, b->den);
+	if(g == NULL)
+	{
+		return FAILURE;
+	}
+	Dlist *g_tail = list_tail(g);
+	int coprime = is_one(g);
+	Dlist *ma = NULL, *ma_tail = NULL, *mb = NULL, *mb_tail = NULL;
+	Dlist *x = NULL, *y = NULL, *den = NULL, *sum = NULL;
+	int status = FAILURE;
+
+	if(copy_list(b->den, &ma, &ma_tail) == FAILURE || copy_list(a->den, &mb, &mb_tail) == FAILURE ||
+	   divide_exact(&ma, &ma_tail, g) == FAILURE || divide_exact(&mb, &mb_tail, g) == FAILURE)
+	{
+		goto done;
+	}
+
+	x = product(a->num, ma);
+	y = product(b->num, mb);
+	den = product(a->den, ma);
+	if(x == NULL || y == NULL || den == NULL)
+	{
+		goto done;
+	}
+
+	// Signed sum of the scaled numerators
+	Dlist *x_tail = list_tail(x), *y_tail = list_tail(y);
+	char sign = a->sign;
+	if(a->sign == sign_b)
+	{
+		status = addition(&x, &x_tail, &y, &y_tail, &sum);
+	}
+	else
+	{
+		int compare = compare_numbers(x, y);
+		if(compare == EQUAL)
+		{
+			Dlist *zero_tail = NULL;
+			status = insert_at_end(&sum, &zero_tail, 0);
+		}
+		else
+		{
+			sign = (compare == GREATER) ? a->sign : sign_b;
+			status = subtraction(&x, &x_tail, &y, &y_tail, &sum);
+		}
+	}
+	delete_list(&x, &x_tail);
+	delete_list(&y, &y_tail);
+
+	if(status == SUCCESS)
+	{
+		int pending = (a->pending > b->pending) ? a->pending : b->pending;
+		status = set_fraction(r, sign, sum, den, pending + !coprime);
+		den = NULL;
+	}
+
+done:
+	delete_list(&g, &g_tail);
+	delete_list(&ma, &ma_tail);
+	delete_list(&mb, &mb_tail);
+	if(den)
+	{
+		Dlist *den_tail = list_tail(den);
+		delete_list(&den, &den_tail);
+	}
+	return status;
+}
+
+/* =========================================================================================
+ * Function: rational_mul
+ * -----------------------------------------------------------------------------------------
+ *  r = a × b, cross-cancelling gcd(a.num, b.den) and gcd(b.num, a.den) before multiplying.
+ *  a and b are consumed.
+ * ========================================================================================= */
+
+int rational_mul(Rational *a, Rational *b, Rational *r)
+{
+	Dlist *g1 = common_divisor(a->num, b->den);
+	Dlist *g2 = common_divisor(b->num, a->den);
+	Dlist *g1_tail = list_tail(g1), *g2_tail = list_tail(g2);
+	int status = FAILURE;
+
+	if(g1 != NULL && g2 != NULL &&
+	   divide_exact(&a->num, &a->num_tail, g1) == SUCCESS && divide_exact(&b->den, &b->den_tail, g1) == SUCCESS &&
+	   divide_exact(&b->num, &b->num_tail, g2) == SUCCESS && divide_exact(&a->den, &a->den_tail, g2) == SUCCESS)
+	{
+		Dlist *num = product(a->num, b->num);
+		Dlist *den = product(a->den, b->den);
+		if(num != NULL && den != NULL)
+		{
+			int pending = (a->pending > b->pending) ? a->pending : b->pending;
+			status = set_fraction(r, (a->sign == b->sign) ? '+' : '-', num, den, pending);
+		}
+		else
+		{
+			Dlist *tail = NULL;
+			delete_list(&num, &tail);
+			delete_list(&den, &tail);
+		}
+	}
+
+	delete_list(&g1, &g1_tail);
+	delete_list(&g2, &g2_tail);
+	return status;
+}
+
+/* r = a / b = a × (1 / b); FAILURE on division by zero. a and b are consumed. */
+int rational_div(Rational *a, Rational *b, Rational *r)
+{
+	if(result_is_zero(b->num) == SUCCESS)
+	{
+		apc_printf("ERROR : Division by zero! \n");
+		return FAILURE;
+	}
+
+	Dlist *head = b->num, *tail = b->num_tail;
+	b->num = b->den;
+	b->num_tail = b->den_tail;
+	b->den = head;
+	b->den_tail = tail;
+	return rational_mul(a, b, r);
+}
+
+/* =========================================================================================
+ * Function: rational_compare
+ * -----------------------------------------------------------------------------------------
+ *  Stores GREATER, EQUAL or LESS for a against b in *result (no reduction needed): the signs
+ *  decide unless they are equal, then a.num·b.den is compared with b.num·a.den.
+ *  Returns SUCCESS, or FAILURE if memory allocation fails.
+ * ========================================================================================= */
+
+int rational_compare(const Rational *a, const Rational *b, int *result)
+{
+	if(a->sign != b->sign)
+	{
+		*result = (a->sign == '+') ? GREATER : LESS;
+		return SUCCESS;
+	}
+
+	Dlist *left = product(a->num, b->den);
+	Dlist *right = product(b->num, a->den);
+	int status = FAILURE;
+	if(left != NULL && right != NULL)
+	{
+		*result = compare_numbers(left, right);
+		if(a->sign == '-')
+		{
+			*result = -*result;
+		}
+		status = SUCCESS;
+	}
+
+	Dlist *tail = NULL;
+	delete_list(&left, &tail);
+	delete_list(&right, &tail);
+	return status;
+}
+
+/********************************************************************************************************************************************************************
+ * Function: perform_rational_operation
+ * ------------------------------------
+ *  Rational counterpart of perform_operation(): + - * / ^ cmp on two Rationals, prints the reduced result
+ *  (cmp prints -1, 0 or 1).
+*******************************************************************************************************************************************************************/
+
+int perform_rational_operation(const char *op, Rational *a, Rational *b)
+{
+	Rational r;
+	int status;
+	memset(&r, 0, sizeof(r));
+
+	if(strcmp(op, "+") == 0 || strcmp(op, "-") == 0)
+	{
+		status = rational_add(a, b, &r, strcmp(op, "-") == 0);
+	}
+	else if(strcmp(op, "*") == 0)
+	{
+		status = rational_mul(a, b, &r);
+	}
+	else if(strcmp(op, "^") == 0)
+	{
+		// Square of the first operand, like the integer operator
+		Rational copy;
+		memset(&copy, 0, sizeof(copy));
+		copy.sign = a->sign;
+		copy.pending = a->pending;
+		status = copy_list(a->num, &copy.num, &copy.num_tail);
+		if(status == SUCCESS)
+			status = copy_list(a->den, &copy.den, &copy.den_tail);
+		if(status == SUCCESS)
+			status = rational_mul(a, &copy, &r);
+		rational_free(&copy);
+	}
+	else if(strcmp(op, "/") == 0)
+	{
+		status = rational_div(a, b, &r);
+	}
+	else if(strcmp(op, "cmp") == 0)
+	{
+		int compare;
+		status = rational_compare(a, b, &compare);
+		if(status == SUCCESS)
+		{
+			apc_printf("Result          : %d\n", compare);
+		}
+		return status;
+	}
+	else
+	{
+		apc_printf("ERROR : Operator %s is not supported for rational operands [+,-,*,/,^,cmp] \n", op);
+		return FAILURE;
+	}
+
+	if(status == SUCCESS)
+	{
+		status = rational_reduce(&r);
+	}
+	if(status == SUCCESS)
+	{
+		apc_printf("Result          : ");
+		print_rational(&r);
+	}
+	rational_free(&r);
+	return status;
+}
@@ -0,0 +1,249 @@
+/*******************************************************************************************************************************************************************
+ * Function: ISQRT / IROOT
+ * -----------------------
+ *  Integer square root and integer k-th root: the largest r with r^k <= N.
+ *
+ *  Example:
+ *     isqrt(1000)     = 31       (31^2 = 961 <= 1000 < 1024 = 32^2)
+ *     iroot(1000, 3)  = 10
+ *
+ *  Algorithm (Newton iteration with precision doubling, on base-10^9 limbs):
+ *     - Radicands below 10^18 (two limbs) are seeded from a floating-point estimate and corrected exactly.
+ *     - Larger N is split as N = Nhi·B^(k·h) + Nlo with h ≈ limbs / 2k, so Nhi keeps about half of
+ *       the limbs of the root. r' = iroot(Nhi) is computed recursively and x0 = (r' + 1)·B^h is an
+ *       upper bound of the root, already correct to about half its digits.
+ *     - Newton steps x = ((k-1)·x + N / x^(k-1)) / k then descend from x0; one or two steps double
+ *       the correct digits up to full precision, and the iteration stops as soon as x stops decreasing.
+ *     Each level costs a few divisions of its own size (limbs_divmod, x^(k-1) by limbs_mul), so the
+ *     total is a small multiple of the top level instead of one trial per digit.
+ *
+ *  Parameters:
+ *     head1, tail1 → the radicand N (non-negative)
+ *     k            → root degree (>= 1)
+ *     headR        → pointer to the head of result list (stores the root)
+ *
+ *  Returns:
+ *     SUCCESS (0) if the root is computed
+ *     FAILURE (-1) if the input list is empty, k < 1 or memory allocation fails
+*******************************************************************************************************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "apc.h"
+
+/* Radicands of up to this many limbs (below 10^18) are handled in machine integers */
+#define ROOT_SMALL_LIMBS 2
+
+/* Is r^k > n? (stops before overflowing) */
+static int power_exceeds(long long r, int k, long long n)
+{
+	long long p = 1;
+	for(int i = 0; i < k; i++)
+	{
+		if(r != 0 && p > n / r)
+		{
+			return 1;
+		}
+		p *= r;
+	}
+	return p > n;
+}
+
+/* Exact k-th root of a machine integer: floating-point seed, then integer correction */
+static long long small_root(long long n, int k)
+{
+	long long r = (long long)pow((double)n, 1.0 / k);
+
+	while(r > 0 && power_exceeds(r, k, n))
+	{
+		r--;
+	}
+	while(!power_exceeds(r + 1, k, n))
+	{
+		r++;
+	}
+	return r;
+}
+
+/* x = x·B^h: h zero limbs below the current ones */
+static int limbs_shift_up(Limbs *x, int h)
+{
+	uint32_t *d = apc_realloc(x->d, (x->n + h) * sizeof(uint32_t));
+	if(d == NULL)
+	{
+		return FAILURE;
+	}
+	memmove(d + h, d, x->n * sizeof(uint32_t));
+	memset(d, 0, h * sizeof(uint32_t));
+	x->d = d;
+	x->n += h;
+	return SUCCESS;
+}
+
+/* r = x^e by square-and-multiply (e >= 1) */
+static int limbs_power(const Limbs *x, int e, Limbs *r)
+{
+	Limbs square = { NULL, 0 }, result = { NULL, 0 };
+	int started = 0, status = limbs_copy(x, &square);
+
+	while(status == SUCCESS)
+	{
+		if(e & 1)
+		{
+			status = started ? limbs_mul(&result, &square, &result) : limbs_copy(&square, &result);
+			started = 1;
+		}
+		e >>= 1;
+		if(status == FAILURE || e == 0)
+		{
+			break;
+		}
+		status = limbs_mul(&square, &square, &square);
+	}
+
+	if(status == SUCCESS)
+	{
+		limbs_free(r);
+		*r = result;
+		result.d = NULL;
+	}
+	limbs_free(&square);
+	limbs_free(&result);
+	return status;
+}
+
+/* One Newton step: next = ((k-1)·x + N / x^(k-1)) / k */
+static int newton_step(const Limbs *n, const Limbs *x, int k, Limbs *next)
+{
+	Limbs power = { NULL, 0 }, quotient = { NULL, 0 };
+	uint32_t degree = k;
+	Limbs divisor = { &degree, 1 };
+	int status;
+
+	// N / x^(k-1)
+	if(k == 2)
+	{
+		status = limbs_divmod(n, x, &quotient, NULL);
+	}
+	else if((status = limbs_power(x, k - 1, &power)) == SUCCESS)
+	{
+		status = limbs_divmod(n, &power, &quotient, NULL);
+	}
+
+	if(status == SUCCESS && (status = limbs_lincomb(x, k - 1, &quotient, 1, next)) == SUCCESS)
+	{
+		status = limbs_divmod(next, &divisor, next, NULL);
+	}
+	limbs_free(&power);
+	limbs_free(&quotient);
+	return status;
+}
+
+/* Recursive precision-doubling k-th root of a non-zero, trimmed n */
+static int root_newton(const Limbs *n, int k, Limbs *r)
+{
+	// Small radicand: floating-point seed, exact correction
+	if(n->n <= ROOT_SMALL_LIMBS)
+	{
+		return limbs_set_u64(r, small_root(limbs_to_u64(n), k));
+	}
+
+	Limbs x = { NULL, 0 };
+	int h = n->n / (2 * k), status;
+	if(h == 0)
+	{
+		// Root has at most two limbs: start from 10^ceil(digits / k), an upper bound
+		int digits = LIMB_DIGITS * (n->n - 1), e;
+		for(uint32_t top = n->d[n->n - 1]; top > 0; top /= 10)
+		{
+			digits++;
+		}
+		e = (digits + k - 1) / k;
+		uint32_t power = 1;
+		for(int i = 0; i < e % LIMB_DIGITS; i++)
+		{
+			power *= 10;
+		}
+		if((status = limbs_set_small(&x, power)) == SUCCESS)
+		{
+			status = limbs_shift_up(&x, e / LIMB_DIGITS);
+		}
+	}
+	else
+	{
+		// Root of the leading limbs ⌊N / B^(k·h)⌋, then x0 = (r' + 1)·B^h >= root
+		Limbs top = { n->d + k * h, n->n - k * h };
+		uint32_t unit = 1;
+		Limbs one = { &unit, 1 };
+		if((status = root_newton(&top, k, &x)) == SUCCESS && (status = limbs_add(&x, &one, &x)) == SUCCESS)
+		{
+			status = limbs_shift_up(&x, h);
+		}
+	}
+
+	// Newton descent from the upper bound until x stops decreasing
+	while(status == SUCCESS)
+	{
+		Limbs next = { NULL, 0 };
+		if((status = newton_step(n, &x, k, &next)) == SUCCESS && limbs_cmp(&next, &x) == LESS)
+		{
+			limbs_free(&x);
+			x = next;
+			continue;
+		}
+		limbs_free(&next);
+		break;
+	}
+
+	if(status == SUCCESS)
+	{
+		limbs_free(r);
+		*r = x;
+		x.d = NULL;
+	}
+	limbs_free(&x);
+	return status;
+}
+
+int iroot(Dlist **head1, Dlist **tail1, int k, Dlist **headR)
+{
+	if(*head1 == NULL)
+	{
+		apc_printf("ERROR : Input list is Empty! \n");
+		return FAILURE;
+	}
+	if(k < 1)
+	{
+		apc_printf("ERROR : Root degree must be at least 1! \n");
+		return FAILURE;
+	}
+
+	if(list_writable(head1, tail1) == FAILURE)
+	{
+		return FAILURE;
+	}
+	remove_leading_zeros(head1);
+	if(k == 1 || result_is_zero(*head1) == SUCCESS)
+	{
+		Dlist *tailR = NULL;
+		return copy_list(*head1, headR, &tailR);
+	}
+
+	Limbs n = { NULL, 0 }, r = { NULL, 0 };
+	int status = FAILURE;
+	if(limbs_from_list(*head1, &n) == SUCCESS && root_newton(&n, k, &r) == SUCCESS)
+	{
+		Dlist *tailR = NULL;
+		status = limbs_to_list(&r, headR, &tailR);
+	}
+	limbs_free(&n);
+	limbs_free(&r);
+	return status;
+}
+
+int isqrt(Dlist **head1, Dlist **tail1, Dlist **headR)
+{
+	return iroot(head1, tail1, 2, headR);
+}
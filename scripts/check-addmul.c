@@ -0,0 +1,130 @@
+/*******************************************************************************************************************************************************************
+ * word_addmul_1 implementations against each other (make check)
+ * ---------------------------------------------------------------
+ *  Runs the adx (mulx / adcx / adox asm) and the generic (128-bit C) rows of basecase.c on the same operands,
+ *  each against a plain one-word-at-a-time row, and compares the rows and the carries they return. Rows of 1
+ *  to 67 words cover every remainder of the 4-word blocks, with the words drawn from three patterns:
+ *
+ *     random : uniform words
+ *     ones   : every word of a, r and b all-ones, so both carry chains (CF and OF) carry on every word
+ *     mixed  : each word 0, all-ones or random
+ *
+ *  A guard word after the row must be left alone. On a CPU without BMI2 / ADX only the generic row runs.
+ *
+ *  Usage: build/<variant>/check_addmul.out [seed]
+*******************************************************************************************************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "fixed.h"
+
+#define MAX_WORDS   67
+#define TRIALS      200
+#define GUARD       0x5a5a5a5a5a5a5a5aull
+
+static uint64_t state = 0x9e3779b97f4a7c15ull;
+
+/* xorshift64* */
+static uint64_t next_random(void)
+{
+	state ^= state >> 12;
+	state ^= state << 25;
+	state ^= state >> 27;
+	return state * 0x2545f4914f6cdd1dull;
+}
+
+static const char *patterns[] = { "random", "ones", "mixed" };
+
+static uint64_t next_word(int pattern)
+{
+	if(pattern == 1)
+	{
+		return ~0ull;
+	}
+	if(pattern == 2)
+	{
+		uint64_t pick = next_random() % 3;
+		return (pick == 0) ? 0 : (pick == 1) ? ~0ull : next_random();
+	}
+	return next_random();
+}
+
+/* r[0 .. n) += a[0 .. n) × b one word at a time */
+static uint64_t reference_row(uint64_t *r, const uint64_t *a, int n, uint64_t b)
+{
+	uint64_t carry = 0;
+	for(int i = 0; i < n; i++)
+	{
+		fixed_dword t = (fixed_dword)a[i] * b + r[i] + carry;
+		r[i] = (uint64_t)t;
+		carry = (uint64_t)(t >> 64);
+	}
+	return carry;
+}
+
+int main(int argc, char *argv[])
+{
+	if(argc > 1)
+	{
+		state = strtoull(argv[1], NULL, 10) | 1;
+	}
+
+	const char *names[] = { "generic", "adx" };
+	word_addmul_1_fn impls[] = { word_addmul_1_impl("generic"), word_addmul_1_impl("adx") };
+	uint64_t a[MAX_WORDS], r[MAX_WORDS + 1], expected[MAX_WORDS + 1], actual[MAX_WORDS + 1];
+	int failures = 0;
+
+	for(int n = 1; n <= MAX_WORDS; n++)
+	{
+		for(int pattern = 0; pattern < 3; pattern++)
+		{
+			for(int trial = 0; trial < TRIALS; trial++)
+			{
+				for(int i = 0; i < n; i++)
+				{
+					a[i] = next_word(pattern);
+					r[i] = next_word(pattern);
+				}
+				r[n] = GUARD;
+				uint64_t b = next_word(pattern);
+
+				for(int i = 0; i <= n; i++)
+				{
+					expected[i] = r[i];
+				}
+				uint64_t expected_carry = reference_row(expected, a, n, b);
+
+				for(int k = 0; k < 2; k++)
+				{
+					if(impls[k] == NULL)
+					{
+						continue;
+					}
+					for(int i = 0; i <= n; i++)
+					{
+						actual[i] = r[i];
+					}
+					uint64_t carry = impls[k](actual, a, n, b);
+					int same = (carry == expected_carry);
+					for(int i = 0; i <= n; i++)
+					{
+						same &= (actual[i] == expected[i]);
+					}
+					if(!same)
+					{
+						failures++;
+						fprintf(stderr, "FAIL addmul : %s, %d words, %s, trial %d\n", names[k], n, patterns[pattern], trial);
+					}
+				}
+			}
+		}
+	}
+
+	if(failures)
+	{
+		fprintf(stderr, "addmul rows: %d failed\n", failures);
+		return 1;
+	}
+	printf("addmul rows (%s): all passed\n", impls[1] ? "adx and generic" : "generic only, no ADX on this CPU");
+	return 0;
+}
@@ -0,0 +1,81 @@
+#!/bin/sh
+# --client pipeline against one-shot runs (make check).
+#
+# Starts `--serve` on a temporary socket, writes every request to one connection before reading
+# (pipelined), and compares each response with the result a one-shot run of the same arguments
+# prints. Covers the operators, sizes from 1 to 2000 digits, errors and multi-line results.
+# Connections that send nothing must not hold the workers: with more idle clients than threads,
+# a request on another connection is still answered.
+#
+# Usage: scripts/check-client.sh <path to apc.out>
+
+APC=${1:-./apc.out}
+. "$(dirname "$0")/check-lib.sh"
+
+if [ ! -x "$APC" ]; then
+    echo "ERROR : $APC is not an executable" >&2
+    exit 1
+fi
+
+dir=$(mktemp -d) || exit 1
+socket=$dir/apc.sock
+"$APC" --serve "$socket" --threads 2 > /dev/null 2>&1 &
+server=$!
+idle=
+trap 'kill $server $idle 2> /dev/null; rm -rf "$dir"' EXIT INT TERM
+
+# The server is up once its socket exists
+tries=0
+while [ ! -S "$socket" ] && [ $tries -lt 50 ]; do
+    sleep 0.1
+    tries=$((tries + 1))
+done
+
+# One request per line
+{
+    for size in 1 20 40 100 500 2000; do
+        a=$(digits $size)
+        b=$(digits $(( size / 2 + 1 )))
+        for op in + - "*" / % "^" cmp gcd; do
+            echo "$a $op -$b"
+        done
+        echo "-$a addmul $b $b"
+    done
+    echo "12 / 0"
+    echo "-5 isprime"
+    echo "97 isprime"
+    echo "360 factor"
+    echo "240 xgcd 46"
+    echo "4 powmod 13 497"
+    echo "50 !"
+} > "$dir/requests"
+
+"$APC" --client "$socket" - < "$dir/requests" > "$dir/responses" 2>&1
+
+# Each request's expected text, in order, against the pipelined responses
+while IFS= read -r line; do
+    set -- $line
+    result "$APC" "$@"
+done < "$dir/requests" > "$dir/expected"
+
+if ! cmp -s "$dir/expected" "$dir/responses"; then
+    failures=$((failures + 1))
+    echo "FAIL client : responses differ from one-shot runs" >&2
+    diff "$dir/expected" "$dir/responses" | head -20 >&2
+fi
+
+# Idle clients: connected, reading a pipe that stays silent while this shell holds its write end
+mkfifo "$dir/quiet"
+exec 3<> "$dir/quiet"
+for i in 1 2 3; do
+    "$APC" --client "$socket" - < "$dir/quiet" 3>&- > /dev/null 2>&1 &
+    idle="$idle $!"
+done
+sleep 0.2
+actual=$(timeout 10 "$APC" --client "$socket" 12 "*" 34 2>&1)
+expect idle "Result          : +408" "$actual" "$APC" --client "$socket" 12 "*" 34
+exec 3>&-
+wait $idle
+idle=
+
+finish "client pipeline"
@@ -0,0 +1,64 @@
+#!/bin/sh
+# Parallel decimal conversion in small chunks (make check).
+#
+# The check build (make BUILD=check) converts with a grain of 16 digits or limbs over 8 threads,
+# and splits aggregates into shares of 4 values, so short numbers already cross many chunk
+# boundaries. Numbers read and printed back through the digit lists and the limbs have to come out
+# unchanged, and every other result has to match the release build.
+#
+# Usage: scripts/check-convert.sh <check build apc.out> <release apc.out>
+
+CHECK=${1:-build/check/apc.out}
+APC=${2:-./apc.out}
+. "$(dirname "$0")/check-lib.sh"
+
+for exe in "$CHECK" "$APC"; do
+    if [ ! -x "$exe" ]; then
+        echo "ERROR : $exe is not an executable" >&2
+        exit 1
+    fi
+done
+
+dir=$(mktemp -d) || exit 1
+trap 'rm -rf "$dir"' EXIT INT TERM
+
+# Sizes on, around and between chunk boundaries (16 digits, 16 limbs = 144 digits)
+for size in 1 15 16 17 33 143 144 145 1000 2049 5000; do
+    a=$(digits $size)
+    b=$(digits $(( size / 3 + 1 )))
+
+    # Digit lists: parsed in chunks, printed in chunks
+    expect list "Result          : +$a" "$(result "$CHECK" "$a" + 0)" "$CHECK" "$a" + 0
+    expect list "Result          : -$a" "$(result "$CHECK" "-00$a" + 0)" "$CHECK" "-00$a" + 0
+
+    # Limbs: packed in ranges, printed in ranges
+    printf '%s\n-%s\n' "$a" "$a" > "$dir/values"
+    expect limbs "$(printf 'Result          : -%s\nResult          : +%s' "$a" "$a")" \
+        "$("$CHECK" --aggregate sort "$dir/values" 2> /dev/null)" "$CHECK" --aggregate sort "$dir/values"
+
+    for op in "*" / % gcd; do
+        expect "$op" "$(result "$APC" "$a" "$op" "$b")" "$(result "$CHECK" "$a" "$op" "$b")" "$CHECK" "$a" "$op" "$b"
+    done
+    expect modulus "$("$APC" --modulus "$b" % "$a" "$a$b" 2> /dev/null)" \
+        "$("$CHECK" --modulus "$b" % "$a" "$a$b" 2> /dev/null)" "$CHECK" --modulus "$b" % "$a" "$a$b"
+
+    # An invalid character in the last chunk
+    expect invalid "$("$APC" "${a}x1" + 0 2>&1)" "$("$CHECK" "${a}x1" + 0 2>&1)" "$CHECK" "${a}x1" + 0
+done
+
+# Aggregates split into many shares, and a limb result long enough for several ranges
+for count in 3 4 5 17 100; do
+    i=0
+    while [ $i -lt $count ]; do
+        digits $(( i % 40 + 1 ))
+        echo
+        i=$((i + 1))
+    done > "$dir/values"
+    for op in sum product min max sort; do
+        expect "aggregate $op" "$("$APC" --aggregate $op "$dir/values" 2> /dev/null)" \
+            "$("$CHECK" --aggregate $op "$dir/values" 2> /dev/null)" "$CHECK" --aggregate $op "$dir/values"
+    done
+done
+expect factorial "$(result "$APC" 1000 !)" "$(result "$CHECK" 1000 !)" "$CHECK" 1000 !
+
+finish "conversion"
@@ -0,0 +1,138 @@
+#!/bin/sh
+# Known answers for every operator and mode (make check).
+#
+# Each case lists the expected values of a run's Result lines (and Coefficient / Digits lines), with
+# the labels stripped and several lines joined by " ; ". The answers were worked out independently of
+# the calculator, so a wrong result is caught even when every code path agrees with the others.
+#
+# Usage: scripts/check-known.sh <path to apc.out>
+
+APC=${1:-./apc.out}
+. "$(dirname "$0")/check-lib.sh"
+
+if [ ! -x "$APC" ]; then
+    echo "ERROR : $APC is not an executable" >&2
+    exit 1
+fi
+
+dir=$(mktemp -d) || exit 1
+trap 'rm -rf "$dir"' EXIT INT TERM
+
+# A string of $1 nines
+nines() {
+    printf "%${1}s" "" | tr ' ' 9
+}
+
+# known <expected> <arguments...>
+known() {
+    expected=$1
+    shift
+    actual=$("$APC" "$@" 2>&1 | awk -F' *: ' '/^(Result|Coefficient|Digits) / { printf "%s%s", sep, $2; sep = " ; " }')
+    expect known "$expected" "$actual" "$APC" "$@"
+}
+
+# Integers through the lists (more than 38 digits) and through the 128-bit path
+known "+152415787532388367501905199875019052100"  12345678901234567890 "*" 12345678901234567890
+known "+265613988875874769338781322035779626829233452653394495974574961739092490901302182994384699044001" \
+      515377520732011331036461129765621272702107522001 "^" 0
+known "-123456788148148"                          -123456789012345678901234 / 1000000007
+known "-161864198"                                -123456789012345678901234 % 1000000007
+known "Cannot divide by Zero!"                    12 / 0
+known "+24"                                       4 addmul 5 4
+known "-16"                                       4 submul 5 4
+
+# Decimals and rationals
+known "+3.375"                                    1.5 "*" 2.25
+known "+0.3"                                      0.1 + 0.2
+known "+0.33333"                                  --precision 5 1 / 3
+known "+2.34"                                     --precision 2 --rounding half-even 2.345 + 0
+known "+2.35"                                     --precision 2 --rounding half-up 2.345 "*" 1
+known "+1/2"                                      1/3 + 1/6
+known "-1"                                        -1/2 cmp 1/3
+
+# Roots
+known "+10"                                       100 isqrt
+known "+9"                                        99 isqrt
+known "+12345678901234567890"                     152415787532388367501905199875019052100 isqrt
+known "+12345678901234567889"                     152415787532388367501905199875019052099 isqrt
+known "+10"                                       1000 iroot 3
+known "+99999999999999999999"                     999999999999999999999999999999999999999999999999999999999999 iroot 3
+
+# gcd, extended gcd, modular inverse
+known "+6"                                        12 gcd 18
+known "+3298534883328"                            55340232221128654848 gcd 9895604649984
+known "+2 ; -9 ; +47"                             240 xgcd 46
+known "+18633540"                                 123456789 invmod 1000000007
+known "No inverse (gcd != 1)"                     4 invmod 8
+
+# Primes
+known "prime"                                     1000000007 isprime
+known "probable prime"                            2305843009213693951 isprime
+known "composite"                                 561 isprime
+known "composite"                                 -5 isprime
+known "+101"                                      97 nextprime
+known "+100000000000000000039"                    100000000000000000000 nextprime
+known "2^2 * 3 * 5^2"                             300 factor
+known "71 * 839 * 1471 * 6857"                    600851475143 factor
+
+# Products: factorial, binomial, prod
+known "+2432902008176640000"                      20 "!"
+known "+1"                                        0 "!"
+known "+100891344545564193334812497256"           100 binomial 50
+known "0"                                         5 binomial 7
+known "+24"                                       2 prod 3 4
+known "-6"                                        -2 prod 3
+
+# Modular power
+known "+445"                                      4 powmod 13 497
+known "+12025050231696925086731743046088503371"   3 powmod 100000000000000000000 170141183460469231731687303715884105727
+known "+13765163169933189796391687259351622915460723737276318694853540099862020475623" \
+      1191621485107834860440615455142345845183653056689567020163423330305651477969 powmod 17660291972290482832 \
+      87704155826997445812482281258015161561075299732213420302411390935009168890017
+
+# Modular power at each fixed width: n = 10^k - 1 has 256, 512, 1024, 2047 and 4096 bits for these k. As
+# 10^k = 1 (mod n), 10^(2km + 5) = 10^5 and (-10)^(2km + 7) = n - 10^7, which is k - 8 nines, an 8, seven nines.
+for k in 77 154 308 616 1233; do
+    n=$(nines $k)
+    e=$((2 * k * 1000000007))
+    known "+100000"                               10 powmod $((e + 5)) $n
+    known "+$(nines $((k - 8)))8$(nines 7)"       -10 powmod $((e + 7)) $n
+done
+
+# Short products
+known "+784"                                      --lastdigits 3 123456 "*" 789
+known "+974 ; 8"                                  --firstdigits 3 123456 "*" 789
+known "+1"                                        --lastdigits 1 515377520732011331036461129765621272702107522001 "^"
+known "+26561 ; 96"                               --firstdigits 5 515377520732011331036461129765621272702107522001 "^"
+
+# One divisor, many dividends
+known "+161864198 ; +518523284"                   --modulus 1000000007 % 123456789012345678901234 98765432109876543210
+known "+123456788148148"                          --modulus 1000000007 / 123456789012345678901234
+
+# Batched rows
+printf '1 2\n3 4\n-5 6\n99999999999999999999 99999999999999999999\n' > "$dir/rows"
+known "+2 ; +12 ; -30 ; +9999999999999999999800000000000000000001"    --batch "*" "$dir/rows"
+known "+3 ; +7 ; +1 ; +199999999999999999998"                         --batch + "$dir/rows"
+known "-1 ; -1 ; -1 ; 0"                                              --batch cmp "$dir/rows"
+
+# Aggregates
+seq 1 100 > "$dir/values"
+known "+5050"                                     --aggregate sum "$dir/values"
+printf '3, -7, 25\n0\n' > "$dir/values"
+known "-7"                                        --aggregate min "$dir/values"
+known "+25"                                       --aggregate max "$dir/values"
+known "0"                                         --aggregate product "$dir/values"
+known "-7 ; 0 ; +3 ; +25"                         --aggregate sort "$dir/values"
+seq 1 25 > "$dir/values"
+known "+15511210043330985984000000"               --aggregate product "$dir/values"
+
+# Out-of-core files
+printf '123456789' > "$dir/a"
+printf '987654321' > "$dir/b"
+known "-1"                                        --out-of-core "$dir/a" cmp "$dir/b"
+"$APC" --out-of-core "$dir/a" "*" "$dir/b" "$dir/r" > /dev/null 2>&1
+expect out-of-core "121932631112635269" "$(cat "$dir/r" 2> /dev/null)" "$APC" --out-of-core "$dir/a" "*" "$dir/b" "$dir/r"
+"$APC" --out-of-core "$dir/a" - "$dir/b" "$dir/r" > /dev/null 2>&1
+expect out-of-core "-864197532" "$(cat "$dir/r" 2> /dev/null)" "$APC" --out-of-core "$dir/a" - "$dir/b" "$dir/r"
+
+finish "known answers"
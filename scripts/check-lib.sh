@@ -0,0 +1,35 @@
+# Helpers shared by the check-*.sh harnesses (make check); sourced, not run.
+
+failures=0
+
+# Operands such as * are passed unquoted through `set --`; never expand them as file names
+set -f
+
+# Random number of $1 digits without a leading zero
+digits() {
+    od -An -tu1 -N "$1" /dev/urandom | tr -s ' \n' '\n\n' | awk 'NF { printf "%d", (n++ == 0) ? 1 + $1 % 9 : $1 % 10 }'
+}
+
+# What a one-shot run printed between its two separator lines (the text a server response carries)
+result() {
+    "$@" 2> /dev/null | awk '/^-+$/ { part++; next } part == 1'
+}
+
+# expect <name> <expected> <actual> <command...>: count and report a mismatch
+expect() {
+    if [ "$2" != "$3" ]; then
+        failures=$((failures + 1))
+        name=$1
+        shift 3
+        echo "FAIL $name : $*" >&2
+    fi
+}
+
+# Summary line; exit status 1 if any case failed
+finish() {
+    if [ "$failures" -ne 0 ]; then
+        echo "$1: $failures failed" >&2
+        exit 1
+    fi
+    echo "$1: all passed"
+}
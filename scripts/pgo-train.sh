@@ -0,0 +1,39 @@
+#!/bin/sh
+# Training workload for profile-guided builds (make pgo).
+#
+# Runs the instrumented calculator over every operator (+ - * / % ^, addmul, submul)
+# with operand sizes from 10 to 5000 digits, all sign combinations and unbalanced
+# operand pairs, so the recorded profile covers the kernels the registry picks at
+# realistic sizes (column and Karatsuba products, long division).
+#
+# Usage: scripts/pgo-train.sh <path to apc.out>
+
+APC=${1:-./apc.out}
+
+if [ ! -x "$APC" ]; then
+    echo "ERROR : $APC is not an executable" >&2
+    exit 1
+fi
+
+# Random number of $1 digits without a leading zero
+digits() {
+    od -An -tu1 -N "$1" /dev/urandom | tr -s ' \n' '\n\n' | awk 'NF { printf "%d", (n++ == 0) ? 1 + $1 % 9 : $1 % 10 }'
+}
+
+for size in 10 40 100 300 1000 5000; do
+    a=$(digits $size)
+    b=$(digits $size)
+    small=$(digits $(( size / 10 + 1 )))
+
+    for signs in "+ +" "+ -" "- +" "- -"; do
+        set -- $signs
+        for op in + - "*" / % "^"; do
+            "$APC" "$1$a" "$op" "$2$b" > /dev/null
+            "$APC" "$1$a" "$op" "$2$small" > /dev/null
+        done
+        "$APC" "$1$a" addmul "$2$b" "$small" > /dev/null
+        "$APC" "$1$a" submul "$2$b" "$small" > /dev/null
+    done
+done
+
+echo "PGO training run completed with $APC"
@@ -0,0 +1,807 @@
+/*******************************************************************************************************************************************************************
+ * Function: SERVE / CLIENT
+ * ------------------------
+ *  Resident calculator: one process keeps running and answers requests over a Unix domain socket, so a caller
+ *  pays neither process creation nor the banner output of ./a.out for every calculation.
+ *
+ *     ./a.out --serve <socket path> [--threads N]
+ *     ./a.out --client <socket path> <arguments...>        one request, e.g. ./a.out --client /tmp/apc.sock 12 "*" 34
+ *     ./a.out --client <socket path> -                     one request per line of stdin, all pipelined
+ *
+ *  Protocol (lengths are 4-byte big-endian integers):
+ *     request  : length, then the arguments exactly as on the command line, each terminated by '\0'
+ *                ("12\0*\0" "34\0"); leading --precision N and --rounding MODE are accepted
+ *     response : length, then one status byte (0 = SUCCESS, 1 = FAILURE) and the text the operation printed:
+ *                the "Result          : ..." line(s), or the error messages
+ *
+ *  A connection may pipeline: any number of requests can be written before the first response is read.
+ *  Responses come back in request order; every request already buffered is answered before the responses
+ *  are written out with one write.
+ *
+ *  Threads: the main thread polls the listening socket and every connection that is waiting for input, and reads
+ *  what arrives. A connection is queued for the pool of N workers (default: one per CPU) only once a complete
+ *  request is buffered, so idle or slow clients hold no worker. A worker answers the requests buffered on the
+ *  connection and hands it back to the poller; it runs them in order with
+ *     - a node arena for the operand and result lists of that connection (see memory.c), released on close
+ *     - apc_output pointed at the response buffer, so every apc_printf of the kernels goes to the caller
+ *     - memory_begin_operation() per request, so --op-memory-limit caps each request
+ *     - the Barrett contexts of its last few divisors (see modctx.c), so repeated / and % by one divisor skip
+ *       the reciprocal
+ *  --profile, --tune and --out-of-core are not served. SIGINT / SIGTERM remove the socket and stop the server.
+ *
+ *  Returns:
+ *     SUCCESS (0) when the server stops or the client has printed every response
+ *     FAILURE (-1) if the socket cannot be set up or the connection fails
+*******************************************************************************************************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <signal.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <poll.h>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include "apc.h"
+
+/* Connections waiting in listen() to be accepted */
+#define SERVE_BACKLOG 128
+
+/* Largest request accepted, in bytes */
+#define SERVE_MAX_REQUEST (256 << 20)
+
+/* Read size of a connection */
+#define SERVE_READ_CHUNK 65536
+
+static volatile sig_atomic_t stopping;
+
+static void on_signal(int signum)
+{
+	stopping = 1;
+}
+
+/* Growable byte buffer of a connection */
+typedef struct
+{
+	char *data;
+	size_t length, size;
+}Buffer;
+
+/* A client connection: owned by the poller while it waits for input, by one worker while it is answered */
+typedef struct connection
+{
+	int fd;
+	Buffer in, out;             // requests read so far (from a request boundary), responses being built
+	NodeArena *arena;           // list nodes of its requests, released on close
+	int closing;                // end of stream read: answer what is buffered, then close
+	struct connection *next;    // in the ready or the returned list
+}Connection;
+
+static struct
+{
+	Connection *ready, **ready_tail;    // a complete request is buffered: waiting for a worker
+	Connection *returned;               // answered: back to the poller
+	int wake[2];                        // pipe written when a connection is returned
+	pthread_mutex_t lock;
+	pthread_cond_t not_empty;
+}queue = { .ready_tail = &queue.ready, .wake = { -1, -1 }, .lock = PTHREAD_MUTEX_INITIALIZER, .not_empty = PTHREAD_COND_INITIALIZER };
+
+static int buffer_reserve(Buffer *b, size_t extra)
+{
+	if(b->length + extra <= b->size)
+	{
+		return SUCCESS;
+	}
+	size_t size = b->size ? b->size : SERVE_READ_CHUNK;
+	while(size < b->length + extra)
+	{
+		size *= 2;
+	}
+	char *data = apc_realloc(b->data, size);
+	if(data == NULL)
+	{
+		return FAILURE;
+	}
+	b->data = data;
+	b->size = size;
+	return SUCCESS;
+}
+
+static void put_length(char *p, uint32_t n)
+{
+	p[0] = n >> 24;
+	p[1] = n >> 16;
+	p[2] = n >> 8;
+	p[3] = n;
+}
+
+static uint32_t get_length(const char *p)
+{
+	const unsigned char *u = (const unsigned char *)p;
+	return (uint32_t)u[0] << 24 | (uint32_t)u[1] << 16 | (uint32_t)u[2] << 8 | u[3];
+}
+
+/* Write all of data, retrying short writes */
+static int write_all(int fd, const char *data, size_t length)
+{
+	while(length > 0)
+	{
+		ssize_t n = write(fd, data, length);
+		if(n < 0 && errno == EINTR)
+		{
+			continue;
+		}
+		if(n <= 0)
+		{
+			return FAILURE;
+		}
+		data += n;
+		length -= n;
+	}
+	return SUCCESS;
+}
+
+/* Read exactly length bytes (FAILURE on end of stream) */
+static int read_all(int fd, char *data, size_t length)
+{
+	while(length > 0)
+	{
+		ssize_t n = read(fd, data, length);
+		if(n < 0 && errno == EINTR)
+		{
+			continue;
+		}
+		if(n <= 0)
+		{
+			return FAILURE;
+		}
+		data += n;
+		length -= n;
+	}
+	return SUCCESS;
+}
+
+
+/* ------------------> Running one request <------------------- */
+
+/*****************************************************************************************
+ * Function: evaluate
+ * ------------------
+ * Runs one request the way main() runs a command line, without the operand echo and
+ * banners: only what the operation handlers print (the result or the errors) is output.
+ *****************************************************************************************/
+
+static int evaluate(int argc, char *argv[])
+{
+	int precision = DECIMAL_DEFAULT_PRECISION, fixed_precision = 0, rounding = ROUND_HALF_EVEN;
+	while(argc > 2 && (strcmp(argv[1], "--precision") == 0 || strcmp(argv[1], "--rounding") == 0))
+	{
+		if(strcmp(argv[1], "--precision") == 0)
+		{
+			precision = atoi(argv[2]);
+			fixed_precision = 1;
+			if(precision < 0)
+			{
+				apc_printf("ERROR : Precision must not be negative!\n");
+				return FAILURE;
+			}
+		}
+		else if((rounding = rounding_mode(argv[2])) == FAILURE)
+		{
+			apc_printf("ERROR : Unknown rounding mode %s\n", argv[2]);
+			return FAILURE;
+		}
+		argv[2] = argv[0];
+		argv += 2;
+		argc -= 2;
+	}
+
+	if(validate_arguments(argc, argv) == FAILURE)
+	{
+		return FAILURE;
+	}
+
+	// Operands are argv[1] and argv[3...]; argv[2] is the operator
+	int arity = operator_arity(argv[2]), count = argc - 2;
+	int status = FAILURE;
+
+	// Exact rational and fixed-point decimal operands
+	if(argc == 4 && (is_rational(argv[1]) || is_rational(argv[3])))
+	{
+		Rational r1, r2;
+		if(string_to_rational(argv[1], &r1) == FAILURE)
+			return FAILURE;
+		if(string_to_rational(argv[3], &r2) == SUCCESS)
+		{
+			status = perform_rational_operation(argv[2], &r1, &r2);
+			rational_free(&r2);
+		}
+		rational_free(&r1);
+		return status;
+	}
+	if(argc == 4 && (fixed_precision || is_decimal(argv[1]) || is_decimal(argv[3])))
+	{
+		Decimal d1, d2;
+		if(string_to_decimal(argv[1], &d1) == FAILURE)
+			return FAILURE;
+		if(string_to_decimal(argv[3], &d2) == SUCCESS)
+		{
+			status = perform_decimal_operation(argv[2], &d1, &d2, precision, fixed_precision, rounding);
+			decimal_free(&d2);
+		}
+		decimal_free(&d1);
+		return status;
+	}
+
+	// Small integers need no lists (small.c)
+	if(argc == 4 && arity == 2)
+	{
+		const char *digits1, *digits2;
+		char sign1 = remove_sign(argv[1], &digits1), sign2 = remove_sign(argv[3], &digits2);
+		if(small_operation(argv[2], sign1, digits1, sign2, digits2, 0) == SUCCESS)
+		{
+			return SUCCESS;
+		}
+	}
+
+	// Integer operands; the result list is kept in the last slot so everything is freed together
+	Dlist *headR = NULL, *tailR = NULL;
+	Dlist **heads = apc_calloc(count + 1, sizeof(Dlist *)), **tails = apc_calloc(count + 1, sizeof(Dlist *));
+	char *signs = apc_malloc(count + 1);
+	const char **digits = apc_calloc(count + 1, sizeof(char *));
+	if(heads == NULL || tails == NULL || signs == NULL || digits == NULL)
+	{
+		goto done;
+	}
+	// Operands with the same digits share one list (share.c)
+	for(int i = 0; i < count; i++)
+	{
+		signs[i] = remove_sign(argv[(i == 0) ? 1 : i + 2], &digits[i]);
+		if(operand_list(heads, tails, digits, i) == FAILURE)
+		{
+			goto done;
+		}
+	}
+
+	if(arity == ARITY_LIST)
+	{
+		status = perform_list_operation(argv[2], count, signs, heads, &headR);
+	}
+	else if(arity == 1)
+	{
+		status = perform_unary_operation(argv[2], signs[0], &heads[0], &tails[0], &headR, &tailR);
+	}
+	else if(arity == 3)
+	{
+		status = perform_fused_operation(argv[2], signs[0], signs[1], signs[2], &heads[0], &tails[0],
+		                                 &heads[1], &tails[1], &heads[2], &tails[2]);
+	}
+	else
+	{
+		status = perform_operation(argv[2], signs[0], signs[1], &heads[0], &tails[0], &heads[1], &tails[1],
+		                           &headR, &tailR, digits[0], digits[1]);
+	}
+
+done:
+	if(heads)
+	{
+		heads[count] = headR;
+		free_lists(heads, count + 1);
+	}
+	apc_free(heads);
+	apc_free(tails);
+	apc_free(signs);
+	apc_free(digits);
+	return status;
+}
+
+/* Run the request in payload[0..length) and append its response frame to out */
+static int answer(char *payload, uint32_t length, Buffer *out)
+{
+	char *text = NULL;
+	size_t text_length = 0;
+	int status = FAILURE;
+
+	FILE *stream = open_memstream(&text, &text_length);
+	if(stream == NULL)
+	{
+		return FAILURE;
+	}
+	apc_output = stream;
+	memory_begin_operation();
+
+	// Arguments: '\0'-terminated strings; argv[0] is the program name as in main()
+	int argc = 1;
+	for(uint32_t i = 0; i < length; i++)
+	{
+		argc += (payload[i] == '\0');
+	}
+	char **argv = (length > 0 && payload[length - 1] == '\0') ? apc_calloc(argc + 1, sizeof(char *)) : NULL;
+	if(argv != NULL)
+	{
+		argv[0] = "apc";
+		for(uint32_t i = 0, arg = 1; i < length; arg++)
+		{
+			argv[arg] = payload + i;
+			i += strlen(payload + i) + 1;
+		}
+		status = evaluate(argc, argv);
+		apc_free(argv);
+	}
+	else
+	{
+		apc_printf("ERROR : Malformed request\n");
+	}
+
+	apc_output = NULL;
+	fclose(stream);
+
+	uint32_t response = 1 + text_length;
+	if(buffer_reserve(out, 4 + response) == SUCCESS)
+	{
+		put_length(out->data + out->length, response);
+		out->data[out->length + 4] = (status == SUCCESS) ? 0 : 1;
+		memcpy(out->data + out->length + 5, text, text_length);
+		out->length += 4 + response;
+		status = SUCCESS;
+	}
+	else
+	{
+		status = FAILURE;
+	}
+	free(text);
+	return status;
+}
+
+/* 1 if `in` starts with a complete request */
+static int request_buffered(const Buffer *in)
+{
+	return in->length >= 4 && in->length - 4 >= get_length(in->data);
+}
+
+static void connection_close(Connection *c)
+{
+	arena_destroy(c->arena);
+	apc_free(c->in.data);
+	apc_free(c->out.data);
+	close(c->fd);
+	apc_free(c);
+}
+
+/*
+ * Reads what the client has sent (one read: the poller saw the socket readable).
+ * FAILURE if the connection is broken or announces a request over SERVE_MAX_REQUEST.
+ */
+static int connection_read(Connection *c)
+{
+	if(buffer_reserve(&c->in, SERVE_READ_CHUNK) == FAILURE)
+	{
+		return FAILURE;
+	}
+	ssize_t n = read(c->fd, c->in.data + c->in.length, c->in.size - c->in.length);
+	if(n < 0)
+	{
+		return (errno == EINTR || errno == EAGAIN) ? SUCCESS : FAILURE;
+	}
+	if(n == 0)
+	{
+		c->closing = 1;
+	}
+	c->in.length += n;
+	return (c->in.length >= 4 && get_length(c->in.data) > SERVE_MAX_REQUEST) ? FAILURE : SUCCESS;
+}
+
+/* Answer every complete request buffered on c, in order, and write the responses with one write */
+static int serve_requests(Connection *c)
+{
+	size_t pos = 0;
+	int status = SUCCESS;
+
+	arena_use(c->arena);
+	while(status == SUCCESS && c->in.length - pos >= 4 && c->in.length - pos - 4 >= get_length(c->in.data + pos))
+	{
+		uint32_t length = get_length(c->in.data + pos);
+		status = answer(c->in.data + pos + 4, length, &c->out);
+		pos += 4 + length;
+	}
+	arena_use(NULL);
+
+	if(status == SUCCESS && c->out.length)
+	{
+		status = write_all(c->fd, c->out.data, c->out.length);
+	}
+	c->out.length = 0;
+
+	// Keep a partial request at the front for the poller to complete
+	memmove(c->in.data, c->in.data + pos, c->in.length - pos);
+	c->in.length -= pos;
+	return status;
+}
+
+static void *worker(void *unused)
+{
+	// Clients tend to reduce many dividends by the same few divisors
+	modctx_cache_enable();
+	for(;;)
+	{
+		pthread_mutex_lock(&queue.lock);
+		while(queue.ready == NULL)
+		{
+			pthread_cond_wait(&queue.not_empty, &queue.lock);
+		}
+		Connection *c = queue.ready;
+		if((queue.ready = c->next) == NULL)
+		{
+			queue.ready_tail = &queue.ready;
+		}
+		pthread_mutex_unlock(&queue.lock);
+
+		if(serve_requests(c) == FAILURE || c->closing)
+		{
+			connection_close(c);
+			continue;
+		}
+
+		// Back to the poller, which waits for its next request
+		pthread_mutex_lock(&queue.lock);
+		c->next = queue.returned;
+		queue.returned = c;
+		pthread_mutex_unlock(&queue.lock);
+		while(write(queue.wake[1], "", 1) < 0 && errno == EINTR);
+	}
+	return NULL;
+}
+
+/* Hand c to the workers */
+static void dispatch(Connection *c)
+{
+	pthread_mutex_lock(&queue.lock);
+	c->next = NULL;
+	*queue.ready_tail = c;
+	queue.ready_tail = &c->next;
+	pthread_cond_signal(&queue.not_empty);
+	pthread_mutex_unlock(&queue.lock);
+}
+
+/* Unix socket address for path (FAILURE if the path is too long) */
+static int socket_address(const char *path, struct sockaddr_un *addr)
+{
+	memset(addr, 0, sizeof(*addr));
+	addr->sun_family = AF_UNIX;
+	if(strlen(path) >= sizeof(addr->sun_path))
+	{
+		printf("ERROR : Socket path too long: %s\n", path);
+		return FAILURE;
+	}
+	strcpy(addr->sun_path, path);
+	return SUCCESS;
+}
+
+/*****************************************************************************************
+ * Function: serve
+ * ---------------
+ * Listens on the Unix socket `path` and answers requests with `threads` workers
+ * (0: one per CPU) until SIGINT or SIGTERM.
+ *****************************************************************************************/
+
+int serve(const char *path, int threads)
+{
+	struct sockaddr_un addr;
+	if(socket_address(path, &addr) == FAILURE)
+	{
+		return FAILURE;
+	}
+	if(threads <= 0)
+	{
+		long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+		threads = (cpus > 0) ? cpus : 1;
+	}
+
+	// Shared state is set up before any worker runs: thresholds are read once, profiling is off
+	load_thresholds(NULL);
+	apc_profile_enabled = 0;
+
+	int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+	unlink(path);
+	if(listener < 0 || bind(listener, (struct sockaddr *)&addr, sizeof(addr)) < 0 || listen(listener, SERVE_BACKLOG) < 0)
+	{
+		printf("ERROR : Cannot listen on %s: %s\n", path, strerror(errno));
+		if(listener >= 0)
+			close(listener);
+		return FAILURE;
+	}
+	if(pipe(queue.wake) < 0)
+	{
+		printf("ERROR : Cannot create the worker pipe: %s\n", strerror(errno));
+		close(listener);
+		unlink(path);
+		return FAILURE;
+	}
+	// A worker never blocks on a full pipe: the poller is awake then anyway
+	fcntl(queue.wake[0], F_SETFL, O_NONBLOCK);
+	fcntl(queue.wake[1], F_SETFL, O_NONBLOCK);
+
+	struct sigaction action;
+	memset(&action, 0, sizeof(action));
+	action.sa_handler = on_signal;              // no SA_RESTART: poll() returns on the signal
+	sigaction(SIGINT, &action, NULL);
+	sigaction(SIGTERM, &action, NULL);
+	signal(SIGPIPE, SIG_IGN);
+
+	// Workers block SIGINT / SIGTERM, so the signal reaches the polling thread
+	sigset_t block, old;
+	sigemptyset(&block);
+	sigaddset(&block, SIGINT);
+	sigaddset(&block, SIGTERM);
+	pthread_sigmask(SIG_BLOCK, &block, &old);
+	for(int i = 0; i < threads; i++)
+	{
+		pthread_t thread;
+		if(pthread_create(&thread, NULL, worker, NULL) != 0)
+		{
+			printf("ERROR : Cannot start worker %d\n", i + 1);
+			break;
+		}
+		pthread_detach(thread);
+	}
+	pthread_sigmask(SIG_SETMASK, &old, NULL);
+	printf("Serving on %s with %d threads\n", path, threads);
+	fflush(stdout);
+
+	// Connections waiting for their next request; poll entry i + 2 is waiting[i]
+	Connection **waiting = NULL;
+	struct pollfd *polled = NULL;
+	int count = 0, size = 0;
+
+	while(!stopping)
+	{
+		// Answered connections rejoin the poll set
+		pthread_mutex_lock(&queue.lock);
+		Connection *back = queue.returned;
+		queue.returned = NULL;
+		pthread_mutex_unlock(&queue.lock);
+		char drain[256];
+		while(read(queue.wake[0], drain, sizeof(drain)) > 0);
+
+		for(Connection *c = back, *next; c != NULL; c = next)
+		{
+			next = c->next;
+			if(count == size)
+			{
+				int grown = size ? 2 * size : 64;
+				Connection **w = apc_realloc(waiting, grown * sizeof(Connection *));
+				if(w != NULL)
+					waiting = w;
+				struct pollfd *p = apc_realloc(polled, (grown + 2) * sizeof(struct pollfd));
+				if(p != NULL)
+					polled = p;
+				if(w == NULL || p == NULL)
+				{
+					connection_close(c);
+					continue;
+				}
+				size = grown;
+			}
+			waiting[count++] = c;
+		}
+
+		if(polled == NULL && (polled = apc_calloc(2, sizeof(struct pollfd))) == NULL)
+		{
+			printf("ERROR : Out of memory\n");
+			break;
+		}
+		polled[0] = (struct pollfd){ .fd = listener, .events = POLLIN };
+		polled[1] = (struct pollfd){ .fd = queue.wake[0], .events = POLLIN };
+		for(int i = 0; i < count; i++)
+		{
+			polled[i + 2] = (struct pollfd){ .fd = waiting[i]->fd, .events = POLLIN };
+		}
+		if(poll(polled, count + 2, -1) < 0)
+		{
+			continue;
+		}
+
+		// Read what arrived; a connection with a complete request goes to a worker
+		int kept = 0;
+		for(int i = 0; i < count; i++)
+		{
+			Connection *c = waiting[i];
+			if(polled[i + 2].revents == 0)
+			{
+				waiting[kept++] = c;
+			}
+			else if(connection_read(c) == FAILURE)
+			{
+				connection_close(c);
+			}
+			else if(request_buffered(&c->in))
+			{
+				dispatch(c);
+			}
+			else if(c->closing)
+			{
+				connection_close(c);
+			}
+			else
+			{
+				waiting[kept++] = c;
+			}
+		}
+		count = kept;
+
+		// A new connection waits for its first request like any other
+		if(polled[0].revents & POLLIN)
+		{
+			int fd = accept(listener, NULL, NULL);
+			Connection *c = (fd >= 0) ? apc_calloc(1, sizeof(Connection)) : NULL;
+			if(c != NULL && (c->arena = arena_create()) != NULL)
+			{
+				c->fd = fd;
+				pthread_mutex_lock(&queue.lock);
+				c->next = queue.returned;
+				queue.returned = c;
+				pthread_mutex_unlock(&queue.lock);
+			}
+			else if(fd >= 0)
+			{
+				apc_free(c);
+				close(fd);
+			}
+		}
+	}
+
+	for(int i = 0; i < count; i++)
+	{
+		connection_close(waiting[i]);
+	}
+	apc_free(waiting);
+	apc_free(polled);
+	close(listener);
+	unlink(path);
+	return SUCCESS;
+}
+
+
+/* ------------------> Client stub <------------------- */
+
+/* One request frame from arguments */
+static int put_request(Buffer *b, int argc, char *argv[])
+{
+	size_t length = 0;
+	for(int i = 0; i < argc; i++)
+	{
+		length += strlen(argv[i]) + 1;
+	}
+	if(buffer_reserve(b, 4 + length) == FAILURE)
+	{
+		return FAILURE;
+	}
+	put_length(b->data + b->length, length);
+	b->length += 4;
+	for(int i = 0; i < argc; i++)
+	{
+		size_t n = strlen(argv[i]) + 1;
+		memcpy(b->data + b->length, argv[i], n);
+		b->length += n;
+	}
+	return SUCCESS;
+}
+
+/* Requests of stdin, one per line with whitespace-separated arguments */
+static int read_requests(Buffer *b, int *count)
+{
+	char line[65536];
+	while(fgets(line, sizeof(line), stdin))
+	{
+		char *args[256];
+		int argc = 0;
+		for(char *arg = strtok(line, " \t\r\n"); arg && argc < 256; arg = strtok(NULL, " \t\r\n"))
+		{
+			args[argc++] = arg;
+		}
+		if(argc == 0)
+		{
+			continue;
+		}
+		if(put_request(b, argc, args) == FAILURE)
+		{
+			return FAILURE;
+		}
+		(*count)++;
+	}
+	return SUCCESS;
+}
+
+typedef struct
+{
+	int fd;
+	Buffer *requests;
+	int status;
+}Sender;
+
+static void *send_requests(void *arg)
+{
+	Sender *sender = arg;
+	sender->status = write_all(sender->fd, sender->requests->data, sender->requests->length);
+	shutdown(sender->fd, SHUT_WR);
+	return NULL;
+}
+
+/*****************************************************************************************
+ * Function: serve_client
+ * ----------------------
+ * Sends the request given by argv (or, for a single "-", every line of stdin) to the
+ * server at `path` and prints each response text. All requests are written by a second
+ * thread while the responses are read, so a long pipeline cannot deadlock.
+ *****************************************************************************************/
+
+int serve_client(const char *path, int argc, char *argv[])
+{
+	struct sockaddr_un addr;
+	if(socket_address(path, &addr) == FAILURE)
+	{
+		return FAILURE;
+	}
+
+	int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+	if(fd < 0 || connect(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0)
+	{
+		printf("ERROR : Cannot connect to %s: %s\n", path, strerror(errno));
+		if(fd >= 0)
+			close(fd);
+		return FAILURE;
+	}
+
+	// Connected first: while stdin is quiet the connection waits on the server's poller
+	Buffer requests = { NULL, 0, 0 };
+	int count = 0, status = FAILURE;
+	if(argc == 1 && strcmp(argv[0], "-") == 0)
+	{
+		status = read_requests(&requests, &count);
+	}
+	else if((status = put_request(&requests, argc, argv)) == SUCCESS)
+	{
+		count = 1;
+	}
+	if(status == FAILURE)
+	{
+		close(fd);
+		apc_free(requests.data);
+		return FAILURE;
+	}
+
+	Sender sender = { fd, &requests, SUCCESS };
+	pthread_t thread;
+	signal(SIGPIPE, SIG_IGN);
+	if(pthread_create(&thread, NULL, send_requests, &sender) != 0)
+	{
+		close(fd);
+		apc_free(requests.data);
+		return FAILURE;
+	}
+
+	Buffer response = { NULL, 0, 0 };
+	char header[4];
+	status = SUCCESS;
+	for(int i = 0; i < count && status == SUCCESS; i++)
+	{
+		uint32_t length;
+		if(read_all(fd, header, 4) == FAILURE || (length = get_length(header)) == 0 ||
+		   buffer_reserve(&response, length) == FAILURE || read_all(fd, response.data, length) == FAILURE)
+		{
+			printf("ERROR : Connection closed after %d of %d responses\n", i, count);
+			status = FAILURE;
+			break;
+		}
+		fwrite(response.data + 1, 1, length - 1, stdout);
+	}
+
+	pthread_join(thread, NULL);
+	close(fd);
+	apc_free(requests.data);
+	apc_free(response.data);
+	return (status == SUCCESS) ? sender.status : FAILURE;
+}
@@ -0,0 +1,142 @@
+/*******************************************************************************************************************************************************************
+ * Shared operand lists
+ * --------------------
+ *  Operands are read-only to the kernels: addition, subtraction, multiplication, square, division and modulus
+ *  only read their input lists and build the result in a new one. So one list can stand for several operands
+ *  (./a.out X * X, X % X, prod X X X) without being copied: list_share hands out another reference, and each
+ *  holder gives its reference back with list_release, the last one deleting the list.
+ *
+ *  The reference counts live in a small per-thread table keyed by the head node (SHARE_SLOTS entries; a list
+ *  that is not in the table has exactly one holder), so the Dlist nodes stay as they are and every existing
+ *  kernel keeps its signature. While a list is shared its head must not change and no digit may be written:
+ *  the few places that update an operand in place (the accumulator of addmul / submul / powmod, nextprime of a
+ *  negative number, trimming leading zeros) call list_writable first, which copies a shared list and leaves
+ *  the caller with a private one (copy-on-write).
+ *
+ *  Returns:
+ *     list_share    : head, or NULL if the table is full (the caller then builds its own list)
+ *     list_writable : SUCCESS, FAILURE if the copy cannot be allocated
+*******************************************************************************************************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "apc.h"
+
+/* Lists of one thread that can be shared at the same time */
+#define SHARE_SLOTS 16
+
+static __thread Dlist *shared_head[SHARE_SLOTS];
+static __thread int shared_refs[SHARE_SLOTS];       // holders of shared_head[i], at least 2
+static __thread int shared_count;                    // slots in use
+
+/* Slot of head, or -1 when the list has a single holder */
+static int share_slot(Dlist *head)
+{
+	for(int i = 0; i < SHARE_SLOTS && shared_count > 0; i++)
+	{
+		if(shared_refs[i] && shared_head[i] == head)
+		{
+			return i;
+		}
+	}
+	return -1;
+}
+
+/* Drop one reference of slot i; the entry goes away once a single holder is left */
+static void share_drop(int i)
+{
+	if(--shared_refs[i] == 1)
+	{
+		shared_refs[i] = 0;
+		shared_head[i] = NULL;
+		shared_count--;
+	}
+}
+
+Dlist *list_share(Dlist *head)
+{
+	if(head == NULL)
+	{
+		return NULL;
+	}
+	int i = share_slot(head);
+	if(i >= 0)
+	{
+		shared_refs[i]++;
+		return head;
+	}
+	for(i = 0; i < SHARE_SLOTS; i++)
+	{
+		if(shared_refs[i] == 0)
+		{
+			shared_head[i] = head;
+			shared_refs[i] = 2;
+			shared_count++;
+			return head;
+		}
+	}
+	return NULL;
+}
+
+int list_shared(Dlist *head)
+{
+	return share_slot(head) >= 0;
+}
+
+void list_release(Dlist **head, Dlist **tail)
+{
+	int i = share_slot(*head);
+	if(i < 0)
+	{
+		delete_list(head, tail);
+		return;
+	}
+	share_drop(i);
+	*head = NULL;
+	*tail = NULL;
+}
+
+int list_writable(Dlist **head, Dlist **tail)
+{
+	int i = share_slot(*head);
+	if(i < 0)
+	{
+		return SUCCESS;
+	}
+	Dlist *copy = NULL, *copy_tail = NULL;
+	if(copy_list(*head, &copy, &copy_tail) == FAILURE)
+	{
+		return FAILURE;
+	}
+	share_drop(i);
+	*head = copy;
+	*tail = copy_tail;
+	return SUCCESS;
+}
+
+/*****************************************************************************************
+ * Function: operand_list
+ * ----------------------
+ * heads[i] / tails[i] for the digit string digits[i], without leading zeros: a new
+ * reference to an earlier heads[j] with the same digits when there is one, otherwise a
+ * list of its own.
+ *****************************************************************************************/
+
+int operand_list(Dlist **heads, Dlist **tails, const char **digits, int i)
+{
+	for(int j = 0; j < i; j++)
+	{
+		if(strcmp(digits[j], digits[i]) == 0 && (heads[i] = list_share(heads[j])) != NULL)
+		{
+			tails[i] = tails[j];
+			return SUCCESS;
+		}
+	}
+	if(string_to_list(&heads[i], &tails[i], (char *)digits[i]) == FAILURE)
+	{
+		return FAILURE;
+	}
+	remove_leading_zeros(&heads[i]);
+	return SUCCESS;
+}
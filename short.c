@@ -0,0 +1,483 @@
+/*******************************************************************************************************************************************************************
+ * Short products: the last or the leading k digits of A × B and A^2
+ * ------------------------------------------------------------------
+ *  A checksum or a "mod 10^k" only needs the low k digits of a product, a magnitude report only the leading k;
+ *  multiplication() and square() would compute all len1 + len2 digits and throw most of them away.
+ *
+ *     mul_low  / sqr_low  : A × B mod 10^k. Only the last k digits of each operand matter, and only the columns
+ *                           below k: the pairs a[i]·b[j] with i + j < k. Carries out of column k-1 are dropped.
+ *     mul_high / sqr_high : the leading k digits of A × B, and the number of digits of the whole product.
+ *                           Read from the head, the digits of A and B are the coefficients of the reversed
+ *                           numbers, and the top m columns of A × B are the low m columns of rev(A) × rev(B):
+ *                           the same low product again, on the first m = k + guard digits of each operand.
+ *
+ *  The low product of two n-coefficient polynomials (poly_mul_low) is Mulders' short product: a full product
+ *  of the low h = 0.7·n coefficients, plus the two cross terms a_hi × b_lo and a_lo × b_hi, which are again
+ *  short products of n - h coefficients (one, doubled, when squaring); below the Karatsuba threshold of the
+ *  kernel registry it is the schoolbook triangle i + j < n. That is half the work of a full product in the
+ *  schoolbook range and about three quarters of it in the Karatsuba range.
+ *
+ *  The columns below the top m are left out of the high product, so it is a lower bound: if Q is the number
+ *  made of the top m columns (with their carries) and L = len1 + len2 - 1 - m, then each dropped column is at
+ *  most 81·min(len1, len2) and
+ *
+ *     Q  <=  floor(A × B / 10^L)  <  Q + 9·min(len1, len2)
+ *
+ *  The leading k digits of Q are the answer when adding that slack to Q does not carry into them. The guard
+ *  starts two digits above the slack and doubles when the check fails (a run of 9s at digit k); once it would
+ *  cover every column the whole product is computed instead.
+ *
+ *  Returns:
+ *     SUCCESS (0), or FAILURE (-1) on empty input or allocation failure
+*******************************************************************************************************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "apc.h"
+
+/* Smallest short product split into a full product and two cross terms, whatever the tuned threshold says */
+#define SHORT_MIN_SPLIT 8
+
+/* Share of the coefficients that goes to the full product of a split (tenths) */
+#define SHORT_FULL_TENTHS 7
+
+/* Low n coefficients, schoolbook: only the pairs i + j < n (b == a squares, each cross pair once) */
+static void poly_low_basecase(const long long *a, const long long *b, int n, long long *out)
+{
+	memset(out, 0, n * sizeof(long long));
+	if(a == b)
+	{
+		for(int i = 0; i < n; i++)
+		{
+			if(a[i] == 0)
+				continue;
+			for(int j = i + 1; j < n - i; j++)
+			{
+				out[i + j] += a[i] * a[j];
+			}
+		}
+		for(int k = 0; k < n; k++)
+		{
+			out[k] *= 2;
+		}
+		for(int i = 0; 2 * i < n; i++)
+		{
+			out[2 * i] += a[i] * a[i];
+		}
+		return;
+	}
+	for(int i = 0; i < n; i++)
+	{
+		if(a[i] == 0)
+			continue;
+		for(int j = 0; j < n - i; j++)
+		{
+			out[i + j] += a[i] * b[j];
+		}
+	}
+}
+
+/*
+ * out[0 .. n-1] = the n low coefficients of a × b for two n-coefficient polynomials (b == a squares).
+ * Returns SUCCESS, or FAILURE on allocation failure.
+ */
+static int poly_mul_low(const long long *a, const long long *b, int n, long long *out, int cutoff)
+{
+	if(n < cutoff || n < SHORT_MIN_SPLIT)
+	{
+		poly_low_basecase(a, b, n, out);
+		return SUCCESS;
+	}
+
+	int h = (n * SHORT_FULL_TENTHS + 9) / 10;     // full product a_lo × b_lo, 2h-1 >= n columns
+	int l = n - h;                                // cross terms: i >= h forces j < l, and the other way round
+
+	long long *buffer = apc_malloc((2 * h - 1 + 2 * l) * sizeof(long long));
+	if(buffer == NULL)
+	{
+		return FAILURE;
+	}
+	PROFILE_ALLOC((2 * h - 1 + 2 * l) * sizeof(long long));
+	long long *full = buffer;
+	long long *cross = buffer + 2 * h - 1;
+	long long *cross2 = cross + l;
+
+	int squaring = (a == b);
+	if(poly_mul(a, h, b, h, full, cutoff) == FAILURE ||
+	   poly_mul_low(a + h, b, l, cross, cutoff) == FAILURE ||
+	   (!squaring && poly_mul_low(a, b + h, l, cross2, cutoff) == FAILURE))
+	{
+		apc_free(buffer);
+		return FAILURE;
+	}
+
+	memcpy(out, full, n * sizeof(long long));
+	for(int i = 0; i < l; i++)
+	{
+		out[h + i] += squaring ? 2 * cross[i] : cross[i] + cross2[i];
+	}
+
+	apc_free(buffer);
+	return SUCCESS;
+}
+
+/*
+ * out[0 .. m-1] = the m low coefficients of a × b, la and lb at most m (b == a with la == lb squares).
+ * When every column is wanted, or the shorter operand would be mostly padding, it is one full product.
+ */
+static int short_low(const long long *a, int la, const long long *b, int lb, int m, long long *out, int cutoff)
+{
+	int columns = la + lb - 1;
+	int shorter = (la < lb) ? la : lb;
+	int squaring = (a == b && la == lb);
+
+	memset(out, 0, m * sizeof(long long));
+	if(columns <= m || 2 * shorter <= m)
+	{
+		long long *full = apc_malloc(columns * sizeof(long long));
+		if(full == NULL)
+		{
+			return FAILURE;
+		}
+		PROFILE_ALLOC(columns * sizeof(long long));
+		int status = poly_mul(a, la, b, lb, full, cutoff);
+		if(status == SUCCESS)
+		{
+			memcpy(out, full, ((columns < m) ? columns : m) * sizeof(long long));
+		}
+		apc_free(full);
+		return status;
+	}
+
+	long long *padded = apc_calloc(2 * m, sizeof(long long));
+	if(padded == NULL)
+	{
+		return FAILURE;
+	}
+	PROFILE_ALLOC(2 * m * sizeof(long long));
+	long long *pa = padded;
+	long long *pb = squaring ? pa : padded + m;
+	memcpy(pa, a, la * sizeof(long long));
+	if(!squaring)
+		memcpy(pb, b, lb * sizeof(long long));
+
+	int status = poly_mul_low(pa, pb, m, out, cutoff);
+	apc_free(padded);
+	return status;
+}
+
+/* Coefficients of the last count digits (from the tail: least significant first) or the first count (from the head) */
+static long long *digit_coeffs(Dlist *node, int count, int from_head)
+{
+	long long *coeffs = apc_malloc(count * sizeof(long long));
+	if(coeffs == NULL)
+	{
+		return NULL;
+	}
+	PROFILE_ALLOC(count * sizeof(long long));
+	for(int i = 0; i < count; i++)
+	{
+		coeffs[i] = node->data;
+		node = from_head ? node->next : node->prev;
+	}
+	return coeffs;
+}
+
+/* Keep the first k digits of a list */
+static void keep_leading(Dlist *head, Dlist **tail, int k)
+{
+	for(int i = 1; i < k && head->next; i++)
+	{
+		head = head->next;
+	}
+	Dlist *rest = head->next;
+	if(rest)
+	{
+		head->next = NULL;
+		rest->prev = NULL;
+		delete_list(&rest, tail);
+		*tail = head;
+	}
+}
+
+/* 1 when adding slack to the number ending at tail leaves everything above its last count digits unchanged */
+static int leading_stable(Dlist *tail, int count, long long slack)
+{
+	long long carry = slack;
+	for(int i = 0; i < count && carry != 0; i++, tail = tail->prev)
+	{
+		carry = (tail->data + carry) / 10;
+	}
+	return carry == 0;
+}
+
+/* Shared low driver: squares when the second operand is NULL */
+static int low_product(Dlist *tail1, int len1, Dlist *tail2, int len2, int k, Dlist **headR, const char *family)
+{
+	int squaring = (tail2 == NULL);
+	int la = (len1 < k) ? len1 : k;
+	int lb = squaring ? la : ((len2 < k) ? len2 : k);
+	int m = (la + lb - 1 < k) ? la + lb - 1 : k;
+	int cutoff = kernel_threshold(family, "karatsuba");
+
+	long long *a = digit_coeffs(tail1, la, 0);
+	long long *b = squaring ? a : digit_coeffs(tail2, lb, 0);
+	long long *out = apc_malloc(m * sizeof(long long));
+	PROFILE_ALLOC(m * sizeof(long long));
+
+	int status = FAILURE;
+	if(a != NULL && b != NULL && out != NULL && short_low(a, la, b, lb, m, out, cutoff) == SUCCESS)
+	{
+		// One carry pass; what carries out of digit k-1 is not part of the result
+		Dlist *tailR = NULL;
+		long long carry = 0;
+		status = SUCCESS;
+		for(int p = 0; p < k && (p < m || carry != 0) && status == SUCCESS; p++)
+		{
+			long long sum = carry + ((p < m) ? out[p] : 0);
+			status = insert_at_begin(headR, &tailR, sum % 10);
+			carry = sum / 10;
+		}
+		if(status == FAILURE)
+			delete_list(headR, &tailR);
+		else
+			remove_leading_zeros(headR);
+	}
+	if(status == FAILURE)
+		apc_printf("ERROR : Failed to allocate the short product buffers. \n");
+
+	if(b != a)
+		apc_free(b);
+	apc_free(a);
+	apc_free(out);
+	return status;
+}
+
+/* Shared high driver: squares when the second operand is NULL (len2 is then len1) */
+static int high_product(Dlist *head1, Dlist *tail1, int len1, Dlist *head2, Dlist *tail2, int len2, int k, Dlist **headR, long *length, const char *family)
+{
+	int squaring = (head2 == NULL);
+	long columns = (long)len1 + len2 - 1;
+	long long slack = 9LL * ((len1 < len2) ? len1 : len2);
+	int cutoff = kernel_threshold(family, "karatsuba");
+
+	int guard = 2;
+	for(long long s = slack; s > 0; s /= 10)
+	{
+		guard++;
+	}
+
+	for(;;)
+	{
+		Dlist *tailR = NULL;
+
+		// Too few columns left out to pay off: the whole product
+		if((long)k + guard >= columns)
+		{
+			int status = squaring ? square(&head1, &tail1, headR) : multiplication(&head1, &tail1, &head2, &tail2, headR);
+			if(status == FAILURE)
+				return FAILURE;
+			remove_leading_zeros(headR);
+			for(tailR = *headR; tailR->next; tailR = tailR->next)
+				;
+			*length = find_length(*headR);
+			keep_leading(*headR, &tailR, k);
+			return SUCCESS;
+		}
+
+		int m = k + guard;
+		int la = (len1 < m) ? len1 : m;
+		int lb = squaring ? la : ((len2 < m) ? len2 : m);
+		long long *a = digit_coeffs(head1, la, 1);
+		long long *b = squaring ? a : digit_coeffs(head2, lb, 1);
+		long long *out = apc_malloc(m * sizeof(long long));
+		PROFILE_ALLOC(m * sizeof(long long));
+
+		int status = FAILURE;
+		if(a != NULL && b != NULL && out != NULL && short_low(a, la, b, lb, m, out, cutoff) == SUCCESS)
+		{
+			// out[t] is column columns-1-t; least significant first for the carry pass
+			for(int i = 0, j = m - 1; i < j; i++, j--)
+			{
+				long long t = out[i]; out[i] = out[j]; out[j] = t;
+			}
+			status = columns_to_list(out, m, headR, &tailR);
+		}
+		if(b != a)
+			apc_free(b);
+		apc_free(a);
+		apc_free(out);
+		if(status == FAILURE)
+		{
+			apc_printf("ERROR : Failed to allocate the short product buffers. \n");
+			return FAILURE;
+		}
+
+		int digits = find_length(*headR);
+		if(leading_stable(tailR, digits - k, slack - 1))
+		{
+			*length = digits + (columns - m);
+			keep_leading(*headR, &tailR, k);
+			return SUCCESS;
+		}
+		delete_list(headR, &tailR);
+		guard *= 2;
+	}
+}
+
+int mul_low(Dlist **head1, Dlist **tail1, Dlist **head2, Dlist **tail2, int k, Dlist **headR)
+{
+	if(*head1 == NULL || *head2 == NULL || k < 1)
+	{
+		apc_printf("ERROR : One or Both input Lists are Empty! \n");
+		return FAILURE;
+	}
+	return low_product(*tail1, find_length(skip_leading_zeros(*head1)), *tail2, find_length(skip_leading_zeros(*head2)), k, headR, "mul");
+}
+
+int sqr_low(Dlist **head1, Dlist **tail1, int k, Dlist **headR)
+{
+	if(*head1 == NULL || k < 1)
+	{
+		apc_printf("ERROR : Input list is Empty! \n");
+		return FAILURE;
+	}
+	return low_product(*tail1, find_length(skip_leading_zeros(*head1)), NULL, 0, k, headR, "sqr");
+}
+
+int mul_high(Dlist **head1, Dlist **tail1, Dlist **head2, Dlist **tail2, int k, Dlist **headR, long *length)
+{
+	if(*head1 == NULL || *head2 == NULL || k < 1)
+	{
+		apc_printf("ERROR : One or Both input Lists are Empty! \n");
+		return FAILURE;
+	}
+	Dlist *lead1 = skip_leading_zeros(*head1), *lead2 = skip_leading_zeros(*head2);
+	if(result_is_zero(lead1) == SUCCESS || result_is_zero(lead2) == SUCCESS)
+	{
+		Dlist *tailR = NULL;
+		*length = 1;
+		return insert_at_begin(headR, &tailR, 0);
+	}
+	return high_product(lead1, *tail1, find_length(lead1), lead2, *tail2, find_length(lead2), k, headR, length, "mul");
+}
+
+int sqr_high(Dlist **head1, Dlist **tail1, int k, Dlist **headR, long *length)
+{
+	if(*head1 == NULL || k < 1)
+	{
+		apc_printf("ERROR : Input list is Empty! \n");
+		return FAILURE;
+	}
+	Dlist *lead = skip_leading_zeros(*head1);
+	if(result_is_zero(lead) == SUCCESS)
+	{
+		Dlist *tailR = NULL;
+		*length = 1;
+		return insert_at_begin(headR, &tailR, 0);
+	}
+	int len = find_length(lead);
+	return high_product(lead, *tail1, len, NULL, NULL, len, k, headR, length, "sqr");
+}
+
+/*****************************************************************************************
+ * Function: short_product_run
+ * ---------------------------
+ * ./a.out --lastdigits K <num1> <*|^> [<num2>]   → sign and last K digits of the product
+ * ./a.out --firstdigits K <num1> <*|^> [<num2>]  → sign, leading K digits and length
+ * ^ squares num1, as everywhere else; num2 is optional for it. Any other operator, a bad
+ * count or operand is reported and FAILURE returned, as is a failed product.
+ *****************************************************************************************/
+
+int short_product_run(const char *option, const char *count, int argc, char *argv[])
+{
+	int high = (strcmp(option, "--firstdigits") == 0);
+	int k = atoi(count);
+	int squaring = (argc >= 2 && strcmp(argv[1], "^") == 0);
+
+	if(k < 1)
+	{
+		printf("ERROR : Digit count must be positive!\n");
+		return FAILURE;
+	}
+	if(argc >= 2 && !squaring && strcmp(argv[1], "*") != 0)
+	{
+		printf("ERROR : Operator %s is not supported, only * and ^ are supported\n", argv[1]);
+		return FAILURE;
+	}
+	if(!(argc == 3 || (argc == 2 && squaring)))
+	{
+		printf("ERROR : Invalid Number of Arguments!\n");
+		printf("USAGE : ./a.out %s <K> <num1> <*|^> [<num2>]\n", option);
+		return FAILURE;
+	}
+	for(int i = 0; i < argc; i += 2)
+	{
+		if(check_sign(argv[i]) == FAILURE || strpbrk(argv[i], "./") != NULL)
+		{
+			printf("ERROR : Invalid operand %s\n", argv[i]);
+			return FAILURE;
+		}
+	}
+
+	Dlist *head1 = NULL, *tail1 = NULL, *head2 = NULL, *tail2 = NULL, *headR = NULL, *tailR = NULL;
+	const char *digits1, *digits2 = NULL;
+	char sign1 = remove_sign(argv[0], &digits1);
+	char sign2 = (argc == 3) ? remove_sign(argv[2], &digits2) : '+';
+	if(string_to_list(&head1, &tail1, (char *)digits1) == FAILURE ||
+	   (!squaring && string_to_list(&head2, &tail2, (char *)digits2) == FAILURE))
+	{
+		printf("ERROR: Failed to create lists for the operands.\n");
+		delete_list(&head1, &tail1);
+		return FAILURE;
+	}
+	remove_leading_zeros(&head1);
+	if(!squaring)
+		remove_leading_zeros(&head2);
+
+	printf("Operand 1       : %c", sign1);
+	print_list(head1);
+	printf("Operation       : %s (%s %d digits)\n", argv[1], high ? "first" : "last", k);
+	if(!squaring)
+	{
+		printf("Operand 2       : %c", sign2);
+		print_list(head2);
+	}
+	printf("----------------------------------------\n");
+
+	long length = 0;
+	int status;
+	if(high)
+		status = squaring ? sqr_high(&head1, &tail1, k, &headR, &length) : mul_high(&head1, &tail1, &head2, &tail2, k, &headR, &length);
+	else
+		status = squaring ? sqr_low(&head1, &tail1, k, &headR) : mul_low(&head1, &tail1, &head2, &tail2, k, &headR);
+
+	if(status == SUCCESS)
+	{
+		if(result_is_zero(headR) == SUCCESS)
+		{
+			apc_printf("Result          : 0\n");
+		}
+		else
+		{
+			apc_printf("Result          : %c", (squaring || sign1 == sign2) ? '+' : '-');
+			print_list(headR);
+		}
+		if(high)
+			apc_printf("Digits          : %ld\n", length);
+		printf("----------------------------------------\n");
+		printf("APC Calculator Execution Completed.\n");
+	}
+	else if(!memory_exceeded())
+	{
+		printf("ERROR : Short Product Failed! \n");
+	}
+
+	for(tailR = headR; tailR && tailR->next; tailR = tailR->next)
+		;
+	delete_list(&headR, &tailR);
+	delete_list(&head2, &tail2);
+	delete_list(&head1, &tail1);
+	return status;
+}
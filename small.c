@@ -0,0 +1,198 @@
+/*******************************************************************************************************************************************************************
+ * Small-value fast path
+ * ---------------------
+ *  Most requests have operands of a few dozen digits, where building two digit lists, running the list kernels
+ *  and printing node by node costs far more than the arithmetic. Integers of up to SMALL_DIGITS digits are
+ *  held inline as a sign and an unsigned 128-bit magnitude (SMALL_DIGITS = 38 keeps every magnitude below
+ *  10^38 < 2^127, so sums cannot wrap) and computed with native __int128 arithmetic:
+ *
+ *     + -     magnitudes added or subtracted by the effective sign, as perform_operation does
+ *     * ^     product / square, checked with __builtin_mul_overflow
+ *     / %     truncating division, the remainder takes the dividend's sign
+ *     cmp     -1, 0 or 1
+ *
+ *  The output is exactly what perform_operation prints for the same operands (including its "+0" / "-0" for a
+ *  zero sum of like signs). Anything else falls back to the lists: another operator, an operand with more
+ *  digits or with leading zeros, or a product whose magnitude would not fit in 128 bits. Nothing is printed in
+ *  that case, so the caller simply carries on with the lists.
+ *
+ *  perform_operation tries this path first, so every caller gets it (bench, the server, library use). main and
+ *  the server also call it before building any list, which is where most of the saving is. --no-small (or
+ *  APC_NO_SMALL=1) turns the path off, to compare it with the lists; under --profile it shows up as the kernel
+ *  small:int128.
+ *
+ *  Returns:
+ *     SUCCESS (0) if the operation was done here and its output printed
+ *     FAILURE (-1) if the caller must run the list path
+*******************************************************************************************************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "apc.h"
+
+/* Longest operand taken by the fast path */
+#define SMALL_DIGITS 38
+
+int apc_small_enabled = 1;
+
+typedef unsigned __int128 u128;
+
+/* An integer of at most SMALL_DIGITS digits */
+typedef struct
+{
+	char sign;          // '+' or '-' as written (zero may carry either)
+	u128 mag;
+}SmallInt;
+
+/* Turn the fast path off if APC_NO_SMALL is set to a non-zero value */
+void small_init(void)
+{
+	const char *env = getenv("APC_NO_SMALL");
+	if(env && *env && strcmp(env, "0") != 0)
+	{
+		apc_small_enabled = 0;
+	}
+}
+
+/* 1..SMALL_DIGITS digits and no leading zero (a lone 0 is fine) */
+static int small_parse(char sign, const char *digits, SmallInt *x)
+{
+	x->sign = sign;
+	size_t length = strlen(digits);
+	if(length == 0 || length > SMALL_DIGITS || (digits[0] == '0' && length > 1))
+	{
+		return FAILURE;
+	}
+	x->mag = 0;
+	for(size_t i = 0; i < length; i++)
+	{
+		if(digits[i] < '0' || digits[i] > '9')
+		{
+			return FAILURE;
+		}
+		x->mag = x->mag * 10 + (digits[i] - '0');
+	}
+	return SUCCESS;
+}
+
+/* Decimal digits of v into buf (at least 40 bytes) */
+static const char *small_digits(u128 v, char *buf)
+{
+	char *p = buf + 39;
+	*p = '\0';
+	do
+	{
+		*--p = '0' + (int)(v % 10);
+		v /= 10;
+	}while(v);
+	return p;
+}
+
+/* "Result          : ±value", or 0 without a sign when zero_unsigned is set and the value is zero */
+static void print_small(char sign, u128 v, int zero_unsigned)
+{
+	char buf[40];
+	if(v == 0 && zero_unsigned)
+	{
+		apc_printf("Result          : 0\n");
+		PROFILE_RESULT_DIGITS(1);
+		return;
+	}
+	const char *digits = small_digits(v, buf);
+	apc_printf("Result          : %c%s\n", sign, digits);
+	PROFILE_RESULT_DIGITS((long)strlen(digits));
+}
+
+static int compare_small(u128 a, u128 b)
+{
+	return (a > b) ? GREATER : (a < b) ? LESS : EQUAL;
+}
+
+int small_operation(const char *op, char sign1, const char *digits1, char sign2, const char *digits2, int echo)
+{
+	SmallInt a, b;
+	if(!apc_small_enabled || small_parse(sign1, digits1, &a) == FAILURE || small_parse(sign2, digits2, &b) == FAILURE)
+	{
+		return FAILURE;
+	}
+
+	// Settle the result before printing anything, so an overflow can still hand over to the lists
+	char sign = '+';
+	u128 result = 0;
+	int zero_unsigned = 1;
+	const char *message = NULL;
+	int compare = compare_small(a.mag, b.mag);
+
+	if(strcmp(op, "+") == 0 || strcmp(op, "-") == 0)
+	{
+		// Effective addition when the signs agree for +, or differ for -
+		int add = ((a.sign == b.sign) == (strcmp(op, "+") == 0));
+		if(add)
+		{
+			result = a.mag + b.mag;
+			sign = a.sign;
+			zero_unsigned = 0;
+		}
+		else if(compare != EQUAL)
+		{
+			result = (compare == GREATER) ? a.mag - b.mag : b.mag - a.mag;
+			sign = (compare == GREATER) ? a.sign : (a.sign == '+') ? '-' : '+';
+		}
+	}
+	else if(strcmp(op, "*") == 0)
+	{
+		if(__builtin_mul_overflow(a.mag, b.mag, &result))
+			return FAILURE;
+		sign = (a.sign == b.sign) ? '+' : '-';
+	}
+	else if(strcmp(op, "^") == 0)
+	{
+		if(__builtin_mul_overflow(a.mag, a.mag, &result))
+			return FAILURE;
+	}
+	else if(strcmp(op, "/") == 0 || strcmp(op, "%") == 0)
+	{
+		int quotient = (strcmp(op, "/") == 0);
+		if(a.mag != 0 && b.mag == 0)
+		{
+			message = quotient ? "Result          : Cannot divide by Zero!\n" : "Result          : Cannot perform modulus by Zero!\n";
+		}
+		else if(a.mag != 0)
+		{
+			result = quotient ? a.mag / b.mag : a.mag % b.mag;
+			sign = quotient ? ((a.sign == b.sign) ? '+' : '-') : a.sign;
+		}
+	}
+	else if(strcmp(op, "cmp") != 0)
+	{
+		return FAILURE;
+	}
+
+	PROFILE_KERNEL("small", "int128", (long)((strlen(digits1) > strlen(digits2)) ? strlen(digits1) : strlen(digits2)));
+	if(echo)
+	{
+		char buf[40];
+		apc_printf("Operand 1       : %c%s\n", a.sign, small_digits(a.mag, buf));
+		apc_printf("Operation       : %s\n", op);
+		apc_printf("Operand 2       : %c%s\n", b.sign, small_digits(b.mag, buf));
+		apc_printf("----------------------------------------\n");
+	}
+
+	if(message != NULL)
+	{
+		apc_printf("%s", message);
+	}
+	else if(strcmp(op, "cmp") == 0)
+	{
+		// Zero has no sign; otherwise the signs decide before the magnitudes
+		char c1 = a.mag ? a.sign : '+', c2 = b.mag ? b.sign : '+';
+		int order = (c1 != c2) ? ((c1 == '+') ? GREATER : LESS) : (c1 == '+') ? compare : -compare;
+		apc_printf("Result          : %d\n", order);
+	}
+	else
+	{
+		print_small(sign, result, zero_unsigned);
+	}
+	return SUCCESS;
+}
@@ -12,7 +12,11 @@
  *     Output: 144
  *
  *  Logic:
- *     Just multiply the number by itself using your existing multiplication function.
+ *     square() picks a kernel from the registry by operand length:
+ *        sqr_basecase  : column squaring, each cross product a[i]·a[j] (i < j) is formed once
+ *                        and doubled, so about half the digit products of a full multiplication
+ *                        (on a digit array, with the blocked rows of karatsuba.c)
+ *        sqr_karatsuba : Karatsuba recursion with three half-size squares per level
  *******************************************************************************************/
 
 #include <stdio.h>      
@@ -23,28 +27,47 @@ int square(Dlist **head1, Dlist **tail1, Dlist **headR)
 {
     if(*head1 == NULL)
     {
-        printf("ERROR : Input list is Empty! \n");
+        apc_printf("ERROR : Input list is Empty! \n");
         return FAILURE;
     }
 
-    Dlist *head2 = NULL, *tail2 = NULL;     // duplicate number for squaring
-    Dlist *temp = *head1;
+    const kernel_t *kernel = select_kernel("sqr", find_length(*head1));
+    if(kernel->unary(head1, tail1, headR) == FAILURE)
+    {
+        apc_printf("ERROR: Square operation failed.\n");
+        return FAILURE;
+    }
+    return SUCCESS;
+}
 
-    while(temp)                             // copy list1 into list2
+int sqr_basecase(Dlist **head1, Dlist **tail1, Dlist **headR)
+{
+    if(*head1 == NULL)
     {
-        if(insert_at_end(&head2, &tail2, temp->data) == FAILURE)
-        {
-            printf("ERROR: Node creation failed.\n");
-            return FAILURE;
-        }
-        temp = temp->next;
+        apc_printf("ERROR : Input list is Empty! \n");
+        return FAILURE;
     }
 
-    // Perform multiplication: result = list1 × list2
-    if(multiplication(head1, tail1, &head2, &tail2, headR) == FAILURE)
+    int n = find_length(*head1), length = 2 * n;
+    long long *columns = apc_calloc(length + n, sizeof(long long));
+    if(columns == NULL)
     {
-        printf("ERROR: Square operation failed.\n");
+        apc_printf("ERROR: Node creation failed.\n");
         return FAILURE;
     }
-    return SUCCESS;
-}
\ No newline at end of file
+    PROFILE_ALLOC((length + n) * sizeof(long long));
+
+    // Digits as coefficients after the columns; cross products counted once, doubled, plus the diagonal squares
+    long long *digits = columns + length;
+    int i = 0;
+    for(Dlist *t1 = *tail1; t1 != NULL; t1 = t1->prev, i++)
+    {
+        digits[i] = t1->data;
+    }
+    poly_sqr_basecase(digits, n, columns);
+
+    Dlist *tailR = NULL;
+    int status = columns_to_list(columns, length, headR, &tailR);
+    apc_free(columns);
+    return status;
+}
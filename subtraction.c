@@ -29,10 +29,12 @@ int subtraction(Dlist **head1, Dlist **tail1, Dlist **head2, Dlist **tail2, Dlis
     // Validate input lists
 	if(*head1 == NULL || *head2 == NULL)
 	{
-		printf("ERROR : One or Both input Lists are Empty! \n");
+		apc_printf("ERROR : One or Both input Lists are Empty! \n");
 		return FAILURE;
 	}
 	 
+	PROFILE_KERNEL("sub", "basecase", find_length(*head1));
+
     // Compare both numbers to determine which is larger
 	int compare = compare_numbers(*head1 , *head2);
 
@@ -61,7 +63,7 @@ int subtraction(Dlist **head1, Dlist **tail1, Dlist **head2, Dlist **tail2, Dlis
 	Dlist *temp2 = *tail2;
 	Dlist *tailR = NULL;   // Keeps track of the last node of result
 
-	int difference = 0;
+	int difference = 0, borrow = 0;
 	
     // Traverse both lists from tail to head
 	while(temp1 != NULL || temp2 != NULL)
@@ -70,28 +72,17 @@ int subtraction(Dlist **head1, Dlist **tail1, Dlist **head2, Dlist **tail2, Dlis
 		int digit1 = (temp1) ? temp1->data : 0;
 		int digit2 = (temp2) ? temp2->data : 0;
 
-        // If borrowing is needed (digit1 < digit2)
-		if(digit1 < digit2)
-		{
-            // Check if there is a previous node to borrow from
-			if(temp1->prev == NULL)
-			{
-				printf("ERROR: Cannot borrow (no previous digit)\n");
-                return FAILURE;
-			}
-
-            // Borrow logic: add 10 to current digit, and reduce previous by 1
-			digit1 = 10 + digit1;
-			temp1->prev->data = temp1->prev->data - 1;
-		}
-
-        // Perform subtraction for the current position
-		difference = digit1 - digit2;
+        // Borrow logic: the pending borrow is kept here, never written back into list1,
+        // so both operands are left untouched (they may be shared, see share.c)
+		difference = digit1 - digit2 - borrow;
+		borrow = (difference < 0);
+		difference += 10 * borrow;
 
         // Insert result digit at the beginning of result list
 		if(insert_at_begin(headR, &tailR, difference) == FAILURE)
 		{
-			printf("ERROR : Failed to insert the node in the result list. \n");
+			apc_printf("ERROR : Failed to insert the node in the result list. \n");
+			delete_list(headR, &tailR);
 			return FAILURE;
 		}
 
@@ -108,16 +99,52 @@ int subtraction(Dlist **head1, Dlist **tail1, Dlist **head2, Dlist **tail2, Dlis
 
 	}
 
+    // A borrow out of the top digit means list1 < list2
+	if(borrow)
+	{
+		apc_printf("ERROR: Cannot borrow (no previous digit)\n");
+		delete_list(headR, &tailR);
+		return FAILURE;
+	}
+
     // Remove leading zeros from the result (e.g., 000123 → 123)
 	while (*headR && (*headR)->data == 0 && (*headR)->next)
     {
         Dlist *temp = *headR;
         *headR = (*headR)->next;
         (*headR)->prev = NULL;
-        free(temp);
+        node_free(temp);
     }
 
     // Return success after subtraction
 	return SUCCESS;
 }
 
+
+
+/*****************************************************************************************
+ * Function: subtract_in_place
+ * ---------------------------
+ * A = A - B in place, walking both numbers from their units digits; A >= B is required.
+ * No node is allocated or freed: the borrow stops as soon as B is exhausted and no
+ * borrow is pending, and the zeros this leaves at the front of A stay there until A is
+ * compared, printed or converted (see skip_leading_zeros).
+ *****************************************************************************************/
+
+void subtract_in_place(Dlist *tail1, Dlist *tail2)
+{
+	int borrow = 0;
+
+	while(tail1 && (tail2 || borrow))
+	{
+		int difference = tail1->data - borrow - ((tail2) ? tail2->data : 0);
+		borrow = (difference < 0);
+		tail1->data = difference + 10 * borrow;
+
+		tail1 = tail1->prev;
+		if(tail2)
+		{
+			tail2 = tail2->prev;
+		}
+	}
+}
@@ -0,0 +1,203 @@
+/*******************************************************************************************************************************************************************
+ * Function: tune_thresholds  (./a.out --tune)
+ * -------------------------------------------
+ *  Measures the crossover points of the kernel registry on the current host and writes them to the
+ *  thresholds file that perform_operation() loads at startup.
+ *
+ *  For every family (mul, sqr, div, mod, gcd) each kernel is raced against the one before it at doubling
+ *  operand sizes (1, 2, 4, ... TUNE_MAX_DIGITS digits). Every time is the median of TUNE_RUNS measurements,
+ *  and the newer kernel has to be faster by TUNE_MARGIN at TUNE_WINS consecutive sizes: the first of them
+ *  becomes its threshold, so noisy wins at sizes where both kernels still run the same code do not switch
+ *  the kernel on. If it never wins, the kernel is
+ *  disabled with TUNE_NEVER, unless its current threshold lies beyond TUNE_MAX_DIGITS (gcd hgcd): the
+ *  crossover was not measured, so that threshold is kept.
+ *
+ *  A size at which either kernel fails (e.g. an allocation under the memory caps) is skipped: the
+ *  candidate cannot win there, and a run of consecutive wins starts over.
+ *
+ *  The thresholds file is loaded before the first measurement. Its lazy load in select_kernel() would
+ *  otherwise overwrite the candidate thresholds in the middle of the race, and kernels that are not being
+ *  raced keep the values the host already uses.
+ *
+ *  While a recursive kernel is measured at size n its own threshold is set to n, so it performs exactly
+ *  one level of recursion before falling back to the previous kernel; this compares "split once" against
+ *  "do not split" at every size.
+ *
+ *  Parameters:
+ *     path → thresholds file to write (NULL → thresholds_path())
+ *
+ *  Returns:
+ *     SUCCESS (0) if the file was written, FAILURE (-1) otherwise
+*******************************************************************************************************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <time.h>
+#include "apc.h"
+
+#define TUNE_MAX_DIGITS  4096
+#define TUNE_MIN_TIME_NS 10000000.0      // 10 ms per measurement
+#define TUNE_RUNS        5                // measurements per time, the median is kept
+#define TUNE_WINS        2                // consecutive sizes the newer kernel has to win
+#define TUNE_MARGIN      0.95             // a win is at most 95% of the previous kernel's time
+#define TUNE_NEVER       INT_MAX
+
+static double now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+/* Random list of `length` digits without a leading zero */
+static int random_list(Dlist **head, Dlist **tail, int length)
+{
+    for(int i = 0; i < length; i++)
+    {
+        int digit = rand() % 10;
+        if(i == 0 && digit == 0)
+        {
+            digit = 1;
+        }
+        if(insert_at_end(head, tail, digit) == FAILURE)
+        {
+            return FAILURE;
+        }
+    }
+    return SUCCESS;
+}
+
+static int compare_times(const void *a, const void *b)
+{
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+/* Median over TUNE_RUNS measurements of the mean time (ns) of one call of `kernel` on operands whose key size is `size` digits;
+ * -1 if the operands cannot be built or the kernel fails */
+static double time_kernel(const char *family, const kernel_t *kernel, int size)
+{
+    Dlist *head1 = NULL, *tail1 = NULL, *head2 = NULL, *tail2 = NULL;
+    int dividing = (strcmp(family, "div") == 0 || strcmp(family, "mod") == 0);
+
+    // Division families are keyed on the divisor: divide 2n digits by n digits
+    if(random_list(&head1, &tail1, dividing ? 2 * size : size) == FAILURE ||
+       random_list(&head2, &tail2, size) == FAILURE)
+    {
+        delete_list(&head1, &tail1);
+        delete_list(&head2, &tail2);
+        return -1;
+    }
+
+    double times[TUNE_RUNS];
+    int status = SUCCESS;
+    for(int run = 0; run < TUNE_RUNS && status == SUCCESS; run++)
+    {
+        double total = 0;
+        long reps = 0;
+        while(total < TUNE_MIN_TIME_NS && status == SUCCESS)
+        {
+            Dlist *headR = NULL, *tailR = NULL;
+
+            double start = now_ns();
+            if(kernel->unary)
+                status = kernel->unary(&head1, &tail1, &headR);
+            else
+                status = kernel->binary(&head1, &tail1, &head2, &tail2, &headR);
+            total += now_ns() - start;
+            reps++;
+
+            delete_list(&headR, &tailR);
+        }
+        times[run] = total / reps;
+    }
+
+    delete_list(&head1, &tail1);
+    delete_list(&head2, &tail2);
+    // A failed call is not a fast one
+    if(status == FAILURE)
+    {
+        return -1;
+    }
+    qsort(times, TUNE_RUNS, sizeof(times[0]), compare_times);
+    return times[TUNE_RUNS / 2];
+}
+
+int tune_thresholds(const char *path)
+{
+    const char *families[] = { "mul", "sqr", "div", "mod", "gcd" };
+
+    // Load now, so the lazy load in select_kernel() cannot replace the thresholds set below
+    load_thresholds(NULL);
+    srand(1);
+    printf("Tuning kernel thresholds (up to %d digits)...\n", TUNE_MAX_DIGITS);
+
+    for(size_t f = 0; f < sizeof(families) / sizeof(families[0]); f++)
+    {
+        kernel_family *family = find_family(families[f]);
+
+        for(int i = 1; i < family->count; i++)
+        {
+            kernel_t *previous = &family->kernels[i - 1];
+            kernel_t *candidate = &family->kernels[i];
+            int found = TUNE_NEVER, first_win = 0, wins = 0;
+            int untested = (candidate->threshold > TUNE_MAX_DIGITS) ? candidate->threshold : 0;
+
+            for(int size = 1; size <= TUNE_MAX_DIGITS; size *= 2)
+            {
+                candidate->threshold = size;
+                double t_prev = time_kernel(family->name, previous, size);
+                double t_cand = time_kernel(family->name, candidate, size);
+
+                // A size where either kernel fails decides nothing, and breaks a run of wins
+                if(t_prev < 0 || t_cand < 0)
+                {
+                    printf("  %s %s failed at %d digits, size skipped\n", family->name,
+                           (t_cand < 0) ? candidate->name : previous->name, size);
+                    wins = 0;
+                    continue;
+                }
+                printf("  %s %-10s vs %-10s %6d digits : %12.0f ns vs %12.0f ns\n", family->name, previous->name,
+                       candidate->name, size, t_prev, t_cand);
+                if(t_cand > t_prev * TUNE_MARGIN)
+                {
+                    wins = 0;
+                    continue;
+                }
+                if(wins++ == 0)
+                    first_win = size;
+                if(wins == TUNE_WINS)
+                {
+                    found = first_win;
+                    break;
+                }
+            }
+
+            if(found == TUNE_NEVER && untested)
+            {
+                candidate->threshold = untested;
+                printf("%s %s : crossover above %d digits, keeping %d\n", family->name, candidate->name,
+                       TUNE_MAX_DIGITS, untested);
+                continue;
+            }
+            candidate->threshold = found;
+            if(found == TUNE_NEVER)
+                printf("%s %s : never faster than %s, disabled\n", family->name, candidate->name, previous->name);
+            else
+                printf("%s %s : from %d digits\n", family->name, candidate->name, found);
+        }
+    }
+
+    if(path == NULL)
+    {
+        path = thresholds_path();
+    }
+    if(save_thresholds(path) == FAILURE)
+    {
+        return FAILURE;
+    }
+    printf("Thresholds written to %s\n", path);
+    return SUCCESS;
+}